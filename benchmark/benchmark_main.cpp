@@ -0,0 +1,128 @@
+#include <sabre/Utils.h>
+#include <sabre/Scope.h>
+
+#include <mn/Path.h>
+#include <mn/IO.h>
+#include <mn/Defer.h>
+#include <mn/Log.h>
+#include <mn/File.h>
+
+#include <chrono>
+
+// checks a generated library with increasing declaration count and logs the per declaration
+// check time which should stay roughly constant as the library grows
+inline static bool
+bench_check_scaling()
+{
+	mn_defer{mn::memory::tmp()->clear_all();};
+
+	constexpr size_t DECLS_COUNTS[] = {1000, 2000, 4000, 8000};
+
+	double first_time_per_decl = 0;
+	double last_time_per_decl = 0;
+	for (auto decls_count: DECLS_COUNTS)
+	{
+		auto content = mn::strf(mn::str_tmp(), "package main\n");
+		for (size_t i = 0; i < decls_count; ++i)
+		{
+			content = mn::strf(content, "\nconst c{} = {};\n", i, i);
+			content = mn::strf(content, "type S{} struct {{ v: vec2 }}\n", i);
+			content = mn::strf(content, "func f{}(a: S{}): vec2 {{ return a.v * c{}; }}\n", i, i, i);
+		}
+
+		auto filepath = mn::path_absolute(mn::str_tmpf("check_scaling_{}.sabre", decls_count), mn::memory::tmp());
+		auto file = mn::file_open(filepath, mn::IO_MODE::WRITE, mn::OPEN_MODE::CREATE_OVERWRITE);
+		if (file == nullptr)
+		{
+			mn::log_error("failed to create '{}'", filepath);
+			return false;
+		}
+		mn::print_to(file, "{}", content);
+		mn::file_close(file);
+		mn_defer{mn::file_remove(filepath);};
+
+		auto start = std::chrono::high_resolution_clock::now();
+		auto [answer, err] = sabre::check_file(filepath, mn::str_lit("check_scaling.sabre"), mn::str_lit(""), {});
+		auto end = std::chrono::high_resolution_clock::now();
+		mn_defer{mn::str_free(answer);};
+		if (err)
+		{
+			mn::log_error("{}", answer);
+			return false;
+		}
+
+		// each iteration has 3 declarations (const, struct, func)
+		auto time = std::chrono::duration<double, std::milli>(end - start).count();
+		auto time_per_decl = time / (decls_count * 3);
+		mn::log_info("checked {} declarations in {}ms ({}ms per declaration)", decls_count * 3, time, time_per_decl);
+
+		if (first_time_per_decl == 0)
+			first_time_per_decl = time_per_decl;
+		last_time_per_decl = time_per_decl;
+	}
+
+	// the declaration count grows 8x, quadratic behaviour would make the per declaration time grow 8x as well
+	return last_time_per_decl < first_time_per_decl * 4;
+}
+
+// measures scope_find on a deeply nested scope chain where each scope has a few symbols
+// which is the common case for function local scopes
+inline static bool
+bench_scope_find_deep_nesting()
+{
+	mn_defer{mn::memory::tmp()->clear_all();};
+
+	constexpr size_t SCOPES_DEPTH = 64;
+	constexpr size_t SYMBOLS_PER_SCOPE = 4;
+	constexpr size_t LOOKUPS_COUNT = 1000000;
+
+	auto arena = mn::allocator_arena_new();
+	mn_defer{mn::allocator_free(arena);};
+
+	auto intern = mn::str_intern_new();
+	mn_defer{mn::str_intern_free(intern);};
+
+	auto names = mn::buf_with_allocator<const char*>(mn::memory::tmp());
+	sabre::Scope* scope = nullptr;
+	for (size_t i = 0; i < SCOPES_DEPTH; ++i)
+	{
+		scope = sabre::scope_new(arena, scope, "block", nullptr, sabre::Scope::FLAG_NONE);
+		for (size_t j = 0; j < SYMBOLS_PER_SCOPE; ++j)
+		{
+			sabre::Tkn name{};
+			name.kind = sabre::Tkn::KIND_ID;
+			name.str = mn::str_intern(intern, mn::str_tmpf("v{}_{}", i, j).ptr);
+			auto sym = sabre::symbol_var_new(arena, name, nullptr, sabre::Type_Sign{}, nullptr);
+			if (sabre::scope_add(scope, sym) == false)
+				return false;
+			mn::buf_push(names, name.str);
+		}
+	}
+
+	size_t found_count = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < LOOKUPS_COUNT; ++i)
+	{
+		if (sabre::scope_find(scope, names[i % names.count]) != nullptr)
+			++found_count;
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+
+	auto time = std::chrono::duration<double, std::milli>(end - start).count();
+	mn::log_info("{} scope_find calls with depth {} took {}ms", LOOKUPS_COUNT, SCOPES_DEPTH, time);
+	return found_count == LOOKUPS_COUNT;
+}
+
+int
+main()
+{
+	bool ok = true;
+	ok &= bench_check_scaling();
+	ok &= bench_scope_find_deep_nesting();
+	if (ok == false)
+	{
+		mn::log_error("benchmark failed");
+		return 1;
+	}
+	return 0;
+}
\ No newline at end of file
@@ -14,6 +14,7 @@ namespace sabre
 	struct Type_Sign;
 	struct Type;
 	struct Symbol;
+	struct Scope;
 
 	// represents a type signature atom
 	struct Type_Sign_Atom
@@ -267,6 +268,49 @@ namespace sabre
 		return expr_clone(e, e->arena);
 	}
 
+	// returns whether the given expression contains a compound literal
+	SABRE_EXPORT bool
+	expr_has_complit(const Expr* e);
+
+	// returns whether evaluating the given expression may have effects other than producing its value
+	SABRE_EXPORT bool
+	expr_has_side_effects(const Expr* e);
+
+	// returns whether the given expression only reads values and calls pure builtin functions
+	SABRE_EXPORT bool
+	expr_is_pure(const Expr* e);
+
+	// returns the variable which the given assignment target writes into, or nullptr if it's unknown
+	SABRE_EXPORT Symbol*
+	expr_assigned_symbol(const Expr* e);
+
+	struct Tag_Key_Value
+	{
+		Tkn key;
+		Tkn value;
+	};
+
+	// represents a tag that can be attached to declarations and statements
+	struct Tag
+	{
+		Tkn name;
+		mn::Map<const char*, Tag_Key_Value> args;
+	};
+
+	// create a new tag
+	SABRE_EXPORT Tag
+	tag_new(mn::Allocator arena);
+
+	// represents a set of tags attached to a declaration or a statement
+	struct Tag_Table
+	{
+		mn::Map<const char*, Tag> table;
+	};
+
+	// creates a new tag table
+	SABRE_EXPORT Tag_Table
+	tag_table_new(mn::Allocator arena);
+
 	// Stmt
 	struct Stmt
 	{
@@ -287,6 +331,10 @@ namespace sabre
 		KIND kind;
 		mn::Allocator arena;
 		Location loc;
+		// scope of block and for statements, it's created by the typer
+		Scope* scope;
+		// tags of for and if statements, they're used as control flow hints (@unroll, @branch, etc...)
+		Tag_Table tags;
 		union
 		{
 			Tkn break_stmt;
@@ -302,6 +350,9 @@ namespace sabre
 				mn::Buf<Expr*> cond;
 				mn::Buf<Stmt*> body;
 				Stmt* else_body;
+				// set by the if conversion pass when the if statement is a single assignment in each branch
+				// which the backends should emit as a conditional (select) assignment instead of a branch
+				bool is_select;
 			} if_stmt;
 
 			struct
@@ -381,33 +432,6 @@ namespace sabre
 		return stmt_clone(other, other->arena);
 	}
 
-	struct Tag_Key_Value
-	{
-		Tkn key;
-		Tkn value;
-	};
-
-	// represents a tag that can be attached to declarations
-	struct Tag
-	{
-		Tkn name;
-		mn::Map<const char*, Tag_Key_Value> args;
-	};
-
-	// create a new tag
-	SABRE_EXPORT Tag
-	tag_new(mn::Allocator arena);
-
-	// represents a set of tags attached to a declaration
-	struct Tag_Table
-	{
-		mn::Map<const char*, Tag> table;
-	};
-
-	// creates a new tag table
-	SABRE_EXPORT Tag_Table
-	tag_table_new(mn::Allocator arena);
-
 	struct Arg
 	{
 		Tag_Table tags;
@@ -531,6 +555,8 @@ namespace sabre
 		Type* type;
 		mn::Buf<Template_Arg> template_args;
 		Symbol* symbol;
+		// scope of function declarations, it's created by the typer
+		Scope* scope;
 		union
 		{
 			struct
@@ -587,6 +613,10 @@ namespace sabre
 	SABRE_EXPORT Decl*
 	decl_convert_var_to_const(Decl* var);
 
+	// returns whether the given declaration is a builtin function without side effects (normalize, dot, etc...)
+	SABRE_EXPORT bool
+	decl_is_pure_builtin_func(const Decl* func);
+
 	// creates a new function declaration
 	SABRE_EXPORT Decl*
 	decl_func_new(mn::Allocator arena, Tkn name, mn::Buf<Arg> args, Type_Sign ret, Stmt* body, mn::Buf<Template_Arg> template_args);
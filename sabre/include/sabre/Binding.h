@@ -0,0 +1,93 @@
+#pragma once
+
+#include "sabre/Exports.h"
+
+#include <mn/Buf.h>
+
+#include <stddef.h>
+
+namespace sabre
+{
+	struct Unit;
+	struct Entry_Point;
+	struct Symbol;
+
+	// update frequency of resources (@uniform{frequency = "per_draw"}), the resources of each frequency live in
+	// their own descriptor set (GLSL) or register space (HLSL) whose index is the frequency, so the engine can bind
+	// the per frame resources once and only rebind the per draw ones, resources without a frequency are per frame
+	enum BINDING_FREQUENCY
+	{
+		BINDING_FREQUENCY_PER_FRAME,
+		BINDING_FREQUENCY_PER_MATERIAL,
+		BINDING_FREQUENCY_PER_DRAW,
+		BINDING_FREQUENCY_COUNT,
+	};
+
+	// returns the name of the given frequency as it's written in the frequency tag
+	inline static const char*
+	binding_frequency_name(BINDING_FREQUENCY frequency)
+	{
+		switch (frequency)
+		{
+		case BINDING_FREQUENCY_PER_FRAME: return "per_frame";
+		case BINDING_FREQUENCY_PER_MATERIAL: return "per_material";
+		case BINDING_FREQUENCY_PER_DRAW: return "per_draw";
+		default: return "<UNKNOWN FREQUENCY>";
+		}
+	}
+
+	// push constants (@push_constant) aren't part of the binding layout, they're limited to the size which vulkan
+	// guarantees, in HLSL they're bound as root constants at b0 in a register space of their own
+	inline constexpr size_t PUSH_CONSTANT_MAX_SIZE = 128;
+	inline constexpr int PUSH_CONSTANT_SPACE = BINDING_FREQUENCY_COUNT;
+
+	// a single resource in the binding layout of a pipeline
+	struct Binding_Slot
+	{
+		enum KIND
+		{
+			KIND_UNIFORM,
+			KIND_TEXTURE,
+			KIND_SAMPLER,
+			KIND_BUFFER,
+			KIND_RW_BUFFER,
+			KIND_COUNT,
+		};
+
+		KIND kind;
+		Symbol* symbol;
+		BINDING_FREQUENCY frequency;
+		int binding;
+		// one bit (1 << COMPILATION_MODE) for each stage which uses this resource, it's 0 for resources which
+		// aren't reachable from any entry point
+		int stages;
+	};
+
+	// binding layout shared by all the stages of a pipeline, each frequency set is a single vulkan descriptor set
+	// so all the kinds of resources share one range of bindings in it
+	struct Binding_Layout
+	{
+		// sorted by frequency, then by binding
+		mn::Buf<Binding_Slot> slots;
+		// number of bindings used in each frequency set, which is the highest binding + 1
+		int bindings_count[BINDING_FREQUENCY_COUNT];
+	};
+
+	// frees the given binding layout
+	SABRE_EXPORT void
+	binding_layout_free(Binding_Layout& self);
+
+	// destruct overload for binding layout
+	inline static void
+	destruct(Binding_Layout& self)
+	{
+		binding_layout_free(self);
+	}
+
+	// assigns bindings to the uniforms, textures, samplers and buffers used by the given entries, resources shared between
+	// entries get the same binding, explicit bindings (@uniform{binding = N}) are kept as is and the rest are given
+	// the lowest free bindings in their frequency set so the layout stays dense, unreachable resources (like the uniforms of a library)
+	// are given bindings after the reachable ones, binding conflicts are reported to the package of the resource
+	SABRE_EXPORT Binding_Layout
+	binding_layout_solve(Unit* unit, const mn::Buf<Entry_Point*>& entries, const mn::Buf<Symbol*>& unreachable);
+}
\ No newline at end of file
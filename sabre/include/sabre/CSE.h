@@ -0,0 +1,32 @@
+#pragma once
+
+#include "sabre/Exports.h"
+
+#include <stddef.h>
+
+namespace sabre
+{
+	struct Unit_Package;
+	struct Entry_Point;
+
+	// statistics of the reused expressions, it's reported in the metrics
+	struct CSE_Stats
+	{
+		// number of generated temporaries which hold the value of a repeated expression
+		size_t hoisted_exprs;
+		// number of expression occurrences which were replaced by a temporary
+		size_t reused_exprs;
+		// number of texture sample calls which were replaced by a temporary
+		size_t reused_samples;
+	};
+
+	// hoists the repeated pure expressions inside the basic blocks of the functions reachable from the
+	// given entry point into temporaries, this is done on the checked AST before codegen
+	SABRE_EXPORT CSE_Stats
+	cse_entry(Entry_Point* entry);
+
+	// hoists the repeated pure expressions inside the basic blocks of all the reachable functions in
+	// the given package, this is used in library mode where we don't have an entry point
+	SABRE_EXPORT CSE_Stats
+	cse_package(Unit_Package* package);
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "sabre/Exports.h"
 
 #include <mn/Buf.h>
+#include <mn/Map.h>
 
 namespace sabre
 {
@@ -11,6 +12,64 @@ namespace sabre
 	struct Type;
 	struct Entry_Point;
 	struct Decl;
+	struct Symbol;
+
+	// key of a type signature in the resolution cache, it's the structure of the signature where each name
+	// is replaced by the symbol (or builtin type) it resolves to, so the same signature used from different
+	// scopes shares the cache entry unless one of its names is shadowed
+	struct Type_Sign_Cache_Key
+	{
+		mn::Buf<size_t> words;
+
+		bool
+		operator==(const Type_Sign_Cache_Key& other) const
+		{
+			if (words.count != other.words.count)
+				return false;
+
+			for (size_t i = 0; i < words.count; ++i)
+				if (words[i] != other.words[i])
+					return false;
+
+			return true;
+		}
+
+		bool
+		operator!=(const Type_Sign_Cache_Key& other) const
+		{
+			return !operator==(other);
+		}
+	};
+
+	inline static void
+	destruct(Type_Sign_Cache_Key& self)
+	{
+		mn::buf_free(self.words);
+	}
+
+	// used to hash a type signature cache key
+	struct Type_Sign_Cache_Key_Hasher
+	{
+		inline size_t
+		operator()(const Type_Sign_Cache_Key& key) const
+		{
+			return mn::murmur_hash(block_from(key.words));
+		}
+	};
+
+	// result of a type signature resolution alongside the symbols it depends on, so that we can
+	// add them to the dependencies of the symbol which uses the cached result
+	struct Type_Sign_Cache_Entry
+	{
+		Type* type;
+		mn::Buf<Symbol*> dependencies;
+	};
+
+	inline static void
+	destruct(Type_Sign_Cache_Entry& self)
+	{
+		mn::buf_free(self.dependencies);
+	}
 
 	// type checker state
 	struct Typer
@@ -20,9 +79,9 @@ namespace sabre
 		mn::Buf<Scope*> scope_stack;
 		mn::Buf<Decl*> func_stack;
 		mn::Buf<Type*> expected_expr_type;
-		int uniform_binding_generator;
-		int texture_binding_generator;
-		int sampler_binding_generator;
+		// caches the resolved array and template type signatures, single names are cheap to resolve
+		// so they're not cached
+		mn::Map<Type_Sign_Cache_Key, Type_Sign_Cache_Entry, Type_Sign_Cache_Key_Hasher> type_sign_cache;
 	};
 
 	// creates a new type checker
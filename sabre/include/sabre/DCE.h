@@ -0,0 +1,32 @@
+#pragma once
+
+#include "sabre/Exports.h"
+
+#include <stddef.h>
+
+namespace sabre
+{
+	struct Unit_Package;
+	struct Entry_Point;
+
+	// statistics of the removed code, it's reported in the metrics
+	struct DCE_Stats
+	{
+		// unreachable statements, statements without side effects, and stores into unused variables
+		size_t removed_stmts;
+		// local variables and constants which are never read
+		size_t removed_vars;
+		// if branches which will never be taken because of their constant conditions
+		size_t removed_branches;
+	};
+
+	// removes the dead code from the bodies of the functions reachable from the given entry point
+	// this is done on the checked AST before codegen
+	SABRE_EXPORT DCE_Stats
+	dce_entry(Entry_Point* entry);
+
+	// removes the dead code from the bodies of all the reachable functions in the given package
+	// this is used in library mode where we don't have an entry point
+	SABRE_EXPORT DCE_Stats
+	dce_package(Unit_Package* package);
+}
\ No newline at end of file
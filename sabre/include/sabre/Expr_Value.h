@@ -49,6 +49,14 @@ namespace sabre
 	SABRE_EXPORT Expr_Value
 	expr_value_aggregate_get(Expr_Value self, size_t index);
 
+	// returns the numerical value as an integer, double values are truncated
+	SABRE_EXPORT int64_t
+	expr_value_as_int(Expr_Value self);
+
+	// returns the numerical value as a double
+	SABRE_EXPORT double
+	expr_value_as_double(Expr_Value self);
+
 	// performs a logical or between two booleans, returns none value if one of them is not a bool
 	SABRE_EXPORT Expr_Value
 	expr_value_logic_or(Expr_Value a, Expr_Value b);
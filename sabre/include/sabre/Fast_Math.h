@@ -0,0 +1,29 @@
+#pragma once
+
+#include "sabre/Exports.h"
+
+#include <stddef.h>
+
+namespace sabre
+{
+	struct Unit_Package;
+	struct Entry_Point;
+
+	// statistics of the rewritten expressions, it's reported in the metrics
+	struct Fast_Math_Stats
+	{
+		// number of expressions which were replaced with cheaper ones
+		size_t rewritten_exprs;
+	};
+
+	// rewrites the expensive math patterns in the functions reachable from the given entry point into cheaper
+	// ones (pow(x, 2.0) into x * x, division by constants into multiplication by their reciprocals, etc...)
+	// the rewritten expressions might not produce the exact same floating point results
+	SABRE_EXPORT Fast_Math_Stats
+	fast_math_entry(Entry_Point* entry);
+
+	// rewrites the expensive math patterns in all the reachable functions in the given package
+	// this is used in library mode where we don't have an entry point
+	SABRE_EXPORT Fast_Math_Stats
+	fast_math_package(Unit_Package* package);
+}
\ No newline at end of file
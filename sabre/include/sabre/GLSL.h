@@ -32,6 +32,8 @@ namespace sabre
 		mn::Buf<mn::Str> input_names;
 		mn::Buf<mn::Str> output_names;
 		size_t tmp_id;
+		// glsl extensions used by the generated code, they're interned and emitted after the version line
+		mn::Buf<const char*> extensions;
 	};
 
 	// creates a new GLSL generator instance
@@ -38,6 +38,10 @@ namespace sabre
 		mn::Map<void*, const char*> symbol_to_names;
 		// set of io structs
 		mn::Map<Symbol*, ENTRY_IO_FLAG> io_structs;
+		// struct passed from the vertex stage to the pixel stage, it's only set when varying packing is enabled
+		// or when some of its fields were removed by linking, the entry point then reads or writes it through
+		// a generated struct which follows its varying layout
+		Type* varyings_type;
 		size_t tmp_id;
 		// geometry shader specific data
 		// holds the name of geometry shader stream variable name
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "sabre/Exports.h"
+
+#include <stddef.h>
+
+namespace sabre
+{
+	struct Unit_Package;
+	struct Entry_Point;
+
+	// statistics of the converted if statements, it's reported in the metrics
+	struct If_Conversion_Stats
+	{
+		// number of if statements which will be emitted as conditional assignments
+		size_t converted_ifs;
+	};
+
+	// marks the small if/else statements which assign a cheap pure value to the same local variable in
+	// each branch in the functions reachable from the given entry point, the backends emit them as
+	// conditional assignments (x = c ? a : b) which don't cause divergence, @branch tagged ifs are left as is
+	SABRE_EXPORT If_Conversion_Stats
+	if_conversion_entry(Entry_Point* entry);
+
+	// marks the small if/else statements in all the reachable functions in the given package
+	// this is used in library mode where we don't have an entry point
+	SABRE_EXPORT If_Conversion_Stats
+	if_conversion_package(Unit_Package* package);
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "sabre/Exports.h"
+
+#include <stddef.h>
+
+namespace sabre
+{
+	struct Unit_Package;
+	struct Entry_Point;
+
+	// statistics of the inlined function calls, it's reported in the metrics
+	struct Inline_Stats
+	{
+		// number of call expressions which were replaced by the body of the called function
+		size_t inlined_calls;
+		// number of functions which are no longer called after inlining so they're not generated
+		size_t removed_funcs;
+	};
+
+	// inlines the calls to small functions (and the functions tagged with @inline) inside the functions
+	// reachable from the given entry point, this is done on the checked AST before codegen
+	SABRE_EXPORT Inline_Stats
+	inline_entry(Entry_Point* entry);
+
+	// inlines the calls to small functions inside all the reachable functions in the given package, the
+	// inlined functions are still generated because they're part of the library
+	SABRE_EXPORT Inline_Stats
+	inline_package(Unit_Package* package);
+}
\ No newline at end of file
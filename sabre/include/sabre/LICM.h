@@ -0,0 +1,30 @@
+#pragma once
+
+#include "sabre/Exports.h"
+
+#include <stddef.h>
+
+namespace sabre
+{
+	struct Unit_Package;
+	struct Entry_Point;
+
+	// statistics of the hoisted loop invariant expressions, it's reported in the metrics
+	struct LICM_Stats
+	{
+		// number of expressions which were moved out of loops into temporaries
+		size_t hoisted_exprs;
+		// number of loops which had at least one expression moved out of them
+		size_t optimized_loops;
+	};
+
+	// moves the loop invariant pure expressions inside the for loops of the functions reachable from the
+	// given entry point into temporaries before the loops, this is done on the checked AST before codegen
+	SABRE_EXPORT LICM_Stats
+	licm_entry(Entry_Point* entry);
+
+	// moves the loop invariant pure expressions inside the for loops of all the reachable functions in the
+	// given package, this is used in library mode where we don't have an entry point
+	SABRE_EXPORT LICM_Stats
+	licm_package(Unit_Package* package);
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "sabre/Exports.h"
+
+#include <stddef.h>
+
+namespace sabre
+{
+	struct Entry_Point;
+
+	// statistics of the pipeline linking, it's reported in the metrics
+	struct Link_Stats
+	{
+		// vertex outputs which the pixel stage never reads, they're removed from the interface of both stages
+		size_t removed_varyings;
+		// stores into the removed vertex outputs
+		size_t removed_stores;
+		// statements and variables which only computed the removed vertex outputs
+		size_t removed_stmts;
+	};
+
+	// checks that the outputs of the given vertex entry match the inputs of the given pixel entry, then removes
+	// the vertex outputs which the pixel entry never reads along with the code which computes them, errors are
+	// reported to the package of the vertex entry, this is done on the checked AST before codegen
+	SABRE_EXPORT Link_Stats
+	link_pipeline(Entry_Point* vertex, Entry_Point* pixel);
+}
\ No newline at end of file
@@ -9,6 +9,7 @@
 namespace sabre
 {
 	struct Type;
+	struct Struct_Field_Type;
 	struct Unit_Package;
 	struct Scope;
 
@@ -66,8 +67,18 @@ namespace sabre
 
 				// used when a variable refers is a uniform
 				int uniform_binding;
+				// descriptor set (GLSL) or register space (HLSL) of the uniform, it's the index of its update frequency
+				int uniform_set;
 				bool is_uniform;
-				bool uniform_binding_processed;
+				// push constants are uniforms which are pushed with the draw call instead of living in a buffer
+				bool is_push_constant;
+				// shared variables live in the workgroup memory of compute shaders (groupshared in HLSL)
+				bool is_shared;
+				// fields of struct uniforms in the order they're laid out in the uniform block, they're reordered
+				// to minimize padding when the uniform is tagged with @uniform{packed}
+				mn::Buf<Struct_Field_Type> uniform_fields;
+				// size of the uniform block in bytes
+				size_t uniform_size;
 			} var_sym;
 
 			struct
@@ -159,6 +170,11 @@ namespace sabre
 	SABRE_EXPORT Symbol*
 	symbol_func_instantiation_new(mn::Allocator arena, Symbol* template_symbol, Type* type, Decl* decl);
 
+	// returns the name of the symbol that's used in the generated code, the name is generated on first use
+	// and cached in the symbol, so runs that only check the code don't pay for name generation
+	SABRE_EXPORT const char*
+	symbol_package_name(Symbol* self);
+
 	// given a symbols it will return its location in compilation unit
 	inline static Location
 	symbol_location(const Symbol* self)
@@ -217,6 +233,10 @@ namespace sabre
 		}
 	}
 
+	// scopes with symbols count up to this limit store their symbols inline and search them linearly, beyond it
+	// we build a symbol table
+	constexpr size_t SCOPE_LINEAR_SEARCH_LIMIT = 8;
+
 	// scope contains symbols inside a scope node in the AST (like a func)
 	struct Scope
 	{
@@ -226,18 +246,24 @@ namespace sabre
 			FLAG_INSIDE_LOOP,
 		};
 
+		mn::Allocator arena;
 		Scope* parent;
 		const char* name;
-		mn::Buf<Symbol*> symbols;
+		// the first SCOPE_LINEAR_SEARCH_LIMIT symbols live inline so small scopes don't allocate, the rest are
+		// in overflow_symbols, use scope_symbol to access them in the order they were added
+		Symbol* inline_symbols[SCOPE_LINEAR_SEARCH_LIMIT];
+		mn::Buf<Symbol*> overflow_symbols;
+		size_t symbols_count;
+		// only built when the symbols count exceeds SCOPE_LINEAR_SEARCH_LIMIT
 		mn::Map<const char*, Symbol*> symbol_table;
 		Type* expected_type;
 		mn::Map<const char*, size_t> generated_names;
 		FLAG flags;
 	};
 
-	// creates a new scope
+	// creates a new scope, the scope and its symbol lists are allocated from the given arena
 	SABRE_EXPORT Scope*
-	scope_new(Scope* parent, const char* name, Type* expected_type, Scope::FLAG flags);
+	scope_new(mn::Allocator arena, Scope* parent, const char* name, Type* expected_type, Scope::FLAG flags);
 
 	// frees the given scope
 	SABRE_EXPORT void
@@ -249,12 +275,31 @@ namespace sabre
 		scope_free(self);
 	}
 
-	// search the given scope only for a symbol with the given name
+	// returns the symbol at the given index in the order they were added to the scope
+	inline static Symbol*
+	scope_symbol(const Scope* self, size_t index)
+	{
+		mn_assert(index < self->symbols_count);
+		if (index < SCOPE_LINEAR_SEARCH_LIMIT)
+			return self->inline_symbols[index];
+		return self->overflow_symbols[index - SCOPE_LINEAR_SEARCH_LIMIT];
+	}
+
+	// search the given scope only for a symbol with the given name, names are interned
+	// so small scopes are searched by comparing pointers
 	inline static Symbol*
 	scope_shallow_find(const Scope* self, const char* name)
 	{
-		if (auto it = mn::map_lookup(self->symbol_table, name))
-			return it->value;
+		if (self->symbols_count > SCOPE_LINEAR_SEARCH_LIMIT)
+		{
+			if (auto it = mn::map_lookup(self->symbol_table, name))
+				return it->value;
+			return nullptr;
+		}
+
+		for (size_t i = 0; i < self->symbols_count; ++i)
+			if (self->inline_symbols[i]->name == name)
+				return self->inline_symbols[i];
 		return nullptr;
 	}
 
@@ -264,8 +309,21 @@ namespace sabre
 		if (scope_shallow_find(self, symbol->name) != nullptr)
 			return false;
 
+		if (self->symbols_count < SCOPE_LINEAR_SEARCH_LIMIT)
+		{
+			self->inline_symbols[self->symbols_count++] = symbol;
+			return true;
+		}
+
+		if (self->symbols_count == SCOPE_LINEAR_SEARCH_LIMIT)
+		{
+			// the scope outgrew linear search, build the symbol table
+			for (auto sym: self->inline_symbols)
+				mn::map_insert(self->symbol_table, sym->name, sym);
+		}
+		mn::buf_push(self->overflow_symbols, symbol);
 		mn::map_insert(self->symbol_table, symbol->name, symbol);
-		mn::buf_push(self->symbols, symbol);
+		++self->symbols_count;
 		return true;
 	}
 
@@ -283,10 +341,7 @@ namespace sabre
 	inline static bool
 	scope_is_top_level(Scope* self, Symbol* symbol)
 	{
-		for (auto sym: self->symbols)
-			if (sym == symbol)
-				return true;
-		return false;
+		return scope_shallow_find(self, symbol->name) == symbol;
 	}
 
 	inline static bool
@@ -203,6 +203,7 @@ namespace sabre
 			KIND_UINT,
 			KIND_FLOAT,
 			KIND_DOUBLE,
+			KIND_HALF,
 			KIND_VEC,
 			KIND_MAT,
 			KIND_FUNC,
@@ -217,6 +218,8 @@ namespace sabre
 			KIND_TRIANGLE_STREAM,
 			KIND_LINE_STREAM,
 			KIND_POINT_STREAM,
+			KIND_BUFFER,
+			KIND_RW_BUFFER,
 		};
 
 		KIND kind;
@@ -249,7 +252,7 @@ namespace sabre
 
 			struct
 			{
-				// matrices are of type float
+				// matrices are of type float or half
 				Type* base;
 				int width;
 			} mat;
@@ -335,6 +338,7 @@ namespace sabre
 	SABRE_EXPORT extern Type* type_float;
 	SABRE_EXPORT extern Type* type_lit_float;
 	SABRE_EXPORT extern Type* type_double;
+	SABRE_EXPORT extern Type* type_half;
 	SABRE_EXPORT extern Type* type_vec2;
 	SABRE_EXPORT extern Type* type_vec3;
 	SABRE_EXPORT extern Type* type_vec4;
@@ -350,9 +354,15 @@ namespace sabre
 	SABRE_EXPORT extern Type* type_dvec2;
 	SABRE_EXPORT extern Type* type_dvec3;
 	SABRE_EXPORT extern Type* type_dvec4;
+	SABRE_EXPORT extern Type* type_hvec2;
+	SABRE_EXPORT extern Type* type_hvec3;
+	SABRE_EXPORT extern Type* type_hvec4;
 	SABRE_EXPORT extern Type* type_mat2;
 	SABRE_EXPORT extern Type* type_mat3;
 	SABRE_EXPORT extern Type* type_mat4;
+	SABRE_EXPORT extern Type* type_hmat2;
+	SABRE_EXPORT extern Type* type_hmat3;
+	SABRE_EXPORT extern Type* type_hmat4;
 	SABRE_EXPORT extern Type* type_texture1d;
 	SABRE_EXPORT extern Type* type_texture2d;
 	SABRE_EXPORT extern Type* type_texture3d;
@@ -361,6 +371,8 @@ namespace sabre
 	SABRE_EXPORT extern Type* type_triangle_stream;
 	SABRE_EXPORT extern Type* type_line_stream;
 	SABRE_EXPORT extern Type* type_point_stream;
+	SABRE_EXPORT extern Type* type_buffer;
+	SABRE_EXPORT extern Type* type_rw_buffer;
 
 	// given a type name it will return a type
 	inline static Type*
@@ -380,6 +392,8 @@ namespace sabre
 			return type_float;
 		else if (str == "double")
 			return type_double;
+		else if (str == "half")
+			return type_half;
 		else if (str == "vec2")
 			return type_vec2;
 		else if (str == "vec3")
@@ -410,12 +424,24 @@ namespace sabre
 			return type_dvec3;
 		else if (str == "dvec4")
 			return type_dvec4;
+		else if (str == "hvec2")
+			return type_hvec2;
+		else if (str == "hvec3")
+			return type_hvec3;
+		else if (str == "hvec4")
+			return type_hvec4;
 		else if (str == "mat2")
 			return type_mat2;
 		else if (str == "mat3")
 			return type_mat3;
 		else if (str == "mat4")
 			return type_mat4;
+		else if (str == "hmat2")
+			return type_hmat2;
+		else if (str == "hmat3")
+			return type_hmat3;
+		else if (str == "hmat4")
+			return type_hmat4;
 		else if (str == "Texture1D")
 			return type_texture1d;
 		else if (str == "Texture2D")
@@ -432,6 +458,10 @@ namespace sabre
 			return type_line_stream;
 		else if (str == "PointStream")
 			return type_point_stream;
+		else if (str == "Buffer")
+			return type_buffer;
+		else if (str == "RWBuffer")
+			return type_rw_buffer;
 		else
 			return type_void;
 	}
@@ -456,6 +486,14 @@ namespace sabre
 		{
 			return true;
 		}
+		else if ((a == type_half && b == type_lit_float) || (a == type_lit_float && b == type_half))
+		{
+			return true;
+		}
+		else if ((a == type_half && b == type_lit_int) || (a == type_lit_int && b == type_half))
+		{
+			return true;
+		}
 		else
 		{
 			return a == b;
@@ -470,7 +508,8 @@ namespace sabre
 			type_is_equal(a, type_int) ||
 			type_is_equal(a, type_uint) ||
 			type_is_equal(a, type_float) ||
-			type_is_equal(a, type_double)
+			type_is_equal(a, type_double) ||
+			type_is_equal(a, type_half)
 		);
 	}
 
@@ -483,6 +522,7 @@ namespace sabre
 			type_is_equal(a, type_uint) ||
 			type_is_equal(a, type_float) ||
 			type_is_equal(a, type_double) ||
+			type_is_equal(a, type_half) ||
 			(a->kind == Type::KIND_VEC && type_can_negate(a->vec.base)) ||
 			(a->kind == Type::KIND_MAT && type_can_negate(a->mat.base))
 		);
@@ -496,7 +536,8 @@ namespace sabre
 			type_is_equal(a, type_int) ||
 			type_is_equal(a, type_uint) ||
 			type_is_equal(a, type_float) ||
-			type_is_equal(a, type_double)
+			type_is_equal(a, type_double) ||
+			type_is_equal(a, type_half)
 		);
 	}
 
@@ -542,6 +583,24 @@ namespace sabre
 		);
 	}
 
+	// returns whether the type is a storage buffer type (Buffer<T> or RWBuffer<T>)
+	inline static bool
+	type_is_buffer(Type* t)
+	{
+		return (
+			t->kind == Type::KIND_BUFFER ||
+			t->kind == Type::KIND_RW_BUFFER
+		);
+	}
+
+	// returns the element type of the given buffer type
+	inline static Type*
+	type_buffer_element(Type* t)
+	{
+		mn_assert(type_is_buffer(t) && t->full_template_args.count == 1);
+		return t->full_template_args[0];
+	}
+
 	enum SHADER_API
 	{
 		SHADER_API_DEFAULT = 0,
@@ -575,7 +634,11 @@ namespace sabre
 			a == type_uvec4 ||
 			a == type_dvec2 ||
 			a == type_dvec3 ||
-			a == type_dvec4
+			a == type_dvec4 ||
+			a == type_half ||
+			a == type_hvec2 ||
+			a == type_hvec3 ||
+			a == type_hvec4
 		);
 	}
 
@@ -602,7 +665,14 @@ namespace sabre
 			a == type_dvec4 ||
 			a == type_mat2 ||
 			a == type_mat3 ||
-			a == type_mat4
+			a == type_mat4 ||
+			a == type_half ||
+			a == type_hvec2 ||
+			a == type_hvec3 ||
+			a == type_hvec4 ||
+			a == type_hmat2 ||
+			a == type_hmat3 ||
+			a == type_hmat4
 		);
 	}
 
@@ -704,6 +774,7 @@ namespace sabre
 			type_is_equal(a, type_uint) ||
 			type_is_equal(a, type_float) ||
 			type_is_equal(a, type_double) ||
+			type_is_equal(a, type_half) ||
 			(type_is_vec(a) && type_has_arithmetic(a->vec.base)) ||
 			(a->kind == Type::KIND_MAT && type_has_arithmetic(a->mat.base)) ||
 			type_is_enum(a)
@@ -777,6 +848,18 @@ namespace sabre
 				return type_void;
 			}
 		}
+		else if (base == type_half)
+		{
+			switch (width)
+			{
+			case 2: return type_hvec2;
+			case 3: return type_hvec3;
+			case 4: return type_hvec4;
+			default:
+				mn_unreachable();
+				return type_void;
+			}
+		}
 		return type_void;
 	}
 
@@ -791,6 +874,7 @@ namespace sabre
 		case Type::KIND_UINT:
 		case Type::KIND_FLOAT:
 		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
 		case Type::KIND_FUNC:
 		case Type::KIND_TEXTURE:
 		case Type::KIND_PACKAGE:
@@ -833,6 +917,7 @@ namespace sabre
 		case Type::KIND_UINT:
 		case Type::KIND_FLOAT:
 		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
 		case Type::KIND_FUNC:
 		case Type::KIND_TEXTURE:
 		case Type::KIND_PACKAGE:
@@ -872,6 +957,7 @@ namespace sabre
 		case Type::KIND_UINT:
 		case Type::KIND_FLOAT:
 		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
 		case Type::KIND_ENUM:
 			return 1;
 		case Type::KIND_VEC:
@@ -1018,6 +1104,33 @@ namespace sabre
 	// finds the func declaration associated with the template instantiation
 	SABRE_EXPORT Decl*
 	type_interner_find_func_instantiation_decl(Type_Interner* self, Type* base_type, const mn::Buf<Type*>& args);
+
+	// reorders the fields of the given struct type to minimize the padding between them in a uniform block, the
+	// returned fields are listed in memory order along with their new offsets
+	SABRE_EXPORT mn::Buf<Struct_Field_Type>
+	type_interner_packed_uniform_fields(Type_Interner* self, Type* type);
+
+	// alignment of the given type in a storage buffer (std430), unlike uniform blocks (std140) arrays and structs
+	// aren't rounded up to the alignment of a vec4
+	SABRE_EXPORT size_t
+	type_std430_alignment(Type* type);
+
+	// size of the given type in a storage buffer (std430)
+	SABRE_EXPORT size_t
+	type_std430_size(Type* type);
+
+	// distance in bytes between two consecutive elements of the given type in a storage buffer (std430)
+	SABRE_EXPORT size_t
+	type_std430_stride(Type* type);
+
+	// returns whether the std430 layout of the given type has no padding between or after its fields, HLSL
+	// structured buffers pack their elements tightly so only such types have the same layout in both backends
+	SABRE_EXPORT bool
+	type_std430_is_tightly_packed(Type* type);
+
+	// returns the fields of the given struct type along with their offsets in a storage buffer (std430)
+	SABRE_EXPORT mn::Buf<Struct_Field_Type>
+	type_interner_std430_fields(Type_Interner* self, Type* type);
 }
 
 namespace fmt
@@ -1054,6 +1167,10 @@ namespace fmt
 			{
 				return format_to(ctx.out(), "double");
 			}
+			else if (t == sabre::type_half)
+			{
+				return format_to(ctx.out(), "half");
+			}
 			else if (t == sabre::type_vec2)
 			{
 				return format_to(ctx.out(), "vec2");
@@ -1114,6 +1231,18 @@ namespace fmt
 			{
 				return format_to(ctx.out(), "dvec4");
 			}
+			else if (t == sabre::type_hvec2)
+			{
+				return format_to(ctx.out(), "hvec2");
+			}
+			else if (t == sabre::type_hvec3)
+			{
+				return format_to(ctx.out(), "hvec3");
+			}
+			else if (t == sabre::type_hvec4)
+			{
+				return format_to(ctx.out(), "hvec4");
+			}
 			else if (t == sabre::type_mat2)
 			{
 				return format_to(ctx.out(), "mat2");
@@ -1126,6 +1255,18 @@ namespace fmt
 			{
 				return format_to(ctx.out(), "mat4");
 			}
+			else if (t == sabre::type_hmat2)
+			{
+				return format_to(ctx.out(), "hmat2");
+			}
+			else if (t == sabre::type_hmat3)
+			{
+				return format_to(ctx.out(), "hmat3");
+			}
+			else if (t == sabre::type_hmat4)
+			{
+				return format_to(ctx.out(), "hmat4");
+			}
 			else if (t->kind == sabre::Type::KIND_FUNC)
 			{
 				format_to(ctx.out(), "func");
@@ -1256,6 +1397,13 @@ namespace fmt
 				}
 				return ctx.out();
 			}
+			else if (t->kind == sabre::Type::KIND_BUFFER || t->kind == sabre::Type::KIND_RW_BUFFER)
+			{
+				format_to(ctx.out(), t->kind == sabre::Type::KIND_BUFFER ? "Buffer" : "RWBuffer");
+				if (t->full_template_args.count > 0)
+					format_to(ctx.out(), "<{}>", *t->full_template_args[0]);
+				return ctx.out();
+			}
 			else if (t->kind == sabre::Type::KIND_POINT_STREAM)
 			{
 				format_to(ctx.out(), "PointStream");
@@ -4,6 +4,7 @@
 #include "sabre/Tkn.h"
 #include "sabre/Err.h"
 #include "sabre/Scope.h"
+#include "sabre/Binding.h"
 
 #include <mn/Str.h>
 #include <mn/Buf.h>
@@ -51,6 +52,27 @@ namespace sabre
 	inline constexpr const char* KEYWORD_POINT = "point";
 	inline constexpr const char* KEYWORD_LINE = "line";
 	inline constexpr const char* KEYWORD_TRIANGLE = "triangle";
+	inline constexpr const char* KEYWORD_UNROLL = "unroll";
+	inline constexpr const char* KEYWORD_LOOP = "loop";
+	inline constexpr const char* KEYWORD_BRANCH = "branch";
+	inline constexpr const char* KEYWORD_FLATTEN = "flatten";
+	inline constexpr const char* KEYWORD_COUNT = "count";
+	inline constexpr const char* KEYWORD_INLINE = "inline";
+	inline constexpr const char* KEYWORD_NOINLINE = "noinline";
+	inline constexpr const char* KEYWORD_PACKED = "packed";
+	inline constexpr const char* KEYWORD_FREQUENCY = "frequency";
+	inline constexpr const char* KEYWORD_PUSH_CONSTANT = "push_constant";
+	inline constexpr const char* KEYWORD_COMPUTE = "compute";
+	inline constexpr const char* KEYWORD_X = "x";
+	inline constexpr const char* KEYWORD_Y = "y";
+	inline constexpr const char* KEYWORD_Z = "z";
+	inline constexpr const char* KEYWORD_SHARED = "shared";
+	inline constexpr const char* KEYWORD_SV_DISPATCH_THREAD_ID = "system_dispatch_thread_id";
+	inline constexpr const char* KEYWORD_SV_GROUP_ID = "system_group_id";
+	inline constexpr const char* KEYWORD_SV_GROUP_THREAD_ID = "system_group_thread_id";
+	inline constexpr const char* KEYWORD_SV_GROUP_INDEX = "system_group_index";
+	inline constexpr const char* KEYWORD_SUBGROUP = "subgroup";
+	inline constexpr const char* KEYWORD_GLSL_EXTENSION = "glsl_extension";
 
 	enum COMPILATION_STAGE
 	{
@@ -154,9 +176,10 @@ namespace sabre
 		COMPILATION_MODE_VERTEX,
 		COMPILATION_MODE_PIXEL,
 		COMPILATION_MODE_GEOMETRY,
+		COMPILATION_MODE_COMPUTE,
 	};
 
-	// represents an entry point, along with its symbol and mode (vertex, pixel, geometry, etc...)
+	// represents an entry point, along with its symbol and mode (vertex, pixel, geometry, compute, etc...)
 	struct Entry_Point
 	{
 		COMPILATION_MODE mode;
@@ -166,6 +189,17 @@ namespace sabre
 		mn::Buf<Symbol*> uniforms;
 		mn::Buf<Symbol*> textures;
 		mn::Buf<Symbol*> samplers;
+		// storage buffers (Buffer<T> and RWBuffer<T>)
+		mn::Buf<Symbol*> buffers;
+		// the push constant used by this entry if any, an entry can only use one
+		Symbol* push_constant;
+		// names of the fields of the struct passed from the vertex stage to the pixel stage which were removed
+		// when this entry was linked with the other stage of its pipeline
+		mn::Set<const char*> removed_varyings;
+		// set after the optimization passes run on this entry, so they don't run again in codegen
+		bool is_optimized;
+		// number of threads in a workgroup along x, y, and z, it's only used by compute entries
+		int workgroup_size[3];
 	};
 
 	// creates a new entry point instance
@@ -189,6 +223,8 @@ namespace sabre
 			mn::buf_free(self->uniforms);
 			mn::buf_free(self->textures);
 			mn::buf_free(self->samplers);
+			mn::buf_free(self->buffers);
+			mn::set_free(self->removed_varyings);
 			mn::free(self);
 		}
 	}
@@ -204,6 +240,22 @@ namespace sabre
 	SABRE_EXPORT void
 	entry_point_calc_reachable_list(Entry_Point* entry);
 
+	// calls fn once with each function which has a body and is reachable from the given entry point, or from
+	// the given package in library mode where entry is null, templated functions are visited through their
+	// instantiations, it's used by the optimization passes to process the functions which end up in codegen
+	SABRE_EXPORT void
+	unit_reachable_funcs_walk(Entry_Point* entry, Unit_Package* package, void (*fn)(void* user_data, Decl* d), void* user_data);
+
+	// unit_reachable_funcs_walk overload which accepts any callable, lambdas for example
+	template<typename TFunc>
+	inline static void
+	unit_reachable_funcs_walk(Entry_Point* entry, Unit_Package* package, const TFunc& fn)
+	{
+		unit_reachable_funcs_walk(entry, package, [](void* user_data, Decl* d) {
+			(*(const TFunc*)user_data)(d);
+		}, (void*)&fn);
+	}
+
 	// represents a package compilation unit
 	struct Unit_Package
 	{
@@ -238,6 +290,8 @@ namespace sabre
 		// all the symbols are allocated from this arena, so we don't need to manage
 		// memory for the symbols on a symbol by symbol basis
 		mn::memory::Arena* symbols_arena;
+		// all the scopes of the package (global, file, and AST node scopes) are allocated from this arena
+		mn::memory::Arena* scopes_arena;
 		// global scope of the unit
 		Scope* global_scope;
 		// list of all the imported packages
@@ -317,6 +371,33 @@ namespace sabre
 		return unit_package_entry_find(self, mn::str_lit(name));
 	}
 
+	// options which control the code generated by the backends
+	struct Unit_Options
+	{
+		// emits the folded literal of constant scalar and vector expressions instead of the expression itself
+		bool fold_constants;
+		// replaces calls to small functions (or functions tagged with @inline) with their bodies
+		bool inline_functions;
+		// fully unrolls for loops with a small constant trip count, replacing the induction variable with its value
+		bool unroll_loops;
+		// rewrites expensive math patterns into cheaper ones which might not produce the exact same floating point results
+		bool fast_math;
+		// removes dead statements, unused local variables, and constant false branches before codegen
+		bool eliminate_dead_code;
+		// moves pure expressions which don't change between the iterations of for loops before the loops
+		bool hoist_loop_invariants;
+		// computes repeated pure builtin calls (including texture samples) once per basic block and reuses the result
+		bool eliminate_common_subexpressions;
+		// emits small if/else statements which assign cheap values to a single local variable as conditional assignments
+		bool convert_branches_to_selects;
+		// packs the float fields passed from the vertex stage to the pixel stage into shared vec4 interpolator slots,
+		// it's an error to use it with geometry shaders
+		bool pack_varyings;
+		// the target supports subgroup (wave) operations, GL_KHR_shader_subgroup in glsl and shader model 6.0 in hlsl,
+		// calling builtins tagged with @subgroup is an error without it
+		bool enable_subgroups;
+	};
+
 	struct Unit
 	{
 		// used to intern strings, usually token strings
@@ -325,8 +406,6 @@ namespace sabre
 		// because it works just like string interning where pointer == pointer if
 		// the content is the same
 		Type_Interner* type_interner;
-		// maps from and AST node to a scope
-		mn::Map<void*, Scope*> scope_table;
 		// list of imported packages in this compilation unit
 		mn::Buf<Unit_Package*> packages;
 		// root package is the first package added to the compilation unit, this is the main package provided by user
@@ -336,12 +415,9 @@ namespace sabre
 		// map from package path to unit package
 		mn::Map<mn::Str, Unit_Package*> absolute_path_to_package;
 		// reflection information
-		// reachable uniforms info
-		mn::Map<int, Symbol*> reachable_uniforms;
-		// reachable textures info
-		mn::Map<int, Symbol*> reachable_textures;
-		// reachable samplers info
-		mn::Map<int, Symbol*> reachable_samplers;
+		// binding layout of the resources, it covers the whole file after checking and is narrowed down to the
+		// linked entries when a pipeline is linked
+		Binding_Layout binding_layout;
 		// reflected symbols, they should be const because we write their values in json reflection info
 		mn::Buf<Symbol*> reflected_symbols;
 		// library collections, map from collection name to its path
@@ -351,6 +427,8 @@ namespace sabre
 		mn::Buf<Symbol*> symbol_stack;
 		// list of all the uniforms found in a program
 		mn::Buf<Symbol*> all_uniforms;
+		// code generation options
+		Unit_Options options;
 	};
 
 	SABRE_EXPORT Unit*
@@ -421,6 +499,12 @@ namespace sabre
 	SABRE_EXPORT bool
 	unit_reflect(Unit* self, Entry_Point* entry);
 
+	// links the given vertex and pixel entries into a pipeline, it checks that the vertex outputs match the
+	// pixel inputs and removes the vertex outputs which the pixel entry never reads (along with the code which
+	// computes them), code is then generated for each entry with unit_glsl/unit_hlsl as usual
+	SABRE_EXPORT bool
+	unit_link_pipeline(Unit* self, Entry_Point* vertex, Entry_Point* pixel);
+
 	// generates reflection information for the given unit and writes them as json
 	SABRE_EXPORT mn::Str
 	unit_reflection_info_as_json(Unit* self, Entry_Point* entry, mn::Allocator allocator = mn::allocator_top());
@@ -476,24 +560,22 @@ namespace sabre
 		return unit_intern(self->parent_package->parent_unit, str);
 	}
 
-	// searchs for the scope associated with the given ptr, and creates a new one if it doesn't exist
-	SABRE_EXPORT Scope*
-	unit_create_scope_for(Unit* self, void* ptr, Scope* parent, const char* name, Type* expected_type, Scope::FLAG flags);
-
-	// searchs for the scope associated with the given ptr, and creates a new one if it doesn't exist
+	// returns the scope of the given declaration, and creates a new one in the package scopes arena if it doesn't exist
 	inline static Scope*
-	unit_create_scope_for(Unit_Package* self, void* ptr, Scope* parent, const char* name, Type* expected_type, Scope::FLAG flags)
+	unit_create_scope_for(Unit_Package* self, Decl* decl, Scope* parent, const char* name, Type* expected_type, Scope::FLAG flags)
 	{
-		return unit_create_scope_for(self->parent_unit, ptr, parent, name, expected_type, flags);
+		if (decl->scope == nullptr)
+			decl->scope = scope_new(self->scopes_arena, parent, name, expected_type, flags);
+		return decl->scope;
 	}
 
-	// searchs and returns the associated scope of the given key/ptr, if it doesn't exist it will return nullptr
+	// returns the scope of the given statement, and creates a new one in the package scopes arena if it doesn't exist
 	inline static Scope*
-	unit_scope_find(Unit* self, void* ptr)
+	unit_create_scope_for(Unit_Package* self, Stmt* stmt, Scope* parent, const char* name, Type* expected_type, Scope::FLAG flags)
 	{
-		if (auto it = mn::map_lookup(self->scope_table, ptr))
-			return it->value;
-		return nullptr;
+		if (stmt->scope == nullptr)
+			stmt->scope = scope_new(self->scopes_arena, parent, name, expected_type, flags);
+		return stmt->scope;
 	}
 
 	// returns whether this unit has errors or not
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "sabre/Exports.h"
+
+#include <stddef.h>
+
+namespace sabre
+{
+	struct Unit_Package;
+	struct Entry_Point;
+
+	// statistics of the unrolled loops, it's reported in the metrics
+	struct Unroll_Stats
+	{
+		// number of for loops which were fully unrolled
+		size_t unrolled_loops;
+		// number of copies of the loop bodies which were generated
+		size_t unrolled_iterations;
+	};
+
+	// fully unrolls the for loops with a constant trip count in the functions reachable from the given
+	// entry point, the induction variable is replaced with its constant value in each copy of the body
+	SABRE_EXPORT Unroll_Stats
+	unroll_entry(Entry_Point* entry);
+
+	// fully unrolls the for loops with a constant trip count in all the reachable functions in the given
+	// package, this is used in library mode where we don't have an entry point
+	SABRE_EXPORT Unroll_Stats
+	unroll_package(Unit_Package* package);
+}
\ No newline at end of file
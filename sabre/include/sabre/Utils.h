@@ -1,6 +1,7 @@
 #pragma once
 
 #include "sabre/Exports.h"
+#include "sabre/Unit.h"
 
 #include <mn/Result.h>
 
@@ -34,12 +35,24 @@ namespace sabre
 	// loads, parses, checks, and generates GLSL code for a file, fake_path is used for testing
 	// when you want to make the path uniform across testing environment
 	SABRE_EXPORT mn::Result<mn::Str, mn::Err>
-	glsl_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& entry, const mn::Map<mn::Str, mn::Str>& library_collections);
+	glsl_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& entry, const mn::Map<mn::Str, mn::Str>& library_collections, const Unit_Options& options = {});
 
 	// loads, parses, checks, and generates HLSL code for a file, fake_path is used for testing
 	// when you want to make the path uniform across testing environment
 	SABRE_EXPORT mn::Result<mn::Str, mn::Err>
-	hlsl_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& entry, const mn::Map<mn::Str, mn::Str>& library_collections);
+	hlsl_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& entry, const mn::Map<mn::Str, mn::Str>& library_collections, const Unit_Options& options = {});
+
+	// loads, parses, checks, links the given vertex and pixel entries into a pipeline, and generates GLSL code for
+	// both of them (the vertex code comes first), fake_path is used for testing
+	// when you want to make the path uniform across testing environment
+	SABRE_EXPORT mn::Result<mn::Str, mn::Err>
+	glsl_pipeline_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& vertex_entry, const mn::Str& pixel_entry, const mn::Map<mn::Str, mn::Str>& library_collections, const Unit_Options& options = {});
+
+	// loads, parses, checks, links the given vertex and pixel entries into a pipeline, and generates HLSL code for
+	// both of them (the vertex code comes first), fake_path is used for testing
+	// when you want to make the path uniform across testing environment
+	SABRE_EXPORT mn::Result<mn::Str, mn::Err>
+	hlsl_pipeline_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& vertex_entry, const mn::Str& pixel_entry, const mn::Map<mn::Str, mn::Str>& library_collections, const Unit_Options& options = {});
 
 	// loads, parses, checks, and generates SPIRV for a file, fake_path is used for testing
 	// when you want to make the path uniform across testing environment
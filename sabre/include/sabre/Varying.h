@@ -0,0 +1,66 @@
+#pragma once
+
+#include "sabre/Exports.h"
+
+#include <mn/Buf.h>
+#include <mn/Map.h>
+
+#include <stddef.h>
+
+namespace sabre
+{
+	struct Type;
+
+	// describes where a field of the struct passed from the vertex stage to the pixel stage lives
+	struct Varying_Field
+	{
+		enum KIND
+		{
+			// system values (like @system_position) which don't take a location
+			KIND_BUILTIN,
+			// float scalars and vectors which share vec4 slots with other fields
+			KIND_PACKED,
+			// other types (and all the fields when packing is disabled) which take their own location
+			KIND_UNPACKED,
+			// fields which the pixel stage never reads, they're removed when the vertex and pixel stages are linked
+			KIND_REMOVED,
+		};
+
+		KIND kind;
+		size_t location;
+		// first component which the field occupies in its slot and the number of components it occupies
+		size_t component;
+		size_t width;
+	};
+
+	// interpolator slot map of a varying struct, the map only depends on the struct type and the removed fields
+	// so the vertex stage which writes the struct and the pixel stage which reads it get the same map
+	struct Varying_Layout
+	{
+		// one entry for each field in the struct type fields order
+		mn::Buf<Varying_Field> fields;
+		// number of vec4 slots used by the packed fields, they take the first locations
+		size_t slots_count;
+	};
+
+	// assigns the fields of the given struct type into vec4 slots if pack is true, larger fields are placed first
+	// and each field goes into the first slot which has enough free components, removed fields (by name) don't
+	// take any location
+	SABRE_EXPORT Varying_Layout
+	varying_layout_new(Type* type, bool pack, const mn::Set<const char*>& removed_fields);
+
+	// frees the given varying layout
+	SABRE_EXPORT void
+	varying_layout_free(Varying_Layout& self);
+
+	// destruct overload for varying layout
+	inline static void
+	destruct(Varying_Layout& self)
+	{
+		varying_layout_free(self);
+	}
+
+	// returns the swizzle which selects the given packed field from its slot (like "xyz" or "w")
+	SABRE_EXPORT const char*
+	varying_field_swizzle(const Varying_Field& field);
+}
\ No newline at end of file
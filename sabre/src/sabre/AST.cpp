@@ -1,7 +1,11 @@
 #include "sabre/AST.h"
+#include "sabre/Type_Interner.h"
+#include "sabre/Unit.h"
 
 #include <mn/Assert.h>
 
+#include <string.h>
+
 namespace sabre
 {
 	template<typename T>
@@ -258,6 +262,139 @@ namespace sabre
 		return self;
 	}
 
+	bool
+	expr_has_complit(const Expr* e)
+	{
+		if (e == nullptr)
+			return false;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return false;
+		case Expr::KIND_BINARY:
+			return expr_has_complit(e->binary.left) || expr_has_complit(e->binary.right);
+		case Expr::KIND_UNARY:
+			return expr_has_complit(e->unary.base);
+		case Expr::KIND_CALL:
+			for (auto arg: e->call.args)
+				if (expr_has_complit(arg))
+					return true;
+			return expr_has_complit(e->call.base);
+		case Expr::KIND_CAST:
+			return expr_has_complit(e->cast.base);
+		case Expr::KIND_DOT:
+			return expr_has_complit(e->dot.lhs) || expr_has_complit(e->dot.rhs);
+		case Expr::KIND_INDEXED:
+			return expr_has_complit(e->indexed.base) || expr_has_complit(e->indexed.index);
+		case Expr::KIND_COMPLIT:
+			return true;
+		default:
+			mn_unreachable();
+			return false;
+		}
+	}
+
+	bool
+	expr_has_side_effects(const Expr* e)
+	{
+		if (e == nullptr)
+			return false;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return false;
+		case Expr::KIND_BINARY:
+			return expr_has_side_effects(e->binary.left) || expr_has_side_effects(e->binary.right);
+		case Expr::KIND_UNARY:
+			if (e->unary.op.kind == Tkn::KIND_INC || e->unary.op.kind == Tkn::KIND_DEC)
+				return true;
+			return expr_has_side_effects(e->unary.base);
+		case Expr::KIND_CALL:
+			// we don't look into user functions, and builtin functions which don't return
+			// a value are only called for their side effects (emit, etc...)
+			if (e->call.func && e->call.func->kind == Decl::KIND_FUNC && e->call.func->func_decl.body != nullptr)
+				return true;
+			if (type_is_equal(e->type, type_void))
+				return true;
+			for (auto arg: e->call.args)
+				if (expr_has_side_effects(arg))
+					return true;
+			return false;
+		case Expr::KIND_CAST:
+			return expr_has_side_effects(e->cast.base);
+		case Expr::KIND_DOT:
+			return expr_has_side_effects(e->dot.lhs);
+		case Expr::KIND_INDEXED:
+			return expr_has_side_effects(e->indexed.base) || expr_has_side_effects(e->indexed.index);
+		case Expr::KIND_COMPLIT:
+			for (const auto& field: e->complit.fields)
+				if (expr_has_side_effects(field.value))
+					return true;
+			return false;
+		default:
+			mn_unreachable();
+			return true;
+		}
+	}
+
+	bool
+	expr_is_pure(const Expr* e)
+	{
+		if (e == nullptr)
+			return true;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return true;
+		case Expr::KIND_BINARY:
+			return expr_is_pure(e->binary.left) && expr_is_pure(e->binary.right);
+		case Expr::KIND_UNARY:
+			if (e->unary.op.kind == Tkn::KIND_INC || e->unary.op.kind == Tkn::KIND_DEC)
+				return false;
+			return expr_is_pure(e->unary.base);
+		case Expr::KIND_CALL:
+			if (decl_is_pure_builtin_func(e->call.func) == false)
+				return false;
+			for (auto arg: e->call.args)
+				if (expr_is_pure(arg) == false)
+					return false;
+			return true;
+		case Expr::KIND_CAST:
+			return expr_is_pure(e->cast.base);
+		case Expr::KIND_DOT:
+			return expr_is_pure(e->dot.lhs);
+		case Expr::KIND_INDEXED:
+			return expr_is_pure(e->indexed.base) && expr_is_pure(e->indexed.index);
+		case Expr::KIND_COMPLIT:
+			// compound literals are hoisted by the backends on their own
+			return false;
+		default:
+			mn_unreachable();
+			return false;
+		}
+	}
+
+	Symbol*
+	expr_assigned_symbol(const Expr* e)
+	{
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return e->symbol;
+		case Expr::KIND_DOT:
+			if (e->dot.lhs == nullptr)
+				return nullptr;
+			return expr_assigned_symbol(e->dot.lhs);
+		case Expr::KIND_INDEXED:
+			return expr_assigned_symbol(e->indexed.base);
+		default:
+			return nullptr;
+		}
+	}
+
 	Stmt*
 	stmt_break_new(mn::Allocator arena, Tkn tkn)
 	{
@@ -314,6 +451,7 @@ namespace sabre
 		auto self = mn::alloc_zerod_from<Stmt>(arena);
 		self->kind = Stmt::KIND_IF;
 		self->arena = arena;
+		self->tags = tag_table_new(arena);
 		self->if_stmt.cond = cond;
 		self->if_stmt.body = body;
 		self->if_stmt.else_body = else_body;
@@ -326,6 +464,7 @@ namespace sabre
 		auto self = mn::alloc_zerod_from<Stmt>(arena);
 		self->kind = Stmt::KIND_FOR;
 		self->arena = arena;
+		self->tags = tag_table_new(arena);
 		self->for_stmt.init = init;
 		self->for_stmt.cond = cond;
 		self->for_stmt.post = post;
@@ -375,6 +514,7 @@ namespace sabre
 		self->kind = other->kind;
 		self->arena = arena;
 		self->loc = other->loc;
+		self->tags = other->tags;
 		switch (other->kind)
 		{
 		case Stmt::KIND_BREAK:
@@ -393,6 +533,7 @@ namespace sabre
 			self->if_stmt.cond = _ast_helper_clone(other->if_stmt.cond, arena);
 			self->if_stmt.body = _ast_helper_clone(other->if_stmt.body, arena);
 			self->if_stmt.else_body = clone(other->if_stmt.else_body);
+			self->if_stmt.is_select = other->if_stmt.is_select;
 			break;
 		case Stmt::KIND_FOR:
 			self->for_stmt.init = clone(other->for_stmt.init);
@@ -505,6 +646,32 @@ namespace sabre
 		return self;
 	}
 
+	bool
+	decl_is_pure_builtin_func(const Decl* func)
+	{
+		// builtin std functions which don't have side effects, calling them with the same arguments
+		// always produces the same value
+		constexpr const char* PURE_BUILTIN_FUNCS[] = {
+			"texture_sample",
+			"normalize", "dot", "cross", "length",
+			"abs", "sign", "min", "max", "lerp", "smoothstep", "fract",
+			"sin", "cos", "tan", "asin", "acos", "atan",
+			"exp", "exp2", "log", "pow", "sqrt", "inversesqrt",
+			"ddx", "ddy", "all", "any",
+		};
+
+		if (func == nullptr || func->kind != Decl::KIND_FUNC)
+			return false;
+
+		if (mn::map_lookup(func->tags.table, KEYWORD_BUILTIN) == nullptr)
+			return false;
+
+		for (auto name: PURE_BUILTIN_FUNCS)
+			if (::strcmp(func->name.str, name) == 0)
+				return true;
+		return false;
+	}
+
 	Decl*
 	decl_convert_var_to_const(Decl* var)
 	{
@@ -72,7 +72,10 @@ namespace sabre
 					for (auto [_, kv]: tag.args)
 					{
 						_ast_printer_newline(self);
-						mn::print_to(self.out, "(key: '{}', value: '{}')", kv.key.str, kv.value.str);
+						if (kv.value)
+							mn::print_to(self.out, "(key: '{}', value: '{}')", kv.key.str, kv.value.str);
+						else
+							mn::print_to(self.out, "(key: '{}')", kv.key.str);
 					}
 				}
 				_ast_printer_leave_scope(self);
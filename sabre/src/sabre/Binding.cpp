@@ -0,0 +1,191 @@
+#include "sabre/Binding.h"
+#include "sabre/Unit.h"
+#include "sabre/AST.h"
+#include "sabre/Scope.h"
+#include "sabre/Type_Interner.h"
+
+#include <mn/Map.h>
+#include <mn/Memory.h>
+#include <mn/Assert.h>
+
+#include <algorithm>
+
+#include <stdlib.h>
+
+namespace sabre
+{
+	struct Binding_Solver
+	{
+		Unit* unit;
+		Binding_Layout layout;
+		// index of each resource in the layout slots
+		mn::Map<Symbol*, size_t> slot_index;
+		// bindings which are already taken in each frequency set
+		mn::Map<int, Symbol*> taken[BINDING_FREQUENCY_COUNT];
+	};
+
+	inline static Binding_Solver
+	_binding_solver_new(Unit* unit)
+	{
+		Binding_Solver self{};
+		self.unit = unit;
+		self.slot_index = mn::map_with_allocator<Symbol*, size_t>(mn::memory::tmp());
+		for (size_t i = 0; i < BINDING_FREQUENCY_COUNT; ++i)
+			self.taken[i] = mn::map_with_allocator<int, Symbol*>(mn::memory::tmp());
+		return self;
+	}
+
+	inline static Binding_Slot::KIND
+	_binding_kind(Symbol* sym)
+	{
+		if (sym->type->kind == Type::KIND_TEXTURE)
+			return Binding_Slot::KIND_TEXTURE;
+		else if (type_is_sampler(sym->type))
+			return Binding_Slot::KIND_SAMPLER;
+		else if (sym->type->kind == Type::KIND_BUFFER)
+			return Binding_Slot::KIND_BUFFER;
+		else if (sym->type->kind == Type::KIND_RW_BUFFER)
+			return Binding_Slot::KIND_RW_BUFFER;
+		else
+			return Binding_Slot::KIND_UNIFORM;
+	}
+
+	inline static const char*
+	_binding_kind_name(Binding_Slot::KIND kind)
+	{
+		switch (kind)
+		{
+		case Binding_Slot::KIND_UNIFORM: return "uniform";
+		case Binding_Slot::KIND_TEXTURE: return "texture";
+		case Binding_Slot::KIND_SAMPLER: return "sampler";
+		case Binding_Slot::KIND_BUFFER: return "buffer";
+		case Binding_Slot::KIND_RW_BUFFER: return "rw_buffer";
+		default:
+			mn_unreachable();
+			return "";
+		}
+	}
+
+	inline static void
+	_binding_solver_add(Binding_Solver& self, Symbol* sym, int stages)
+	{
+		mn_assert(sym->kind == Symbol::KIND_VAR && sym->var_sym.is_uniform);
+		if (auto it = mn::map_lookup(self.slot_index, sym))
+		{
+			self.layout.slots[it->value].stages |= stages;
+			return;
+		}
+
+		Binding_Slot slot{};
+		slot.kind = _binding_kind(sym);
+		slot.symbol = sym;
+		slot.frequency = BINDING_FREQUENCY(sym->var_sym.uniform_set);
+		slot.binding = -1;
+		slot.stages = stages;
+		mn::map_insert(self.slot_index, sym, self.layout.slots.count);
+		mn::buf_push(self.layout.slots, slot);
+	}
+
+	inline static bool
+	_binding_explicit(Symbol* sym, int& binding)
+	{
+		auto decl = symbol_decl(sym);
+		auto uniform_tag_it = mn::map_lookup(decl->tags.table, KEYWORD_UNIFORM);
+		if (uniform_tag_it == nullptr)
+			return false;
+
+		auto binding_it = mn::map_lookup(uniform_tag_it->value.args, KEYWORD_BINDING);
+		if (binding_it == nullptr || binding_it->value.value.kind != Tkn::KIND_LITERAL_INTEGER)
+			return false;
+
+		binding = ::atoi(binding_it->value.value.str);
+		return true;
+	}
+
+	inline static void
+	_binding_solver_take(Binding_Solver& self, Binding_Slot& slot)
+	{
+		auto& taken = self.taken[slot.frequency];
+		if (auto it = mn::map_lookup(taken, slot.binding))
+		{
+			auto old_loc = symbol_location(it->value);
+
+			Err err{};
+			err.loc = symbol_location(slot.symbol);
+			err.msg = mn::strf(
+				"{} binding point {} is shared with other {} defined in {}:{}",
+				_binding_kind_name(slot.kind),
+				slot.binding,
+				_binding_kind_name(_binding_kind(it->value)),
+				old_loc.file->filepath,
+				old_loc.pos.line
+			);
+			unit_err(slot.symbol->package, err);
+			return;
+		}
+
+		mn::map_insert(taken, slot.binding, slot.symbol);
+		auto& bindings_count = self.layout.bindings_count[slot.frequency];
+		if (slot.binding + 1 > bindings_count)
+			bindings_count = slot.binding + 1;
+	}
+
+	// API
+	void
+	binding_layout_free(Binding_Layout& self)
+	{
+		mn::buf_free(self.slots);
+	}
+
+	Binding_Layout
+	binding_layout_solve(Unit* unit, const mn::Buf<Entry_Point*>& entries, const mn::Buf<Symbol*>& unreachable)
+	{
+		auto self = _binding_solver_new(unit);
+
+		// gather the resources in the order they're used so that the layout is stable across runs
+		for (auto entry: entries)
+		{
+			int stage = 1 << entry->mode;
+			for (auto sym: entry->uniforms)
+				_binding_solver_add(self, sym, stage);
+			for (auto sym: entry->textures)
+				_binding_solver_add(self, sym, stage);
+			for (auto sym: entry->samplers)
+				_binding_solver_add(self, sym, stage);
+			for (auto sym: entry->buffers)
+				_binding_solver_add(self, sym, stage);
+		}
+
+		for (auto sym: unreachable)
+			_binding_solver_add(self, sym, 0);
+
+		// explicit bindings are reserved first, then the rest fill the holes between them
+		for (auto& slot: self.layout.slots)
+			if (_binding_explicit(slot.symbol, slot.binding))
+				_binding_solver_take(self, slot);
+
+		int next_binding[BINDING_FREQUENCY_COUNT] = {};
+		for (auto& slot: self.layout.slots)
+		{
+			if (slot.binding != -1)
+				continue;
+
+			auto& next = next_binding[slot.frequency];
+			while (mn::map_lookup(self.taken[slot.frequency], next))
+				++next;
+			slot.binding = next++;
+			_binding_solver_take(self, slot);
+		}
+
+		for (const auto& slot: self.layout.slots)
+			slot.symbol->var_sym.uniform_binding = slot.binding;
+
+		std::sort(self.layout.slots.ptr, self.layout.slots.ptr + self.layout.slots.count, [](const Binding_Slot& a, const Binding_Slot& b) {
+			if (a.frequency != b.frequency)
+				return a.frequency < b.frequency;
+			return a.binding < b.binding;
+		});
+
+		return self.layout;
+	}
+}
\ No newline at end of file
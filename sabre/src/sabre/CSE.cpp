@@ -0,0 +1,494 @@
+#include "sabre/CSE.h"
+#include "sabre/Unit.h"
+#include "sabre/AST.h"
+#include "sabre/Scope.h"
+#include "sabre/Type_Interner.h"
+
+#include <mn/Buf.h>
+#include <mn/Map.h>
+#include <mn/Memory.h>
+#include <mn/Defer.h>
+#include <mn/Assert.h>
+
+#include <string.h>
+
+namespace sabre
+{
+	// a pure expression inside a basic block which might be repeated
+	struct CSE_Entry
+	{
+		// the first occurrence of the expression and the index of the statement which contains it
+		Expr* first;
+		size_t stmt_index;
+		// the later occurrences of the expression which will reuse the value of the first one
+		mn::Buf<Expr*> dups;
+		// the symbols which the expression reads, writing into any of them kills the entry
+		mn::Buf<Symbol*> reads;
+		bool available;
+	};
+
+	struct CSE
+	{
+		CSE_Stats stats;
+		mn::Buf<Scope*> scope_stack;
+		size_t tmp_id;
+	};
+
+	inline static CSE
+	_cse_new()
+	{
+		CSE self{};
+		self.scope_stack = mn::buf_with_allocator<Scope*>(mn::memory::tmp());
+		return self;
+	}
+
+	inline static void
+	_cse_enter_scope(CSE& self, Scope* scope)
+	{
+		if (scope)
+			mn::buf_push(self.scope_stack, scope);
+	}
+
+	inline static void
+	_cse_leave_scope(CSE& self, Scope* scope)
+	{
+		if (scope)
+			mn::buf_pop(self.scope_stack);
+	}
+
+	inline static Scope*
+	_cse_current_scope(CSE& self)
+	{
+		return mn::buf_top(self.scope_stack);
+	}
+
+	// we only reuse calls to pure builtin functions, cheap arithmetic is left to the driver compiler
+	inline static bool
+	_cse_expr_is_candidate(const Expr* e)
+	{
+		return e->kind == Expr::KIND_CALL && expr_is_pure(e);
+	}
+
+	inline static bool
+	_cse_expr_equal(const Expr* a, const Expr* b)
+	{
+		if (a == nullptr || b == nullptr)
+			return a == b;
+
+		if (a->kind != b->kind || type_is_equal(a->type, b->type) == false)
+			return false;
+
+		switch (a->kind)
+		{
+		case Expr::KIND_ATOM:
+			if (a->symbol != nullptr || b->symbol != nullptr)
+				return a->symbol == b->symbol;
+			return a->atom.tkn.kind == b->atom.tkn.kind && ::strcmp(a->atom.tkn.str, b->atom.tkn.str) == 0;
+		case Expr::KIND_BINARY:
+			return (
+				a->binary.op.kind == b->binary.op.kind &&
+				_cse_expr_equal(a->binary.left, b->binary.left) &&
+				_cse_expr_equal(a->binary.right, b->binary.right)
+			);
+		case Expr::KIND_UNARY:
+			return a->unary.op.kind == b->unary.op.kind && _cse_expr_equal(a->unary.base, b->unary.base);
+		case Expr::KIND_CALL:
+			if (a->call.func != b->call.func || a->call.args.count != b->call.args.count)
+				return false;
+			for (size_t i = 0; i < a->call.args.count; ++i)
+				if (_cse_expr_equal(a->call.args[i], b->call.args[i]) == false)
+					return false;
+			return true;
+		case Expr::KIND_CAST:
+			return _cse_expr_equal(a->cast.base, b->cast.base);
+		case Expr::KIND_DOT:
+			return _cse_expr_equal(a->dot.lhs, b->dot.lhs) && _cse_expr_equal(a->dot.rhs, b->dot.rhs);
+		case Expr::KIND_INDEXED:
+			return _cse_expr_equal(a->indexed.base, b->indexed.base) && _cse_expr_equal(a->indexed.index, b->indexed.index);
+		case Expr::KIND_COMPLIT:
+			return false;
+		default:
+			mn_unreachable();
+			return false;
+		}
+	}
+
+	inline static void
+	_cse_collect_reads(const Expr* e, mn::Buf<Symbol*>& reads)
+	{
+		if (e == nullptr)
+			return;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			if (e->symbol)
+				mn::buf_push(reads, e->symbol);
+			break;
+		case Expr::KIND_BINARY:
+			_cse_collect_reads(e->binary.left, reads);
+			_cse_collect_reads(e->binary.right, reads);
+			break;
+		case Expr::KIND_UNARY:
+			_cse_collect_reads(e->unary.base, reads);
+			break;
+		case Expr::KIND_CALL:
+			for (auto arg: e->call.args)
+				_cse_collect_reads(arg, reads);
+			break;
+		case Expr::KIND_CAST:
+			_cse_collect_reads(e->cast.base, reads);
+			break;
+		case Expr::KIND_DOT:
+			_cse_collect_reads(e->dot.lhs, reads);
+			break;
+		case Expr::KIND_INDEXED:
+			_cse_collect_reads(e->indexed.base, reads);
+			_cse_collect_reads(e->indexed.index, reads);
+			break;
+		case Expr::KIND_COMPLIT:
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static CSE_Entry*
+	_cse_find(mn::Buf<CSE_Entry*>& entries, const Expr* e)
+	{
+		for (auto entry: entries)
+			if (entry->available && _cse_expr_equal(entry->first, e))
+				return entry;
+		return nullptr;
+	}
+
+	// called when a variable is written, it kills all the entries which read it
+	inline static void
+	_cse_kill(mn::Buf<CSE_Entry*>& entries, Symbol* sym)
+	{
+		for (auto entry: entries)
+		{
+			if (entry->available == false)
+				continue;
+
+			// writing into an unknown variable kills everything
+			if (sym == nullptr)
+			{
+				entry->available = false;
+				continue;
+			}
+
+			for (auto read: entry->reads)
+			{
+				if (read == sym)
+				{
+					entry->available = false;
+					break;
+				}
+			}
+		}
+	}
+
+	// called at the end of a basic block
+	inline static void
+	_cse_kill_all(mn::Buf<CSE_Entry*>& entries)
+	{
+		for (auto entry: entries)
+			entry->available = false;
+	}
+
+	inline static void
+	_cse_visit_expr(mn::Buf<CSE_Entry*>& entries, Expr* e, size_t stmt_index)
+	{
+		if (e == nullptr)
+			return;
+
+		bool is_candidate = _cse_expr_is_candidate(e);
+		if (is_candidate)
+		{
+			if (auto entry = _cse_find(entries, e))
+			{
+				mn::buf_push(entry->dups, e);
+				return;
+			}
+		}
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			break;
+		case Expr::KIND_BINARY:
+			_cse_visit_expr(entries, e->binary.left, stmt_index);
+			// the right hand side of logical operators is conditionally evaluated so we don't hoist from it
+			if (e->binary.op.kind != Tkn::KIND_LOGICAL_AND && e->binary.op.kind != Tkn::KIND_LOGICAL_OR)
+				_cse_visit_expr(entries, e->binary.right, stmt_index);
+			break;
+		case Expr::KIND_UNARY:
+			_cse_visit_expr(entries, e->unary.base, stmt_index);
+			break;
+		case Expr::KIND_CALL:
+			for (auto arg: e->call.args)
+				_cse_visit_expr(entries, arg, stmt_index);
+			break;
+		case Expr::KIND_CAST:
+			_cse_visit_expr(entries, e->cast.base, stmt_index);
+			break;
+		case Expr::KIND_DOT:
+			_cse_visit_expr(entries, e->dot.lhs, stmt_index);
+			break;
+		case Expr::KIND_INDEXED:
+			_cse_visit_expr(entries, e->indexed.base, stmt_index);
+			_cse_visit_expr(entries, e->indexed.index, stmt_index);
+			break;
+		case Expr::KIND_COMPLIT:
+			for (const auto& field: e->complit.fields)
+				_cse_visit_expr(entries, field.value, stmt_index);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+
+		// inner expressions are registered first so the temporaries are generated in dependency order
+		if (is_candidate)
+		{
+			auto entry = mn::alloc_zerod_from<CSE_Entry>(mn::memory::tmp());
+			entry->first = e;
+			entry->stmt_index = stmt_index;
+			entry->dups = mn::buf_with_allocator<Expr*>(mn::memory::tmp());
+			entry->reads = mn::buf_with_allocator<Symbol*>(mn::memory::tmp());
+			entry->available = true;
+			_cse_collect_reads(e, entry->reads);
+			mn::buf_push(entries, entry);
+		}
+	}
+
+	inline static const char*
+	_cse_tmp_name(CSE& self, Unit_Package* package, Scope* scope)
+	{
+		while (true)
+		{
+			auto name = unit_intern(package->parent_unit, mn::str_tmpf("_cse_{}", ++self.tmp_id).ptr);
+			if (scope_find(scope, name) == nullptr)
+				return name;
+		}
+	}
+
+	inline static void
+	_cse_replace_with_tmp(Expr* e, Decl* decl, Symbol* sym)
+	{
+		e->kind = Expr::KIND_ATOM;
+		e->mode = ADDRESS_MODE_VARIABLE;
+		e->const_value = Expr_Value{};
+		e->symbol = sym;
+		e->atom.tkn = decl->name;
+		e->atom.decl = decl;
+	}
+
+	// generates a temporary variable which holds the value of the entry and makes all of its occurrences use it
+	inline static Stmt*
+	_cse_hoist_entry(CSE& self, CSE_Entry* entry)
+	{
+		auto e = entry->first;
+		auto arena = e->arena;
+		auto package = e->loc.file->parent_package;
+		auto scope = _cse_current_scope(self);
+
+		Tkn name{};
+		name.kind = Tkn::KIND_ID;
+		name.str = _cse_tmp_name(self, package, scope);
+		name.loc = e->loc;
+
+		auto value = mn::alloc_zerod_from<Expr>(arena);
+		*value = *e;
+
+		auto names = mn::buf_with_allocator<Tkn>(arena);
+		mn::buf_push(names, name);
+		auto values = mn::buf_with_allocator<Expr*>(arena);
+		mn::buf_push(values, value);
+
+		auto decl = decl_var_new(arena, names, values, type_sign_new(arena));
+		decl->loc = e->loc;
+		decl->name = name;
+		decl->tags = tag_table_new(arena);
+		decl->type = e->type;
+
+		auto sym = symbol_var_new(package->symbols_arena, name, decl, decl->var_decl.type, value);
+		sym->type = e->type;
+		sym->state = STATE_RESOLVED;
+		scope_add(scope, sym);
+		sym->package = package;
+		sym->scope = scope;
+
+		bool is_sample = mn::map_lookup(e->call.func->tags.table, KEYWORD_SAMPLE_FUNC) != nullptr;
+
+		_cse_replace_with_tmp(e, decl, sym);
+		for (auto dup: entry->dups)
+			_cse_replace_with_tmp(dup, decl, sym);
+
+		++self.stats.hoisted_exprs;
+		self.stats.reused_exprs += entry->dups.count;
+		if (is_sample)
+			self.stats.reused_samples += entry->dups.count;
+
+		auto stmt = stmt_decl_new(arena, decl);
+		stmt->loc = e->loc;
+		return stmt;
+	}
+
+	inline static void
+	_cse_block(CSE& self, Stmt* s);
+
+	inline static void
+	_cse_stmt(CSE& self, mn::Buf<CSE_Entry*>& entries, Stmt* s, size_t stmt_index)
+	{
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+			break;
+		case Stmt::KIND_RETURN:
+			if (expr_has_side_effects(s->return_stmt) == false)
+				_cse_visit_expr(entries, s->return_stmt, stmt_index);
+			break;
+		case Stmt::KIND_IF:
+			// the first condition is evaluated right after the statements before it, everything else
+			// is in another basic block
+			if (expr_has_side_effects(s->if_stmt.cond[0]) == false)
+				_cse_visit_expr(entries, s->if_stmt.cond[0], stmt_index);
+			_cse_kill_all(entries);
+
+			for (auto body: s->if_stmt.body)
+				_cse_block(self, body);
+			if (s->if_stmt.else_body)
+				_cse_block(self, s->if_stmt.else_body);
+			break;
+		case Stmt::KIND_FOR:
+			_cse_kill_all(entries);
+
+			_cse_enter_scope(self, s->scope);
+			_cse_block(self, s->for_stmt.body);
+			_cse_leave_scope(self, s->scope);
+			break;
+		case Stmt::KIND_ASSIGN:
+		{
+			auto& lhs = s->assign_stmt.lhs;
+			auto& rhs = s->assign_stmt.rhs;
+			// multiple assignments are performed in sequence, so we don't hoist from them because
+			// the later values might depend on the earlier assignments
+			if (lhs.count == 1 && expr_has_side_effects(lhs[0]) == false && expr_has_side_effects(rhs[0]) == false)
+			{
+				_cse_visit_expr(entries, rhs[0], stmt_index);
+				_cse_kill(entries, expr_assigned_symbol(lhs[0]));
+			}
+			else
+			{
+				_cse_kill_all(entries);
+			}
+			break;
+		}
+		case Stmt::KIND_EXPR:
+			if (expr_has_side_effects(s->expr_stmt))
+				_cse_kill_all(entries);
+			break;
+		case Stmt::KIND_BLOCK:
+			_cse_kill_all(entries);
+			_cse_block(self, s);
+			break;
+		case Stmt::KIND_DECL:
+		{
+			auto d = s->decl_stmt;
+			if (d->kind != Decl::KIND_VAR)
+				break;
+
+			if (d->var_decl.names.count == 1 && d->var_decl.values.count == 1 && expr_has_side_effects(d->var_decl.values[0]) == false)
+			{
+				_cse_visit_expr(entries, d->var_decl.values[0], stmt_index);
+			}
+			else
+			{
+				for (auto value: d->var_decl.values)
+				{
+					if (expr_has_side_effects(value))
+					{
+						_cse_kill_all(entries);
+						break;
+					}
+				}
+			}
+			break;
+		}
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static void
+	_cse_block(CSE& self, Stmt* s)
+	{
+		_cse_enter_scope(self, s->scope);
+		mn_defer{_cse_leave_scope(self, s->scope);};
+
+		auto entries = mn::buf_with_allocator<CSE_Entry*>(mn::memory::tmp());
+		for (size_t i = 0; i < s->block_stmt.count; ++i)
+			_cse_stmt(self, entries, s->block_stmt[i], i);
+
+		bool has_repeated_exprs = false;
+		for (auto entry: entries)
+		{
+			if (entry->dups.count > 0)
+			{
+				has_repeated_exprs = true;
+				break;
+			}
+		}
+
+		if (has_repeated_exprs == false)
+			return;
+
+		// entries are sorted by their statement index, so we insert the temporaries
+		// before the statements which contain their first occurrence
+		auto stmts = mn::buf_with_allocator<Stmt*>(s->block_stmt.allocator);
+		mn::buf_reserve(stmts, s->block_stmt.count + entries.count);
+		size_t entry_index = 0;
+		for (size_t i = 0; i < s->block_stmt.count; ++i)
+		{
+			for (; entry_index < entries.count && entries[entry_index]->stmt_index == i; ++entry_index)
+			{
+				auto entry = entries[entry_index];
+				if (entry->dups.count > 0)
+					mn::buf_push(stmts, _cse_hoist_entry(self, entry));
+			}
+			mn::buf_push(stmts, s->block_stmt[i]);
+		}
+		s->block_stmt = stmts;
+	}
+
+	inline static void
+	_cse_func(CSE& self, Decl* d)
+	{
+		_cse_enter_scope(self, d->scope);
+		_cse_block(self, d->func_decl.body);
+		_cse_leave_scope(self, d->scope);
+	}
+
+	// API
+	CSE_Stats
+	cse_entry(Entry_Point* entry)
+	{
+		auto self = _cse_new();
+		unit_reachable_funcs_walk(entry, nullptr, [&](Decl* d) { _cse_func(self, d); });
+		return self.stats;
+	}
+
+	CSE_Stats
+	cse_package(Unit_Package* package)
+	{
+		auto self = _cse_new();
+		unit_reachable_funcs_walk(nullptr, package, [&](Decl* d) { _cse_func(self, d); });
+		return self.stats;
+	}
+}
\ No newline at end of file
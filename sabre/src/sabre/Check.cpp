@@ -138,6 +138,28 @@ namespace sabre
 		return sym;
 	}
 
+	inline static void
+	_typer_type_sign_cache_clear(Typer& self)
+	{
+		for (auto& [key, entry]: self.type_sign_cache)
+		{
+			destruct(key);
+			destruct(entry);
+		}
+		mn::map_clear(self.type_sign_cache);
+	}
+
+	// adds a symbol to the package global scope or one of its file scopes, top level symbols
+	// are marked here once so that we don't have to search the scopes for them later
+	inline static Symbol*
+	_typer_add_top_level_symbol(Typer& self, Symbol* sym)
+	{
+		auto res = _typer_add_symbol(self, sym);
+		if (res == sym)
+			sym->is_top_level = true;
+		return res;
+	}
+
 	inline static Symbol*
 	_typer_find_symbol(const Typer& self, const char* name)
 	{
@@ -192,7 +214,7 @@ namespace sabre
 			{
 				return true;
 			}
-			else if (lhs == type_double)
+			else if (lhs == type_double || lhs == type_half)
 			{
 				return true;
 			}
@@ -256,7 +278,7 @@ namespace sabre
 			{
 				return true;
 			}
-			else if (lhs == type_double)
+			else if (lhs == type_double || lhs == type_half)
 			{
 				return true;
 			}
@@ -362,7 +384,7 @@ namespace sabre
 					value = decl->const_decl.values[i];
 				// add symbol twice, once in file scope an another one in package scope
 				auto sym = symbol_const_new(self.unit->symbols_arena, name, decl, sign, value);
-				_typer_add_symbol(self, sym);
+				_typer_add_top_level_symbol(self, sym);
 				// search for the pipeline of that shader
 				if (mn::map_lookup(decl->tags.table, KEYWORD_REFLECT))
 					mn::buf_push(self.unit->parent_unit->reflected_symbols, sym);
@@ -380,16 +402,17 @@ namespace sabre
 
 				// add symbol twice, once in file scope an another one in package scope
 				auto sym = symbol_var_new(self.unit->symbols_arena, name, decl, sign, value);
-				_typer_add_symbol(self, sym);
+				_typer_add_top_level_symbol(self, sym);
 			}
 			break;
 		case Decl::KIND_FUNC:
-			_typer_add_func_symbol(self, decl);
+			if (auto sym = _typer_add_func_symbol(self, decl))
+				sym->is_top_level = true;
 			break;
 		case Decl::KIND_STRUCT:
 		{
 			auto sym = symbol_struct_new(self.unit->symbols_arena, decl->name, decl);
-			_typer_add_symbol(self, sym);
+			_typer_add_top_level_symbol(self, sym);
 			break;
 		}
 		case Decl::KIND_IMPORT:
@@ -411,7 +434,7 @@ namespace sabre
 				// to include the same library with the same name in different files of
 				// the same folder package
 				_typer_enter_scope(self, file->file_scope);
-				auto added_sym = _typer_add_symbol(self, sym);
+				auto added_sym = _typer_add_top_level_symbol(self, sym);
 				_typer_leave_scope(self);
 
 				if (added_sym != sym)
@@ -432,12 +455,12 @@ namespace sabre
 				{
 					if (old_sym->kind != Symbol::KIND_PACKAGE || old_sym->package_sym.package != sym->package_sym.package)
 					{
-						_typer_add_symbol(self, sym);
+						_typer_add_top_level_symbol(self, sym);
 					}
 				}
 				else
 				{
-					_typer_add_symbol(self, sym);
+					_typer_add_top_level_symbol(self, sym);
 				}
 			}
 			break;
@@ -445,7 +468,7 @@ namespace sabre
 		case Decl::KIND_ENUM:
 		{
 			auto sym = symbol_enum_new(self.unit->symbols_arena, decl->name, decl);
-			_typer_add_symbol(self, sym);
+			_typer_add_top_level_symbol(self, sym);
 			break;
 		}
 		default:
@@ -492,6 +515,7 @@ namespace sabre
 		case Type::KIND_UINT:
 		case Type::KIND_FLOAT:
 		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
 		case Type::KIND_FUNC:
 		case Type::KIND_STRUCT:
 		case Type::KIND_TEXTURE:
@@ -504,7 +528,7 @@ namespace sabre
 	}
 
 	inline static Type*
-	_typer_resolve_named_type_atom(Typer& self, const Type_Sign_Atom& atom)
+	_typer_resolve_named_type_atom(Typer& self, const Type_Sign_Atom& atom, mn::Buf<Symbol*>* dependencies)
 	{
 		Type* res = nullptr;
 
@@ -540,6 +564,8 @@ namespace sabre
 
 			// make sure the package is resolved before usage
 			_typer_resolve_symbol(self, package_sym);
+			if (dependencies)
+				mn::buf_push(*dependencies, package_sym);
 
 			auto package = package_sym->package_sym.package;
 			auto type_symbol = scope_shallow_find(package->global_scope, atom.named.type_name.str);
@@ -553,6 +579,8 @@ namespace sabre
 			}
 
 			_typer_resolve_symbol(self, type_symbol);
+			if (dependencies)
+				mn::buf_push(*dependencies, type_symbol);
 			res = type_symbol->type;
 		}
 		else
@@ -564,6 +592,8 @@ namespace sabre
 				if (auto symbol = _typer_find_symbol(self, atom.named.type_name.str))
 				{
 					_typer_resolve_symbol(self, symbol);
+					if (dependencies)
+						mn::buf_push(*dependencies, symbol);
 					res = symbol->type;
 				}
 				else
@@ -582,7 +612,7 @@ namespace sabre
 	_typer_resolve_type_sign(Typer& self, const Type_Sign& sign);
 
 	inline static Type*
-	_typer_template_instantiate(Typer& self, Type* base_type, const mn::Buf<Type*>& args, Location instantiation_loc, Decl* base_decl)
+	_typer_template_instantiate(Typer& self, Type* base_type, const mn::Buf<Type*>& args, Location instantiation_loc, Decl* base_decl, mn::Buf<Symbol*>* dependencies = nullptr)
 	{
 		if (base_type->template_args.count == 0)
 		{
@@ -627,6 +657,8 @@ namespace sabre
 			{
 				auto instantiation_sym = symbol_struct_instantiation_new(self.unit->symbols_arena, t->struct_type.symbol, t);
 				_typer_add_dependency(self, instantiation_sym);
+				if (dependencies)
+					mn::buf_push(*dependencies, instantiation_sym);
 				if (instantiation_sym->is_top_level)
 					mn::buf_push(self.unit->reachable_symbols, instantiation_sym);
 			}
@@ -636,7 +668,7 @@ namespace sabre
 	}
 
 	inline static Type*
-	_typer_resolve_type_sign(Typer& self, const Type_Sign& sign)
+	_typer_resolve_type_sign_internal(Typer& self, const Type_Sign& sign, mn::Buf<Symbol*>* dependencies)
 	{
 		auto res = type_void;
 		for (size_t i = 0; i < sign.atoms.count; ++i)
@@ -646,7 +678,7 @@ namespace sabre
 			{
 			case Type_Sign_Atom::KIND_NAMED:
 			{
-				if (auto named_type = _typer_resolve_named_type_atom(self, atom))
+				if (auto named_type = _typer_resolve_named_type_atom(self, atom, dependencies))
 					res = named_type;
 				break;
 			}
@@ -693,17 +725,17 @@ namespace sabre
 			}
 			case Type_Sign_Atom::KIND_TEMPLATED:
 			{
-				if (auto named_type = _typer_resolve_named_type_atom(self, atom))
+				if (auto named_type = _typer_resolve_named_type_atom(self, atom, dependencies))
 				{
 					// we should do something with template arguments
 					auto args_types = mn::buf_with_allocator<Type*>(mn::memory::tmp());
 					mn::buf_reserve(args_types, atom.templated.args.count);
 					for (const auto& arg_type_sign: atom.templated.args)
 					{
-						auto type = _typer_resolve_type_sign(self, arg_type_sign);
+						auto type = _typer_resolve_type_sign_internal(self, arg_type_sign, dependencies);
 						mn::buf_push(args_types, type);
 					}
-					res = _typer_template_instantiate(self, named_type, args_types, atom.templated.type_name.loc, nullptr);
+					res = _typer_template_instantiate(self, named_type, args_types, atom.templated.type_name.loc, nullptr, dependencies);
 				}
 				break;
 			}
@@ -715,6 +747,121 @@ namespace sabre
 		return res;
 	}
 
+	// appends the given type name to the cache key as the symbol (or builtin type) it resolves to
+	inline static bool
+	_typer_type_sign_key_name(const Typer& self, Type_Sign_Cache_Key& key, const Tkn& package_name, const Tkn& type_name)
+	{
+		if (package_name)
+		{
+			// imports are file local, but the type name itself is unique inside the imported package
+			auto package_sym = _typer_find_symbol(self, package_name.str);
+			if (package_sym == nullptr)
+				return false;
+			mn::buf_push(key.words, (size_t)package_sym);
+			mn::buf_push(key.words, (size_t)type_name.str);
+		}
+		else if (auto type = type_from_name(type_name); type_is_equal(type, type_void) == false)
+		{
+			mn::buf_push(key.words, (size_t)0);
+			mn::buf_push(key.words, (size_t)type);
+		}
+		else
+		{
+			auto sym = _typer_find_symbol(self, type_name.str);
+			if (sym == nullptr)
+				return false;
+			mn::buf_push(key.words, (size_t)0);
+			mn::buf_push(key.words, (size_t)sym);
+		}
+		return true;
+	}
+
+	// builds the cache key of the given type signature, it returns false if the signature can't be cached,
+	// like arrays with sizes that are not integer literals or undefined names
+	inline static bool
+	_typer_type_sign_key(const Typer& self, Type_Sign_Cache_Key& key, const Type_Sign& sign)
+	{
+		mn::buf_push(key.words, sign.atoms.count);
+		for (const auto& atom: sign.atoms)
+		{
+			mn::buf_push(key.words, (size_t)atom.kind);
+			switch (atom.kind)
+			{
+			case Type_Sign_Atom::KIND_NAMED:
+				if (_typer_type_sign_key_name(self, key, atom.named.package_name, atom.named.type_name) == false)
+					return false;
+				break;
+			case Type_Sign_Atom::KIND_ARRAY:
+			{
+				auto static_size = atom.array.static_size;
+				if (static_size == nullptr)
+					mn::buf_push(key.words, (size_t)0);
+				// integer literals are interned so their text identifies them
+				else if (static_size->kind == Expr::KIND_ATOM && static_size->atom.tkn.kind == Tkn::KIND_LITERAL_INTEGER)
+					mn::buf_push(key.words, (size_t)static_size->atom.tkn.str);
+				else
+					return false;
+				break;
+			}
+			case Type_Sign_Atom::KIND_TEMPLATED:
+				if (_typer_type_sign_key_name(self, key, atom.templated.package_name, atom.templated.type_name) == false)
+					return false;
+				mn::buf_push(key.words, atom.templated.args.count);
+				for (const auto& arg: atom.templated.args)
+					if (_typer_type_sign_key(self, key, arg) == false)
+						return false;
+				break;
+			default:
+				mn_unreachable();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	inline static Type*
+	_typer_resolve_type_sign(Typer& self, const Type_Sign& sign)
+	{
+		if (sign.atoms.count == 0)
+			return type_void;
+
+		// single names are a scope lookup away, caching them costs more than resolving them
+		if (sign.atoms.count == 1 && sign.atoms[0].kind == Type_Sign_Atom::KIND_NAMED)
+			return _typer_resolve_type_sign_internal(self, sign, nullptr);
+
+		Type_Sign_Cache_Key key{};
+		key.words = mn::buf_with_allocator<size_t>(mn::memory::tmp());
+		if (_typer_type_sign_key(self, key, sign) == false)
+			return _typer_resolve_type_sign_internal(self, sign, nullptr);
+
+		if (auto it = mn::map_lookup(self.type_sign_cache, key))
+		{
+			for (auto dependency: it->value.dependencies)
+				_typer_add_dependency(self, dependency);
+			return it->value.type;
+		}
+
+		auto errs_count = self.unit->errs.count;
+		auto dependencies = mn::buf_new<Symbol*>();
+		auto res = _typer_resolve_type_sign_internal(self, sign, &dependencies);
+
+		// we don't cache signatures which failed to resolve so that we report their errors at every usage
+		if (self.unit->errs.count == errs_count)
+		{
+			Type_Sign_Cache_Key cached_key{};
+			cached_key.words = mn::buf_memcpy_clone(key.words);
+			Type_Sign_Cache_Entry entry{};
+			entry.type = res;
+			entry.dependencies = dependencies;
+			mn::map_insert(self.type_sign_cache, cached_key, entry);
+		}
+		else
+		{
+			mn::buf_free(dependencies);
+		}
+		return res;
+	}
+
 	inline static Type*
 	_typer_resolve_atom_expr(Typer& self, Expr* e)
 	{
@@ -1188,6 +1335,26 @@ namespace sabre
 		int score;
 	};
 
+	// subgroup builtins are only allowed when the target supports them
+	inline static void
+	_typer_check_builtin_call(Typer& self, Expr* e)
+	{
+		auto func = e->call.func;
+		if (func == nullptr)
+			return;
+
+		if (mn::map_lookup(func->tags.table, KEYWORD_BUILTIN) == nullptr)
+			return;
+
+		if (mn::map_lookup(func->tags.table, KEYWORD_SUBGROUP) && self.unit->parent_unit->options.enable_subgroups == false)
+		{
+			Err err{};
+			err.loc = e->loc;
+			err.msg = mn::strf("'{}' is a subgroup operation, but subgroup operations are not enabled for this target", func->name.str);
+			unit_err(self.unit, err);
+		}
+	}
+
 	inline static Type*
 	_typer_resolve_call_expr(Typer& self, Expr* e)
 	{
@@ -1251,7 +1418,7 @@ namespace sabre
 
 						e->call.func = instantiated_decl;
 						e->call.base->symbol = instantiation_sym;
-						auto templated_scope = unit_scope_find(self.unit->parent_unit, templated_decl);
+						auto templated_scope = templated_decl->scope;
 						auto instantiated_scope = unit_create_scope_for(self.unit, instantiated_decl, templated_scope->parent, instantiated_decl->name.str, instantiated_type->as_func.sign.return_type, Scope::FLAG_NONE);
 						_typer_enter_scope(self, instantiated_scope);
 						{
@@ -1406,7 +1573,7 @@ namespace sabre
 						instantiated_decl->type = instantiated_type;
 						type_interner_add_func_instantiation_decl(self.unit->parent_unit->type_interner, candidate->type, arg_types, instantiated_decl);
 
-						auto templated_scope = unit_scope_find(self.unit->parent_unit, templated_decl);
+						auto templated_scope = templated_decl->scope;
 						auto instantiated_scope = unit_create_scope_for(self.unit, instantiated_decl, templated_scope->parent, instantiated_decl->name.str, instantiated_type->as_func.sign.return_type, Scope::FLAG_NONE);
 						_typer_enter_scope(self, instantiated_scope);
 						{
@@ -1814,10 +1981,37 @@ namespace sabre
 		}
 	}
 
+	// buffers have no static count, elements of read only buffers (Buffer<T>) can't be assigned into
+	inline static Type*
+	_typer_resolve_indexed_buffer_expr(Typer& self, Expr* e, Type* base_type)
+	{
+		auto element_type = type_buffer_element(base_type);
+
+		auto index_type = _typer_resolve_expr(self, e->indexed.index);
+		if (type_is_equal(index_type, type_int) == false &&
+			type_is_equal(index_type, type_uint) == false)
+		{
+			Err err{};
+			err.loc = e->indexed.index->loc;
+			err.msg = mn::strf("buffer index type should be an int or uint, but we found '{}'", *index_type);
+			unit_err(self.unit, err);
+			return element_type;
+		}
+
+		if (base_type->kind == Type::KIND_RW_BUFFER)
+			e->mode = ADDRESS_MODE_VARIABLE;
+		else
+			e->mode = ADDRESS_MODE_COMPUTED_VALUE;
+		return element_type;
+	}
+
 	inline static Type*
 	_typer_resolve_indexed_expr(Typer& self, Expr* e)
 	{
 		auto base_type = _typer_resolve_expr(self, e->indexed.base);
+		if (type_is_buffer(base_type) && type_is_templated(base_type) == false)
+			return _typer_resolve_indexed_buffer_expr(self, e, base_type);
+
 		if (type_is_array(base_type) == false)
 		{
 			Err err{};
@@ -2177,6 +2371,7 @@ namespace sabre
 			break;
 		case Expr::KIND_CALL:
 			e->type = _typer_resolve_call_expr(self, e);
+			_typer_check_builtin_call(self, e);
 			break;
 		case Expr::KIND_CAST:
 			e->type = _typer_resolve_cast_expr(self, e);
@@ -2270,6 +2465,71 @@ namespace sabre
 		return res;
 	}
 
+	// resolves the binding set of the given uniform variable from the frequency argument of its uniform tag,
+	// uniforms without a frequency default to the per frame set
+	inline static void
+	_typer_resolve_uniform_frequency(Typer& self, Symbol* sym, const Tag& uniform_tag)
+	{
+		sym->var_sym.uniform_set = BINDING_FREQUENCY_PER_FRAME;
+
+		auto frequency_it = mn::map_lookup(uniform_tag.args, KEYWORD_FREQUENCY);
+		if (frequency_it == nullptr)
+			return;
+
+		auto value = frequency_it->value.value;
+		if (value.kind == Tkn::KIND_LITERAL_STRING)
+		{
+			for (int i = 0; i < BINDING_FREQUENCY_COUNT; ++i)
+			{
+				if (::strcmp(value.str, binding_frequency_name(BINDING_FREQUENCY(i))) == 0)
+				{
+					sym->var_sym.uniform_set = i;
+					return;
+				}
+			}
+		}
+
+		Err err{};
+		err.loc = frequency_it->value.key.loc;
+		err.msg = mn::strf("invalid uniform frequency, allowed values are \"per_frame\", \"per_material\" and \"per_draw\"");
+		unit_err(self.unit, err);
+	}
+
+	// calculates the layout of the uniform block of the given uniform variable
+	inline static void
+	_typer_calc_uniform_layout(Typer& self, Symbol* sym, const Tag& uniform_tag)
+	{
+		auto type = sym->type;
+		auto packed_it = mn::map_lookup(uniform_tag.args, KEYWORD_PACKED);
+		if (type->kind != Type::KIND_STRUCT)
+		{
+			if (packed_it)
+			{
+				Err err{};
+				err.loc = packed_it->value.key.loc;
+				err.msg = mn::strf("packed layout can only be used with struct uniforms, but uniform type is '{}'", *type);
+				unit_err(self.unit, err);
+			}
+			sym->var_sym.uniform_size = type->unaligned_size;
+			return;
+		}
+
+		if (packed_it == nullptr)
+		{
+			sym->var_sym.uniform_fields = type->struct_type.fields;
+			sym->var_sym.uniform_size = type->unaligned_size;
+			return;
+		}
+
+		sym->var_sym.uniform_fields = type_interner_packed_uniform_fields(self.unit->parent_unit->type_interner, type);
+		sym->var_sym.uniform_size = 0;
+		if (sym->var_sym.uniform_fields.count > 0)
+		{
+			const auto& last_field = mn::buf_top(sym->var_sym.uniform_fields);
+			sym->var_sym.uniform_size = last_field.offset + last_field.type->unaligned_size;
+		}
+	}
+
 	inline static bool
 	_typer_check_type_suitable_for_uniform(Typer& self, Type* type, size_t depth)
 	{
@@ -2281,6 +2541,12 @@ namespace sabre
 		{
 			return depth == 0;
 		}
+		else if (type_is_buffer(type))
+		{
+			if (depth != 0 || type_is_templated(type))
+				return false;
+			return _typer_check_type_suitable_for_uniform(self, type_buffer_element(type), depth + 1);
+		}
 		else if (type_is_struct(type))
 		{
 			bool res = true;
@@ -2378,7 +2644,55 @@ namespace sabre
 
 		// check uniform types
 		auto decl = symbol_decl(sym);
-		if (auto uniform_tag_it = mn::map_lookup(decl->tags.table, KEYWORD_UNIFORM))
+		auto uniform_tag_it = mn::map_lookup(decl->tags.table, KEYWORD_UNIFORM);
+		auto push_constant_tag_it = mn::map_lookup(decl->tags.table, KEYWORD_PUSH_CONSTANT);
+		auto shared_tag_it = mn::map_lookup(decl->tags.table, KEYWORD_SHARED);
+		if (uniform_tag_it && push_constant_tag_it)
+		{
+			Err err{};
+			err.loc = symbol_location(sym);
+			err.msg = mn::strf("'@uniform' and '@push_constant' tags cannot be used together");
+			unit_err(self.unit, err);
+		}
+		else if (shared_tag_it && (uniform_tag_it || push_constant_tag_it))
+		{
+			Err err{};
+			err.loc = symbol_location(sym);
+			err.msg = mn::strf("'@shared' tag cannot be used with '@uniform' or '@push_constant' tags");
+			unit_err(self.unit, err);
+		}
+		else if (push_constant_tag_it)
+		{
+			if (res->kind == Type::KIND_TEXTURE ||
+				type_is_sampler(res) ||
+				type_is_buffer(res) ||
+				_typer_check_type_suitable_for_uniform(self, res, 0) == false)
+			{
+				Err err{};
+				err.loc = symbol_location(sym);
+				err.msg = mn::strf("push constant variable type '{}' contains types which cannot be used in a push constant", *res);
+				unit_err(self.unit, err);
+			}
+			else
+			{
+				sym->var_sym.is_uniform = true;
+				sym->var_sym.is_push_constant = true;
+				_typer_calc_uniform_layout(self, sym, push_constant_tag_it->value);
+				if (sym->var_sym.uniform_size > PUSH_CONSTANT_MAX_SIZE)
+				{
+					Err err{};
+					err.loc = symbol_location(sym);
+					err.msg = mn::strf(
+						"push constant variable type '{}' is {} bytes which exceeds the push constant limit of {} bytes",
+						*res,
+						sym->var_sym.uniform_size,
+						PUSH_CONSTANT_MAX_SIZE
+					);
+					unit_err(self.unit, err);
+				}
+			}
+		}
+		else if (uniform_tag_it)
 		{
 			if (_typer_check_type_suitable_for_uniform(self, res, 0) == false)
 			{
@@ -2387,12 +2701,62 @@ namespace sabre
 				err.msg = mn::strf("uniform variable type '{}' contains types which cannot be used in a uniform", *res);
 				unit_err(self.unit, err);
 			}
+			else if (type_is_buffer(res) &&
+				(type_std430_is_tightly_packed(type_buffer_element(res)) == false ||
+				type_std430_stride(type_buffer_element(res)) != type_std430_size(type_buffer_element(res))))
+			{
+				// hlsl structured buffers don't have the std430 padding, so the same buffer data can't be used by both backends
+				Err err{};
+				err.loc = symbol_location(sym);
+				err.msg = mn::strf("buffer element type '{}' is padded in glsl (std430) but tightly packed in hlsl, add explicit padding fields to it", *type_buffer_element(res));
+				unit_err(self.unit, err);
+			}
 			else
 			{
 				sym->var_sym.is_uniform = true;
+				_typer_resolve_uniform_frequency(self, sym, uniform_tag_it->value);
+				_typer_calc_uniform_layout(self, sym, uniform_tag_it->value);
 				mn::buf_push(self.unit->parent_unit->all_uniforms, sym);
 			}
 		}
+		else if (shared_tag_it)
+		{
+			if (sym->is_top_level == false)
+			{
+				Err err{};
+				err.loc = symbol_location(sym);
+				err.msg = mn::strf("shared variable '{}' should be declared in the global scope", sym->name);
+				unit_err(self.unit, err);
+			}
+			else if (e != nullptr)
+			{
+				Err err{};
+				err.loc = symbol_location(sym);
+				err.msg = mn::strf("shared variable '{}' cannot have an initial value", sym->name);
+				unit_err(self.unit, err);
+			}
+			else if (res->kind == Type::KIND_TEXTURE ||
+				type_is_sampler(res) ||
+				type_is_buffer(res) ||
+				_typer_check_type_suitable_for_uniform(self, res, 0) == false)
+			{
+				Err err{};
+				err.loc = symbol_location(sym);
+				err.msg = mn::strf("shared variable type '{}' contains types which cannot be used in shared memory", *res);
+				unit_err(self.unit, err);
+			}
+			else
+			{
+				sym->var_sym.is_shared = true;
+			}
+		}
+		else if (type_is_buffer(res))
+		{
+			Err err{};
+			err.loc = symbol_location(sym);
+			err.msg = mn::strf("buffer variable '{}' should be tagged with '@uniform'", sym->name);
+			unit_err(self.unit, err);
+		}
 
 		return res;
 	}
@@ -2404,6 +2768,14 @@ namespace sabre
 		if (d->type)
 			return d->type;
 
+		if (mn::map_lookup(d->tags.table, KEYWORD_INLINE) && mn::map_lookup(d->tags.table, KEYWORD_NOINLINE))
+		{
+			Err err{};
+			err.loc = d->name.loc;
+			err.msg = mn::strf("'@inline' and '@noinline' tags cannot be used together");
+			unit_err(self.unit, err);
+		}
+
 		// TODO: find a nice way to handle the return type of function return type here, for now
 		// we set it to void then overwrite it later at the end of this function
 		auto scope = unit_create_scope_for(self.unit, d, _typer_current_scope(self), d->name.str, type_void, Scope::FLAG_NONE);
@@ -2427,6 +2799,15 @@ namespace sabre
 			for (auto arg: d->func_decl.args)
 			{
 				auto arg_type = _typer_resolve_type_sign(self, arg.type);
+				// storage buffers can't be passed around in GLSL, functions should use the buffer uniform directly
+				if (type_is_buffer(arg_type))
+				{
+					Err err{};
+					err.loc = type_sign_location(arg.type);
+					err.msg = mn::strf("type '{}' cannot be used as a function argument", *arg_type);
+					unit_err(self.unit, err);
+				}
+
 				if (arg.names.count > 0)
 				{
 					for (size_t i = 0; i < arg.names.count; ++i)
@@ -2554,9 +2935,85 @@ namespace sabre
 		return ret;
 	}
 
+	// checks the control flow hint tags of for and if statements
+	inline static void
+	_typer_check_stmt_tags(Typer& self, Stmt* s)
+	{
+		if (s->tags.table.count == 0)
+			return;
+
+		for (const auto& [name, tag]: s->tags.table)
+		{
+			bool is_loop_tag = name == KEYWORD_UNROLL || name == KEYWORD_LOOP;
+			bool is_branch_tag = name == KEYWORD_BRANCH || name == KEYWORD_FLATTEN;
+			if (is_loop_tag == false && is_branch_tag == false)
+			{
+				Err err{};
+				err.loc = tag.name.loc;
+				err.msg = mn::strf("unknown statement tag '@{}'", name);
+				unit_err(self.unit, err);
+				continue;
+			}
+
+			if (is_loop_tag && s->kind != Stmt::KIND_FOR)
+			{
+				Err err{};
+				err.loc = tag.name.loc;
+				err.msg = mn::strf("'@{}' tag can only be used on for statements", name);
+				unit_err(self.unit, err);
+			}
+			else if (is_branch_tag && s->kind != Stmt::KIND_IF)
+			{
+				Err err{};
+				err.loc = tag.name.loc;
+				err.msg = mn::strf("'@{}' tag can only be used on if statements", name);
+				unit_err(self.unit, err);
+			}
+
+			for (const auto& [key, arg]: tag.args)
+			{
+				if (name == KEYWORD_UNROLL && key == KEYWORD_COUNT)
+				{
+					if (arg.value.kind != Tkn::KIND_LITERAL_INTEGER || ::atoi(arg.value.str) <= 0)
+					{
+						Err err{};
+						err.loc = arg.value.loc;
+						err.msg = mn::strf("unroll count should be a positive integer");
+						unit_err(self.unit, err);
+					}
+				}
+				else
+				{
+					Err err{};
+					err.loc = arg.key.loc;
+					err.msg = mn::strf("unknown tag argument '{}' for '@{}'", key, name);
+					unit_err(self.unit, err);
+				}
+			}
+		}
+
+		if (mn::map_lookup(s->tags.table, KEYWORD_UNROLL) && mn::map_lookup(s->tags.table, KEYWORD_LOOP))
+		{
+			Err err{};
+			err.loc = s->loc;
+			err.msg = mn::strf("'@unroll' and '@loop' tags cannot be used together");
+			unit_err(self.unit, err);
+		}
+
+		if (mn::map_lookup(s->tags.table, KEYWORD_BRANCH) && mn::map_lookup(s->tags.table, KEYWORD_FLATTEN))
+		{
+			Err err{};
+			err.loc = s->loc;
+			err.msg = mn::strf("'@branch' and '@flatten' tags cannot be used together");
+			unit_err(self.unit, err);
+		}
+	}
+
 	inline static Type*
 	_typer_resolve_if_stmt(Typer& self, Stmt* s)
 	{
+		_typer_check_stmt_tags(self, s);
+
 		if (s->if_stmt.cond.count != s->if_stmt.body.count)
 		{
 			Err err{};
@@ -2587,6 +3044,8 @@ namespace sabre
 	inline static Type*
 	_typer_resolve_for_stmt(Typer& self, Stmt* s)
 	{
+		_typer_check_stmt_tags(self, s);
+
 		auto scope = unit_create_scope_for(self.unit, s, _typer_current_scope(self), "for loop", nullptr, Scope::FLAG_INSIDE_LOOP);
 		_typer_enter_scope(self, scope);
 		{
@@ -3123,61 +3582,6 @@ namespace sabre
 		}
 	}
 
-	inline static const char*
-	_typer_generate_package_name_for_symbol(Typer& self, Symbol* sym, bool prepend_scope)
-	{
-		auto scope = sym->scope;
-
-		auto res = mn::str_tmp();
-
-		if (prepend_scope)
-		{
-			// we want to generate the name in reverse order of the scopes hierarchy
-			auto prefix_list = mn::buf_with_allocator<const char*>(mn::memory::tmp());
-			for (auto it = scope; it != nullptr; it = it->parent)
-			{
-				auto scope_name = mn::str_lit(it->name);
-				if (scope_name.count == 0)
-					continue;
-				mn::buf_push(prefix_list, scope_name.ptr);
-			}
-
-			for (size_t i = 0; i < prefix_list.count; ++i)
-			{
-				auto prefix_name = prefix_list[prefix_list.count - i - 1];
-				res = mn::strf(res, "{}_", prefix_name);
-			}
-			res = mn::strf(res, "{}", sym->name);
-		}
-		else
-		{
-			res = mn::strf(res, "{}", sym->name);
-		}
-
-		auto interned_res = unit_intern(self.unit->parent_unit, res.ptr);
-
-		bool collided = false;
-		// try to search the already generated names for this new name and if found
-		// we'll try to make a new name for us
-		for (auto it = scope; it != nullptr; it = it->parent)
-		{
-			if (auto name_it = mn::map_lookup(it->generated_names, interned_res))
-			{
-				res = mn::strf(res, "_{}", name_it->value + 1);
-				auto interned_res = unit_intern(self.unit->parent_unit, res.ptr);
-				++name_it->value;
-				collided = true;
-				break;
-			}
-		}
-
-		if (collided == false)
-		{
-			mn::map_insert(scope->generated_names, interned_res, (size_t)1);
-		}
-		return interned_res;
-	}
-
 	inline static void
 	_typer_resolve_symbol(Typer& self, Symbol* sym)
 	{
@@ -3283,18 +3687,8 @@ namespace sabre
 
 		_typer_leave_symbol(self);
 
-		// if sym is top level we add it to reachable symbols
-		sym->is_top_level = scope_is_top_level(self.global_scope, sym);
-		if (auto decl = symbol_decl(sym))
-			sym->is_top_level |= scope_is_top_level(decl->loc.file->file_scope, sym);
-
-		// we don't prepend scope for local variables
-		bool prepend_scope = true;
-		if (sym->kind == Symbol::KIND_VAR && sym->is_top_level == false)
-			prepend_scope = false;
-
-		sym->package_name = _typer_generate_package_name_for_symbol(self, sym, prepend_scope);
-
+		// if sym is top level we add it to reachable symbols, top level symbols are marked
+		// when they're added to the global/file scope in _typer_shallow_process_decl
 		if (sym->is_top_level ||
 			sym->kind == Symbol::KIND_FUNC ||
 			sym->kind == Symbol::KIND_FUNC_OVERLOAD_SET)
@@ -3405,12 +3799,98 @@ namespace sabre
 		}
 	}
 
+	// compute shaders have no vertex attributes or varyings, their input fields are all system values
+	inline static void
+	_typer_check_compute_struct_input(Typer& self, Type* type)
+	{
+		auto struct_decl = symbol_decl(type->struct_type.symbol);
+		size_t struct_type_index = 0;
+		for (const auto& field: struct_decl->struct_decl.fields)
+		{
+			const auto& struct_field = type->struct_type.fields[struct_type_index];
+
+			Type* expected_type = nullptr;
+			if (mn::map_lookup(field.tags.table, KEYWORD_SV_DISPATCH_THREAD_ID) != nullptr ||
+				mn::map_lookup(field.tags.table, KEYWORD_SV_GROUP_ID) != nullptr ||
+				mn::map_lookup(field.tags.table, KEYWORD_SV_GROUP_THREAD_ID) != nullptr)
+			{
+				expected_type = type_uvec3;
+			}
+			else if (mn::map_lookup(field.tags.table, KEYWORD_SV_GROUP_INDEX) != nullptr)
+			{
+				expected_type = type_uint;
+			}
+
+			if (expected_type == nullptr)
+			{
+				Err err{};
+				err.loc = struct_field.name.loc;
+				err.msg = mn::strf("compute shader input '{}' should be tagged with a system value tag like '@system_dispatch_thread_id'", struct_field.name.str);
+				unit_err(self.unit, err);
+			}
+			else if (struct_field.type != expected_type)
+			{
+				Err err{};
+				err.loc = struct_field.name.loc;
+				err.msg = mn::strf("compute shader input '{}' type is '{}', but it should be '{}'", struct_field.name.str, *struct_field.type, *expected_type);
+				unit_err(self.unit, err);
+			}
+			struct_type_index += field.names.count;
+		}
+	}
+
+	inline static void
+	_typer_check_compute_entry_input(Typer& self, Entry_Point* entry)
+	{
+		auto decl = symbol_decl(entry->symbol);
+		auto type = entry->symbol->type;
+
+		size_t type_index = 0;
+		for (auto arg: decl->func_decl.args)
+		{
+			auto arg_type = type->as_func.sign.args.types[type_index];
+			if (arg_type->kind == Type::KIND_STRUCT)
+			{
+				_typer_check_compute_struct_input(self, arg_type);
+			}
+			else
+			{
+				Location err_loc{};
+				if (arg.type.atoms.count > 0)
+					err_loc = mn::buf_top(arg.type.atoms).named.type_name.loc;
+				else if (arg.names.count > 0)
+					err_loc = arg.names[0].loc;
+
+				Err err{};
+				err.loc = err_loc;
+				err.msg = mn::strf("type '{}' cannot be used as compute shader input, only structs with system value fields are allowed", *arg_type);
+				unit_err(self.unit, err);
+			}
+			type_index += arg.names.count;
+		}
+
+		auto return_type = type->as_func.sign.return_type;
+		if (return_type != type_void)
+		{
+			Err err{};
+			err.loc = decl->loc;
+			err.msg = mn::strf("compute shader return type should be void, but found '{}'", *return_type);
+			unit_err(self.unit, err);
+		}
+	}
+
 	inline static void
 	_typer_check_entry_input(Typer& self, Entry_Point* entry)
 	{
 		auto decl = symbol_decl(entry->symbol);
 		auto type = entry->symbol->type;
 
+		if (entry->mode == COMPILATION_MODE_COMPUTE)
+		{
+			_typer_check_compute_entry_input(self, entry);
+			return;
+		}
+
 		if (auto tag_it = mn::map_lookup(decl->tags.table, KEYWORD_GEOMETRY))
 		{
 			if (mn::map_lookup(tag_it->value.args, KEYWORD_MAX_VERTEX_COUNT) == nullptr)
@@ -3420,6 +3900,16 @@ namespace sabre
 				err.msg = mn::strf("geometry shader should have max vertex count tag argument '@geometry{{max_vertex_count = 6, ...}}'");
 				unit_err(self.unit, err);
 			}
+
+			// geometry shader varyings are not packed, so they wouldn't match the packed varyings of the
+			// vertex and pixel stages around them
+			if (self.unit->parent_unit->options.pack_varyings)
+			{
+				Err err{};
+				err.loc = tag_it->value.name.loc;
+				err.msg = mn::strf("varyings packing is not supported for geometry shaders");
+				unit_err(self.unit, err);
+			}
 		}
 
 		size_t type_index = 0;
@@ -3538,149 +4028,70 @@ namespace sabre
 		}
 	}
 
+	// reads the workgroup size from '@compute{x = 8, y = 8, z = 1}', missing dimensions default to 1
 	inline static void
-	_typer_assign_bindings(Typer& self, Entry_Point* entry, Symbol* sym)
+	_typer_resolve_workgroup_size(Typer& self, Entry_Point* entry, const Tag& tag)
 	{
-		mn_assert(sym->kind == Symbol::KIND_VAR && sym->var_sym.is_uniform);
-		if (sym->var_sym.uniform_binding_processed)
+		const char* dims[] = {KEYWORD_X, KEYWORD_Y, KEYWORD_Z};
+		for (size_t i = 0; i < 3; ++i)
 		{
-			if (entry)
-			{
-				if (sym->type->kind == Type::KIND_TEXTURE)
-				{
-					mn::buf_push(entry->textures, sym);
-				}
-				else if (type_is_sampler(sym->type))
-				{
-					mn::buf_push(entry->samplers, sym);
-				}
-				else
-				{
-					mn::buf_push(entry->uniforms, sym);
-				}
-			}
-			return;
-		}
+			entry->workgroup_size[i] = 1;
 
-		sym->var_sym.uniform_binding_processed = true;
-		auto decl = symbol_decl(sym);
-		auto uniform_tag_it = mn::map_lookup(decl->tags.table, KEYWORD_UNIFORM);
-		if (sym->type->kind == Type::KIND_TEXTURE)
-		{
-			if (auto binding_it = mn::map_lookup(uniform_tag_it->value.args, KEYWORD_BINDING))
-			{
-				auto value_tkn = binding_it->value.value;
-				if (value_tkn.kind == Tkn::KIND_LITERAL_INTEGER)
-				{
-					sym->var_sym.uniform_binding = ::atoi(value_tkn.str);
-					if (sym->var_sym.uniform_binding > self.texture_binding_generator)
-						self.texture_binding_generator = sym->var_sym.uniform_binding + 1;
-				}
-			}
-			else
-			{
-				sym->var_sym.uniform_binding = self.texture_binding_generator++;
-			}
+			auto arg_it = mn::map_lookup(tag.args, dims[i]);
+			if (arg_it == nullptr)
+				continue;
 
-			if (auto it = mn::map_lookup(self.unit->parent_unit->reachable_textures, sym->var_sym.uniform_binding))
+			const auto& value = arg_it->value.value;
+			if (value.kind != Tkn::KIND_LITERAL_INTEGER || ::atoi(value.str) <= 0)
 			{
-				auto old_sym = it->value;
-				auto old_loc = symbol_location(old_sym);
-
 				Err err{};
-				err.loc = symbol_location(sym);
-				err.msg = mn::strf(
-					"texture binding point {} is shared with other texture defined in {}:{}",
-					sym->var_sym.uniform_binding,
-					old_loc.file->filepath,
-					old_loc.pos.line
-				);
+				err.loc = value.loc;
+				err.msg = mn::strf("compute shader workgroup size '{}' should be a positive integer", dims[i]);
 				unit_err(self.unit, err);
+				continue;
 			}
-			else
-			{
-				mn::map_insert(self.unit->parent_unit->reachable_textures, sym->var_sym.uniform_binding, sym);
-				if (entry)
-					mn::buf_push(entry->textures, sym);
-			}
+			entry->workgroup_size[i] = ::atoi(value.str);
 		}
-		else if (type_is_sampler(sym->type))
-		{
-			if (auto binding_it = mn::map_lookup(uniform_tag_it->value.args, KEYWORD_BINDING))
-			{
-				auto value_tkn = binding_it->value.value;
-				if (value_tkn.kind == Tkn::KIND_LITERAL_INTEGER)
-				{
-					sym->var_sym.uniform_binding = ::atoi(value_tkn.str);
-					if (sym->var_sym.uniform_binding > self.sampler_binding_generator)
-						self.sampler_binding_generator = sym->var_sym.uniform_binding + 1;
-				}
-			}
-			else
-			{
-				sym->var_sym.uniform_binding = self.sampler_binding_generator++;
-			}
+	}
 
-			if (auto it = mn::map_lookup(self.unit->parent_unit->reachable_samplers, sym->var_sym.uniform_binding))
+	inline static void
+	_typer_collect_resources(Typer& self, Entry_Point* entry, Symbol* sym)
+	{
+		mn_assert(sym->kind == Symbol::KIND_VAR && sym->var_sym.is_uniform);
+		// binding points are assigned later by the binding layout solver once all the entries are known
+		if (sym->var_sym.is_push_constant)
+		{
+			if (entry->push_constant)
 			{
-				auto old_sym = it->value;
-				auto old_loc = symbol_location(old_sym);
-
 				Err err{};
-				err.loc = symbol_location(sym);
+				err.loc = symbol_location(entry->symbol);
 				err.msg = mn::strf(
-					"sampler binding point {} is shared with other sampler defined in {}:{}",
-					sym->var_sym.uniform_binding,
-					old_loc.file->filepath,
-					old_loc.pos.line
+					"entry point uses more than one push constant, '{}' and '{}'",
+					entry->push_constant->name,
+					sym->name
 				);
 				unit_err(self.unit, err);
 			}
 			else
 			{
-				mn::map_insert(self.unit->parent_unit->reachable_samplers, sym->var_sym.uniform_binding, sym);
-				if (entry)
-					mn::buf_push(entry->samplers, sym);
+				entry->push_constant = sym;
 			}
 		}
+		else if (sym->type->kind == Type::KIND_TEXTURE)
+		{
+			mn::buf_push(entry->textures, sym);
+		}
+		else if (type_is_sampler(sym->type))
+		{
+			mn::buf_push(entry->samplers, sym);
+		}
+		else if (type_is_buffer(sym->type))
+		{
+			mn::buf_push(entry->buffers, sym);
+		}
 		else
 		{
-			if (auto binding_it = mn::map_lookup(uniform_tag_it->value.args, KEYWORD_BINDING))
-			{
-				auto value_tkn = binding_it->value.value;
-				if (value_tkn.kind == Tkn::KIND_LITERAL_INTEGER)
-				{
-					sym->var_sym.uniform_binding = ::atoi(value_tkn.str);
-					if (sym->var_sym.uniform_binding > self.uniform_binding_generator)
-						self.uniform_binding_generator = sym->var_sym.uniform_binding + 1;
-				}
-			}
-			else
-			{
-				sym->var_sym.uniform_binding = self.uniform_binding_generator++;
-			}
-
-			if (auto it = mn::map_lookup(self.unit->parent_unit->reachable_uniforms, sym->var_sym.uniform_binding))
-			{
-				auto old_sym = it->value;
-				auto old_loc = symbol_location(old_sym);
-
-				Err err{};
-				err.loc = symbol_location(sym);
-				err.msg = mn::strf(
-					"uniform binding point {} is shared with other uniform defined in {}:{}",
-					sym->var_sym.uniform_binding,
-					old_loc.file->filepath,
-					old_loc.pos.line
-				);
-				unit_err(self.unit, err);
-			}
-			else
-			{
-				mn::map_insert(self.unit->parent_unit->reachable_uniforms, sym->var_sym.uniform_binding, sym);
-				if (entry)
-					mn::buf_push(entry->uniforms, sym);
-			}
+			mn::buf_push(entry->uniforms, sym);
 		}
 	}
 
@@ -3702,6 +4113,8 @@ namespace sabre
 		mn::buf_free(self.scope_stack);
 		mn::buf_free(self.expected_expr_type);
 		mn::buf_free(self.func_stack);
+		_typer_type_sign_cache_clear(self);
+		mn::map_free(self.type_sign_cache);
 	}
 
 	void
@@ -3709,8 +4122,9 @@ namespace sabre
 	{
 		_typer_shallow_walk(self);
 
-		for (auto sym: self.unit->global_scope->symbols)
+		for (size_t i = 0; i < self.unit->global_scope->symbols_count; ++i)
 		{
+			auto sym = scope_symbol(self.unit->global_scope, i);
 			if (sym->kind == Symbol::KIND_FUNC)
 			{
 				auto decl = symbol_decl(sym);
@@ -3729,14 +4143,20 @@ namespace sabre
 					auto entry = entry_point_new(sym, COMPILATION_MODE_GEOMETRY);
 					mn::buf_push(self.unit->entry_points, entry);
 				}
+				else if (auto tag_it = mn::map_lookup(decl->tags.table, KEYWORD_COMPUTE))
+				{
+					auto entry = entry_point_new(sym, COMPILATION_MODE_COMPUTE);
+					_typer_resolve_workgroup_size(self, entry, tag_it->value);
+					mn::buf_push(self.unit->entry_points, entry);
+				}
 			}
 		}
 
 		// check all symbols
-		for (auto sym: self.global_scope->symbols)
-			_typer_resolve_symbol(self, sym);
+		for (size_t i = 0; i < self.global_scope->symbols_count; ++i)
+			_typer_resolve_symbol(self, scope_symbol(self.global_scope, i));
 
-		// handle binding points
+		// collect the resources used by each entry
 		auto visited = mn::set_with_allocator<Symbol*>(mn::memory::tmp());
 		auto stack = mn::buf_with_allocator<Symbol*>(mn::memory::tmp());
 		for (auto entry: self.unit->entry_points)
@@ -3755,7 +4175,14 @@ namespace sabre
 				// process symbol here
 				if (sym->kind == Symbol::KIND_VAR && sym->var_sym.is_uniform)
 				{
-					_typer_assign_bindings(self, entry, sym);
+					_typer_collect_resources(self, entry, sym);
+				}
+				else if (sym->kind == Symbol::KIND_VAR && sym->var_sym.is_shared && entry->mode != COMPILATION_MODE_COMPUTE)
+				{
+					Err err{};
+					err.loc = symbol_location(sym);
+					err.msg = mn::strf("shared variable '{}' can only be used in compute shaders, but it's used by '{}'", sym->name, entry->symbol->name);
+					unit_err(self.unit, err);
 				}
 
 				for (auto d: sym->dependencies)
@@ -3768,9 +4195,6 @@ namespace sabre
 				}
 			}
 		}
-
-		for (auto sym: self.unit->parent_unit->all_uniforms)
-			_typer_assign_bindings(self, nullptr, sym);
 	}
 
 	void
@@ -0,0 +1,463 @@
+#include "sabre/DCE.h"
+#include "sabre/Unit.h"
+#include "sabre/AST.h"
+#include "sabre/Scope.h"
+#include "sabre/Type_Interner.h"
+
+#include <mn/Buf.h>
+#include <mn/Map.h>
+#include <mn/Memory.h>
+#include <mn/Defer.h>
+#include <mn/Assert.h>
+
+namespace sabre
+{
+	struct DCE
+	{
+		DCE_Stats stats;
+		mn::Buf<Scope*> scope_stack;
+		// number of reads of each local variable/constant in the function we're currently processing
+		mn::Map<Symbol*, size_t> reads;
+	};
+
+	inline static DCE
+	_dce_new()
+	{
+		DCE self{};
+		self.scope_stack = mn::buf_with_allocator<Scope*>(mn::memory::tmp());
+		self.reads = mn::map_with_allocator<Symbol*, size_t>(mn::memory::tmp());
+		return self;
+	}
+
+	inline static size_t
+	_dce_stats_total(const DCE_Stats& stats)
+	{
+		return stats.removed_stmts + stats.removed_vars + stats.removed_branches;
+	}
+
+	inline static void
+	_dce_enter_scope(DCE& self, Scope* scope)
+	{
+		if (scope)
+			mn::buf_push(self.scope_stack, scope);
+	}
+
+	inline static void
+	_dce_leave_scope(DCE& self, Scope* scope)
+	{
+		if (scope)
+			mn::buf_pop(self.scope_stack);
+	}
+
+	inline static Scope*
+	_dce_current_scope(DCE& self)
+	{
+		return mn::buf_top(self.scope_stack);
+	}
+
+	// returns the names and values of variable and constant declarations, other declarations are ignored
+	inline static bool
+	_dce_decl_names_values(Decl* d, mn::Buf<Tkn>*& names, mn::Buf<Expr*>*& values)
+	{
+		switch (d->kind)
+		{
+		case Decl::KIND_VAR:
+			names = &d->var_decl.names;
+			values = &d->var_decl.values;
+			return true;
+		case Decl::KIND_CONST:
+			names = &d->const_decl.names;
+			values = &d->const_decl.values;
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	inline static bool
+	_dce_expr_is_const_bool(const Expr* e, bool value)
+	{
+		return e->const_value.type == type_bool && e->const_value.as_bool == value;
+	}
+
+	inline static bool
+	_dce_is_unused_local(DCE& self, Symbol* sym)
+	{
+		if (sym == nullptr)
+			return false;
+
+		if (auto it = mn::map_lookup(self.reads, sym))
+			return it->value == 0;
+		return false;
+	}
+
+	inline static void
+	_dce_count_reads_in_expr(DCE& self, Expr* e)
+	{
+		if (e == nullptr)
+			return;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			if (auto it = mn::map_lookup(self.reads, e->symbol))
+				++it->value;
+			break;
+		case Expr::KIND_BINARY:
+			_dce_count_reads_in_expr(self, e->binary.left);
+			_dce_count_reads_in_expr(self, e->binary.right);
+			break;
+		case Expr::KIND_UNARY:
+			_dce_count_reads_in_expr(self, e->unary.base);
+			break;
+		case Expr::KIND_CALL:
+			_dce_count_reads_in_expr(self, e->call.base);
+			for (auto arg: e->call.args)
+				_dce_count_reads_in_expr(self, arg);
+			break;
+		case Expr::KIND_CAST:
+			_dce_count_reads_in_expr(self, e->cast.base);
+			break;
+		case Expr::KIND_DOT:
+			_dce_count_reads_in_expr(self, e->dot.lhs);
+			break;
+		case Expr::KIND_INDEXED:
+			_dce_count_reads_in_expr(self, e->indexed.base);
+			_dce_count_reads_in_expr(self, e->indexed.index);
+			break;
+		case Expr::KIND_COMPLIT:
+			for (const auto& field: e->complit.fields)
+				_dce_count_reads_in_expr(self, field.value);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	// counts the reads in the left hand side of an assignment, the assigned variable itself is not read
+	inline static void
+	_dce_count_reads_in_lhs(DCE& self, Expr* e)
+	{
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			break;
+		case Expr::KIND_DOT:
+			if (e->dot.lhs)
+				_dce_count_reads_in_lhs(self, e->dot.lhs);
+			break;
+		case Expr::KIND_INDEXED:
+			_dce_count_reads_in_lhs(self, e->indexed.base);
+			_dce_count_reads_in_expr(self, e->indexed.index);
+			break;
+		default:
+			_dce_count_reads_in_expr(self, e);
+			break;
+		}
+	}
+
+	inline static void
+	_dce_count_reads_in_stmt(DCE& self, Stmt* s)
+	{
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+			break;
+		case Stmt::KIND_RETURN:
+			_dce_count_reads_in_expr(self, s->return_stmt);
+			break;
+		case Stmt::KIND_IF:
+			for (auto cond: s->if_stmt.cond)
+				_dce_count_reads_in_expr(self, cond);
+			for (auto body: s->if_stmt.body)
+				_dce_count_reads_in_stmt(self, body);
+			if (s->if_stmt.else_body)
+				_dce_count_reads_in_stmt(self, s->if_stmt.else_body);
+			break;
+		case Stmt::KIND_FOR:
+			_dce_enter_scope(self, s->scope);
+			if (s->for_stmt.init)
+				_dce_count_reads_in_stmt(self, s->for_stmt.init);
+			_dce_count_reads_in_expr(self, s->for_stmt.cond);
+			if (s->for_stmt.post)
+				_dce_count_reads_in_stmt(self, s->for_stmt.post);
+			_dce_count_reads_in_stmt(self, s->for_stmt.body);
+			_dce_leave_scope(self, s->scope);
+			break;
+		case Stmt::KIND_ASSIGN:
+			for (size_t i = 0; i < s->assign_stmt.lhs.count; ++i)
+			{
+				_dce_count_reads_in_lhs(self, s->assign_stmt.lhs[i]);
+				_dce_count_reads_in_expr(self, s->assign_stmt.rhs[i]);
+			}
+			break;
+		case Stmt::KIND_EXPR:
+			_dce_count_reads_in_expr(self, s->expr_stmt);
+			break;
+		case Stmt::KIND_BLOCK:
+			_dce_enter_scope(self, s->scope);
+			for (auto stmt: s->block_stmt)
+				_dce_count_reads_in_stmt(self, stmt);
+			_dce_leave_scope(self, s->scope);
+			break;
+		case Stmt::KIND_DECL:
+		{
+			mn::Buf<Tkn>* names = nullptr;
+			mn::Buf<Expr*>* values = nullptr;
+			if (_dce_decl_names_values(s->decl_stmt, names, values) == false)
+				break;
+
+			for (auto value: *values)
+				_dce_count_reads_in_expr(self, value);
+
+			auto scope = _dce_current_scope(self);
+			for (auto name: *names)
+				if (auto sym = scope_find(scope, name.str))
+					mn::map_insert(self.reads, sym, size_t(0));
+			break;
+		}
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static bool
+	_dce_stmt_is_terminator(Stmt* s)
+	{
+		return (
+			s->kind == Stmt::KIND_RETURN ||
+			s->kind == Stmt::KIND_DISCARD ||
+			s->kind == Stmt::KIND_BREAK ||
+			s->kind == Stmt::KIND_CONTINUE
+		);
+	}
+
+	inline static bool
+	_dce_prune_stmt(DCE& self, Stmt* s);
+
+	inline static void
+	_dce_prune_block(DCE& self, Stmt* s)
+	{
+		_dce_enter_scope(self, s->scope);
+		mn_defer{_dce_leave_scope(self, s->scope);};
+
+		// everything after a return, discard, break, or continue is unreachable
+		for (size_t i = 0; i + 1 < s->block_stmt.count; ++i)
+		{
+			if (_dce_stmt_is_terminator(s->block_stmt[i]))
+			{
+				self.stats.removed_stmts += s->block_stmt.count - i - 1;
+				mn::buf_resize(s->block_stmt, i + 1);
+				break;
+			}
+		}
+
+		mn::buf_remove_if(s->block_stmt, [&self](Stmt* stmt) { return _dce_prune_stmt(self, stmt); });
+	}
+
+	inline static bool
+	_dce_prune_if_stmt(DCE& self, Stmt* s)
+	{
+		auto& conds = s->if_stmt.cond;
+		auto& bodies = s->if_stmt.body;
+		for (size_t i = 0; i < conds.count; ++i)
+		{
+			if (_dce_expr_is_const_bool(conds[i], false))
+			{
+				mn::buf_remove_ordered(conds, i);
+				mn::buf_remove_ordered(bodies, i);
+				++self.stats.removed_branches;
+				--i;
+			}
+			else if (_dce_expr_is_const_bool(conds[i], true))
+			{
+				// this branch is always taken so it becomes the else branch, and the branches after it are never taken
+				self.stats.removed_branches += conds.count - i - 1;
+				if (s->if_stmt.else_body)
+					++self.stats.removed_branches;
+				s->if_stmt.else_body = bodies[i];
+				mn::buf_resize(conds, i);
+				mn::buf_resize(bodies, i);
+				break;
+			}
+		}
+
+		for (auto body: bodies)
+			_dce_prune_block(self, body);
+
+		if (s->if_stmt.else_body)
+		{
+			_dce_prune_block(self, s->if_stmt.else_body);
+			if (s->if_stmt.else_body->block_stmt.count == 0)
+				s->if_stmt.else_body = nullptr;
+		}
+
+		if (conds.count == 0)
+		{
+			// no condition is left, so we replace the if statement with its else branch
+			if (s->if_stmt.else_body == nullptr)
+				return true;
+			*s = *s->if_stmt.else_body;
+			return false;
+		}
+
+		if (s->if_stmt.else_body)
+			return false;
+
+		for (size_t i = 0; i < conds.count; ++i)
+			if (bodies[i]->block_stmt.count > 0 || expr_has_side_effects(conds[i]))
+				return false;
+
+		++self.stats.removed_stmts;
+		return true;
+	}
+
+	inline static bool
+	_dce_prune_for_stmt(DCE& self, Stmt* s)
+	{
+		if (s->for_stmt.init == nullptr && s->for_stmt.cond && _dce_expr_is_const_bool(s->for_stmt.cond, false))
+		{
+			++self.stats.removed_stmts;
+			return true;
+		}
+
+		_dce_enter_scope(self, s->scope);
+		mn_defer{_dce_leave_scope(self, s->scope);};
+
+		if (s->for_stmt.init && _dce_prune_stmt(self, s->for_stmt.init))
+			s->for_stmt.init = nullptr;
+		if (s->for_stmt.post && _dce_prune_stmt(self, s->for_stmt.post))
+			s->for_stmt.post = nullptr;
+		_dce_prune_block(self, s->for_stmt.body);
+		return false;
+	}
+
+	inline static bool
+	_dce_prune_assign_stmt(DCE& self, Stmt* s)
+	{
+		auto& lhs = s->assign_stmt.lhs;
+		auto& rhs = s->assign_stmt.rhs;
+		for (size_t i = 0; i < lhs.count; ++i)
+		{
+			// stores into variables which are never read are dead
+			if (_dce_is_unused_local(self, expr_assigned_symbol(lhs[i])) == false)
+				continue;
+
+			if (expr_has_side_effects(lhs[i]) || expr_has_side_effects(rhs[i]))
+				continue;
+
+			mn::buf_remove_ordered(lhs, i);
+			mn::buf_remove_ordered(rhs, i);
+			++self.stats.removed_stmts;
+			--i;
+		}
+		return lhs.count == 0;
+	}
+
+	inline static bool
+	_dce_prune_decl_stmt(DCE& self, Stmt* s)
+	{
+		mn::Buf<Tkn>* names = nullptr;
+		mn::Buf<Expr*>* values = nullptr;
+		if (_dce_decl_names_values(s->decl_stmt, names, values) == false)
+			return false;
+
+		auto scope = _dce_current_scope(self);
+		for (size_t i = 0; i < names->count; ++i)
+		{
+			Expr* value = nullptr;
+			if (i < values->count)
+				value = (*values)[i];
+
+			if (_dce_is_unused_local(self, scope_find(scope, (*names)[i].str)) == false)
+				continue;
+
+			if (expr_has_side_effects(value))
+				continue;
+
+			mn::buf_remove_ordered(*names, i);
+			if (i < values->count)
+				mn::buf_remove_ordered(*values, i);
+			++self.stats.removed_vars;
+			--i;
+		}
+		return names->count == 0;
+	}
+
+	// removes the dead code inside the given statement, returns true if the statement itself is dead
+	inline static bool
+	_dce_prune_stmt(DCE& self, Stmt* s)
+	{
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+		case Stmt::KIND_RETURN:
+			return false;
+		case Stmt::KIND_IF:
+			return _dce_prune_if_stmt(self, s);
+		case Stmt::KIND_FOR:
+			return _dce_prune_for_stmt(self, s);
+		case Stmt::KIND_ASSIGN:
+			return _dce_prune_assign_stmt(self, s);
+		case Stmt::KIND_EXPR:
+			if (expr_has_side_effects(s->expr_stmt))
+				return false;
+			++self.stats.removed_stmts;
+			return true;
+		case Stmt::KIND_BLOCK:
+			_dce_prune_block(self, s);
+			if (s->block_stmt.count > 0)
+				return false;
+			++self.stats.removed_stmts;
+			return true;
+		case Stmt::KIND_DECL:
+			return _dce_prune_decl_stmt(self, s);
+		default:
+			mn_unreachable();
+			return false;
+		}
+	}
+
+	inline static void
+	_dce_func(DCE& self, Decl* d)
+	{
+		_dce_enter_scope(self, d->scope);
+		mn_defer{_dce_leave_scope(self, d->scope);};
+
+		// removing code might leave more variables unused, so we iterate until nothing changes
+		while (true)
+		{
+			auto removed_count = _dce_stats_total(self.stats);
+
+			mn::map_clear(self.reads);
+			_dce_count_reads_in_stmt(self, d->func_decl.body);
+			_dce_prune_block(self, d->func_decl.body);
+
+			if (_dce_stats_total(self.stats) == removed_count)
+				break;
+		}
+	}
+
+	// API
+	DCE_Stats
+	dce_entry(Entry_Point* entry)
+	{
+		auto self = _dce_new();
+		unit_reachable_funcs_walk(entry, nullptr, [&](Decl* d) { _dce_func(self, d); });
+		return self.stats;
+	}
+
+	DCE_Stats
+	dce_package(Unit_Package* package)
+	{
+		auto self = _dce_new();
+		unit_reachable_funcs_walk(nullptr, package, [&](Decl* d) { _dce_func(self, d); });
+		return self.stats;
+	}
+}
\ No newline at end of file
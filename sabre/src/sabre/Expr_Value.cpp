@@ -17,6 +17,7 @@ namespace sabre
 		case Type::KIND_UINT:
 		case Type::KIND_FLOAT:
 		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
 		case Type::KIND_FUNC:
 		case Type::KIND_TEXTURE:
 		case Type::KIND_PACKAGE:
@@ -68,7 +69,7 @@ namespace sabre
 		{
 			return expr_value_int(0);
 		}
-		else if (type_is_equal(type, type_float) || type_is_equal(type, type_double))
+		else if (type_is_equal(type, type_float) || type_is_equal(type, type_double) || type_is_equal(type, type_half))
 		{
 			return expr_value_double(0);
 		}
@@ -133,6 +134,32 @@ namespace sabre
 		return {};
 	}
 
+	int64_t
+	expr_value_as_int(Expr_Value self)
+	{
+		if (self.type == type_int)
+			return self.as_int;
+		else if (self.type == type_double)
+			return (int64_t)self.as_double;
+		else if (self.type == type_bool)
+			return self.as_bool;
+		mn_unreachable_msg("expression value is not numerical");
+		return 0;
+	}
+
+	double
+	expr_value_as_double(Expr_Value self)
+	{
+		if (self.type == type_int)
+			return (double)self.as_int;
+		else if (self.type == type_double)
+			return self.as_double;
+		else if (self.type == type_bool)
+			return self.as_bool;
+		mn_unreachable_msg("expression value is not numerical");
+		return 0;
+	}
+
 	Expr_Value
 	expr_value_logic_or(Expr_Value a, Expr_Value b)
 	{
@@ -518,7 +545,7 @@ namespace sabre
 		{
 			return expr_value_double(0);
 		}
-		else if (t == type_double)
+		else if (t == type_double || t == type_half)
 		{
 			return expr_value_double(0);
 		}
@@ -0,0 +1,472 @@
+#include "sabre/Fast_Math.h"
+#include "sabre/Unit.h"
+#include "sabre/AST.h"
+#include "sabre/Scope.h"
+#include "sabre/Type_Interner.h"
+
+#include <mn/Buf.h>
+#include <mn/Map.h>
+#include <mn/Memory.h>
+#include <mn/Assert.h>
+
+#include <string.h>
+
+namespace sabre
+{
+	struct Fast_Math
+	{
+		Fast_Math_Stats stats;
+	};
+
+	inline static Fast_Math
+	_fast_math_new()
+	{
+		Fast_Math self{};
+		return self;
+	}
+
+	inline static bool
+	_fast_math_is_float(Type* t)
+	{
+		if (t == nullptr)
+			return false;
+		if (type_is_vec(t))
+			return t->vec.base == type_float;
+		return type_is_equal(t, type_float);
+	}
+
+	// returns whether the given expression is a constant float scalar, and writes its value into res
+	inline static bool
+	_fast_math_const_float(const Expr* e, double& res)
+	{
+		if (e->const_value.type == nullptr || type_is_equal(e->type, type_float) == false)
+			return false;
+		res = expr_value_as_double(e->const_value);
+		return true;
+	}
+
+	// returns whether we can evaluate the given expression more than once without increasing the cost
+	// which is the case with variable reads and field accesses
+	inline static bool
+	_fast_math_is_cheap(const Expr* e)
+	{
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return true;
+		case Expr::KIND_DOT:
+			return e->dot.lhs && _fast_math_is_cheap(e->dot.lhs);
+		default:
+			return false;
+		}
+	}
+
+	inline static Expr*
+	_fast_math_clone(const Expr* e)
+	{
+		auto res = mn::alloc_zerod_from<Expr>(e->arena);
+		*res = *e;
+		if (e->kind == Expr::KIND_DOT && e->dot.lhs)
+			res->dot.lhs = _fast_math_clone(e->dot.lhs);
+		return res;
+	}
+
+	// returns the name of the builtin function which the given expression calls, or nullptr if it's not a builtin call
+	inline static const char*
+	_fast_math_builtin_call_name(const Expr* e)
+	{
+		if (e->kind != Expr::KIND_CALL || e->call.func == nullptr || e->call.base->symbol == nullptr)
+			return nullptr;
+		if (mn::map_lookup(e->call.func->tags.table, KEYWORD_BUILTIN) == nullptr)
+			return nullptr;
+		return e->call.func->name.str;
+	}
+
+	inline static bool
+	_fast_math_args_match(Type* func_type, Type* arg_type, size_t args_count)
+	{
+		if (func_type == nullptr || func_type->kind != Type::KIND_FUNC)
+			return false;
+		if (func_type->as_func.sign.args.types.count != args_count)
+			return false;
+		for (auto type: func_type->as_func.sign.args.types)
+			if (type_is_equal(type, arg_type) == false)
+				return false;
+		return true;
+	}
+
+	// finds the builtin function with the given name which is declared alongside the builtin which we're
+	// replacing (usually in std.sabre), all of its arguments should be of the given type
+	inline static bool
+	_fast_math_find_builtin(Symbol* near, const char* name, Type* arg_type, size_t args_count, Symbol*& res_sym, Decl*& res_decl)
+	{
+		if (near->scope == nullptr || near->package == nullptr)
+			return false;
+
+		auto sym = scope_shallow_find(near->scope, unit_intern(near->package->parent_unit, name));
+		if (sym == nullptr)
+			return false;
+
+		if (sym->kind == Symbol::KIND_FUNC)
+		{
+			auto decl = sym->func_sym.decl;
+			if (mn::map_lookup(decl->tags.table, KEYWORD_BUILTIN) == nullptr)
+				return false;
+			if (_fast_math_args_match(sym->type, arg_type, args_count) == false)
+				return false;
+			res_sym = sym;
+			res_decl = decl;
+			return true;
+		}
+		else if (sym->kind == Symbol::KIND_FUNC_OVERLOAD_SET)
+		{
+			for (const auto& [decl, type]: sym->func_overload_set_sym.decls)
+			{
+				if (mn::map_lookup(decl->tags.table, KEYWORD_BUILTIN) == nullptr)
+					continue;
+				if (_fast_math_args_match(type, arg_type, args_count) == false)
+					continue;
+				res_sym = sym;
+				res_decl = decl;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// turns the given call expression into a call to another builtin function with the given arguments
+	inline static void
+	_fast_math_change_call(Expr* e, Symbol* sym, Decl* decl, mn::Buf<Expr*> args, Type* ret)
+	{
+		auto base = _fast_math_clone(e->call.base);
+		base->kind = Expr::KIND_ATOM;
+		base->in_parens = false;
+		base->symbol = sym;
+		base->type = decl->type;
+		base->atom.tkn = decl->name;
+		base->atom.decl = decl;
+
+		e->call.base = base;
+		e->call.args = args;
+		e->call.func = decl;
+		e->type = ret;
+		e->mode = ADDRESS_MODE_COMPUTED_VALUE;
+		e->const_value = Expr_Value{};
+	}
+
+	// replaces the content of the given expression, while keeping its parentheses
+	inline static void
+	_fast_math_replace(Expr* e, const Expr* with)
+	{
+		auto in_parens = e->in_parens;
+		*e = *with;
+		e->in_parens = in_parens || with->in_parens;
+	}
+
+	inline static Expr*
+	_fast_math_mul_new(Expr* e, Expr* left, Expr* right)
+	{
+		Tkn op{};
+		op.kind = Tkn::KIND_STAR;
+		op.str = "*";
+		op.loc = e->loc;
+
+		auto res = expr_binary_new(e->arena, left, op, right);
+		res->loc = e->loc;
+		res->type = e->type;
+		res->mode = ADDRESS_MODE_COMPUTED_VALUE;
+		return res;
+	}
+
+	// (a * b) * v => a * (b * v), where a and b are matrices and v is a vector, this replaces
+	// a matrix-matrix multiplication with a cheaper matrix-vector multiplication
+	inline static bool
+	_fast_math_reassociate_mat_mul(Expr* e)
+	{
+		if (e->binary.op.kind != Tkn::KIND_STAR)
+			return false;
+
+		auto left = e->binary.left;
+		if (left->kind != Expr::KIND_BINARY || left->binary.op.kind != Tkn::KIND_STAR)
+			return false;
+
+		if (left->binary.left->type->kind != Type::KIND_MAT ||
+			left->binary.right->type->kind != Type::KIND_MAT ||
+			type_is_vec(e->binary.right->type) == false)
+		{
+			return false;
+		}
+
+		auto a = left->binary.left;
+		auto b = left->binary.right;
+		auto v = e->binary.right;
+
+		left->binary.left = b;
+		left->binary.right = v;
+		left->type = e->type;
+		left->in_parens = true;
+		left->mode = ADDRESS_MODE_COMPUTED_VALUE;
+		left->const_value = Expr_Value{};
+
+		e->binary.left = a;
+		e->binary.right = left;
+		return true;
+	}
+
+	inline static bool
+	_fast_math_rewrite_div(Expr* e)
+	{
+		if (e->binary.op.kind != Tkn::KIND_DIVIDE || _fast_math_is_float(e->type) == false)
+			return false;
+
+		auto right = e->binary.right;
+
+		// x / c => x * (1 / c)
+		double c = 0;
+		if (_fast_math_const_float(right, c))
+		{
+			if (c == 0)
+				return false;
+
+			auto str = mn::str_tmpf("{}", 1.0 / c);
+			if (mn::str_find(str, '.', 0) == SIZE_MAX && mn::str_find(str, 'e', 0) == SIZE_MAX)
+				str = mn::strf(str, ".0");
+
+			Tkn tkn{};
+			tkn.kind = Tkn::KIND_LITERAL_FLOAT;
+			tkn.str = unit_intern(e->loc.file, str.ptr);
+			tkn.loc = right->loc;
+
+			auto reciprocal = expr_atom_new(e->arena, tkn);
+			reciprocal->loc = right->loc;
+			reciprocal->type = right->type;
+			reciprocal->mode = ADDRESS_MODE_CONST;
+			reciprocal->const_value = expr_value_double(1.0 / c);
+
+			e->binary.op.kind = Tkn::KIND_STAR;
+			e->binary.op.str = "*";
+			e->binary.right = reciprocal;
+			return true;
+		}
+
+		// x / length(v) => x * inversesqrt(dot(v, v))
+		if (auto name = _fast_math_builtin_call_name(right); name && ::strcmp(name, "length") == 0)
+		{
+			if (right->call.args.count != 1 || _fast_math_is_cheap(right->call.args[0]) == false)
+				return false;
+
+			auto v = right->call.args[0];
+			Symbol* dot_sym = nullptr;
+			Decl* dot_decl = nullptr;
+			if (_fast_math_find_builtin(right->call.base->symbol, "dot", v->type, 2, dot_sym, dot_decl) == false)
+				return false;
+
+			Symbol* rsqrt_sym = nullptr;
+			Decl* rsqrt_decl = nullptr;
+			if (_fast_math_find_builtin(right->call.base->symbol, "inversesqrt", right->type, 1, rsqrt_sym, rsqrt_decl) == false)
+				return false;
+
+			auto dot = _fast_math_clone(right);
+			auto dot_args = mn::buf_with_allocator<Expr*>(e->arena);
+			mn::buf_push(dot_args, v);
+			mn::buf_push(dot_args, _fast_math_clone(v));
+			_fast_math_change_call(dot, dot_sym, dot_decl, dot_args, right->type);
+			dot->in_parens = false;
+
+			auto rsqrt_args = mn::buf_with_allocator<Expr*>(e->arena);
+			mn::buf_push(rsqrt_args, dot);
+			_fast_math_change_call(right, rsqrt_sym, rsqrt_decl, rsqrt_args, right->type);
+
+			e->binary.op.kind = Tkn::KIND_STAR;
+			e->binary.op.str = "*";
+			return true;
+		}
+
+		return false;
+	}
+
+	inline static bool
+	_fast_math_rewrite_pow(Expr* e)
+	{
+		auto name = _fast_math_builtin_call_name(e);
+		if (name == nullptr || ::strcmp(name, "pow") != 0 || e->call.args.count != 2)
+			return false;
+
+		double p = 0;
+		if (_fast_math_const_float(e->call.args[1], p) == false)
+			return false;
+
+		auto x = e->call.args[0];
+		if (p == 1.0)
+		{
+			// pow(x, 1.0) => x
+			auto res = _fast_math_clone(x);
+			if (res->kind == Expr::KIND_BINARY)
+				res->in_parens = true;
+			_fast_math_replace(e, res);
+			return true;
+		}
+		else if (p == 2.0)
+		{
+			// pow(x, 2.0) => x * x
+			if (_fast_math_is_cheap(x) == false)
+				return false;
+			_fast_math_replace(e, _fast_math_mul_new(e, x, _fast_math_clone(x)));
+			return true;
+		}
+		else if (p == 0.5 || p == -0.5)
+		{
+			// pow(x, 0.5) => sqrt(x), pow(x, -0.5) => inversesqrt(x)
+			Symbol* sym = nullptr;
+			Decl* decl = nullptr;
+			if (_fast_math_find_builtin(e->call.base->symbol, p > 0 ? "sqrt" : "inversesqrt", x->type, 1, sym, decl) == false)
+				return false;
+
+			auto args = mn::buf_with_allocator<Expr*>(e->arena);
+			mn::buf_push(args, x);
+			_fast_math_change_call(e, sym, decl, args, e->type);
+			return true;
+		}
+		return false;
+	}
+
+	// rewrites the given expression into a cheaper one, returns whether the expression has changed
+	inline static bool
+	_fast_math_rewrite(Expr* e)
+	{
+		// constant expressions are handled by constant folding
+		if (e->const_value.type != nullptr)
+			return false;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_BINARY:
+			return _fast_math_reassociate_mat_mul(e) || _fast_math_rewrite_div(e);
+		case Expr::KIND_CALL:
+			return _fast_math_rewrite_pow(e);
+		default:
+			return false;
+		}
+	}
+
+	inline static void
+	_fast_math_expr(Fast_Math& self, Expr* e)
+	{
+		if (e == nullptr)
+			return;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			break;
+		case Expr::KIND_BINARY:
+			_fast_math_expr(self, e->binary.left);
+			_fast_math_expr(self, e->binary.right);
+			break;
+		case Expr::KIND_UNARY:
+			_fast_math_expr(self, e->unary.base);
+			break;
+		case Expr::KIND_CALL:
+			for (auto arg: e->call.args)
+				_fast_math_expr(self, arg);
+			break;
+		case Expr::KIND_CAST:
+			_fast_math_expr(self, e->cast.base);
+			break;
+		case Expr::KIND_DOT:
+			_fast_math_expr(self, e->dot.lhs);
+			break;
+		case Expr::KIND_INDEXED:
+			_fast_math_expr(self, e->indexed.base);
+			_fast_math_expr(self, e->indexed.index);
+			break;
+		case Expr::KIND_COMPLIT:
+			for (const auto& field: e->complit.fields)
+				_fast_math_expr(self, field.value);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+
+		// a rewrite might expose another one, like reassociating a chain of matrix multiplications
+		while (_fast_math_rewrite(e))
+			++self.stats.rewritten_exprs;
+	}
+
+	inline static void
+	_fast_math_stmt(Fast_Math& self, Stmt* s)
+	{
+		if (s == nullptr)
+			return;
+
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+			break;
+		case Stmt::KIND_RETURN:
+			_fast_math_expr(self, s->return_stmt);
+			break;
+		case Stmt::KIND_IF:
+			for (auto cond: s->if_stmt.cond)
+				_fast_math_expr(self, cond);
+			for (auto body: s->if_stmt.body)
+				_fast_math_stmt(self, body);
+			_fast_math_stmt(self, s->if_stmt.else_body);
+			break;
+		case Stmt::KIND_FOR:
+			_fast_math_stmt(self, s->for_stmt.init);
+			_fast_math_expr(self, s->for_stmt.cond);
+			_fast_math_stmt(self, s->for_stmt.post);
+			_fast_math_stmt(self, s->for_stmt.body);
+			break;
+		case Stmt::KIND_ASSIGN:
+			for (size_t i = 0; i < s->assign_stmt.lhs.count; ++i)
+			{
+				_fast_math_expr(self, s->assign_stmt.lhs[i]);
+				_fast_math_expr(self, s->assign_stmt.rhs[i]);
+			}
+			break;
+		case Stmt::KIND_EXPR:
+			_fast_math_expr(self, s->expr_stmt);
+			break;
+		case Stmt::KIND_BLOCK:
+			for (auto stmt: s->block_stmt)
+				_fast_math_stmt(self, stmt);
+			break;
+		case Stmt::KIND_DECL:
+			if (s->decl_stmt->kind == Decl::KIND_VAR)
+				for (auto value: s->decl_stmt->var_decl.values)
+					_fast_math_expr(self, value);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static void
+	_fast_math_func(Fast_Math& self, Decl* d)
+	{
+		_fast_math_stmt(self, d->func_decl.body);
+	}
+
+	// API
+	Fast_Math_Stats
+	fast_math_entry(Entry_Point* entry)
+	{
+		auto self = _fast_math_new();
+		unit_reachable_funcs_walk(entry, nullptr, [&](Decl* d) { _fast_math_func(self, d); });
+		return self.stats;
+	}
+
+	Fast_Math_Stats
+	fast_math_package(Unit_Package* package)
+	{
+		auto self = _fast_math_new();
+		unit_reachable_funcs_walk(nullptr, package, [&](Decl* d) { _fast_math_func(self, d); });
+		return self.stats;
+	}
+}
\ No newline at end of file
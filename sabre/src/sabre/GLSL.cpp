@@ -5,12 +5,15 @@
 #include "sabre/Unit.h"
 #include "sabre/Type_Interner.h"
 #include "sabre/AST.h"
+#include "sabre/Varying.h"
 
 #include <mn/Defer.h>
+#include <mn/Memory_Stream.h>
 #include <mn/Log.h>
 #include <mn/Assert.h>
 
 #include <algorithm>
+#include <cmath>
 
 namespace sabre
 {
@@ -310,7 +313,7 @@ namespace sabre
 	{
 		bool use_raw_name = false;
 
-		const char* res = sym->package_name;
+		const char* res = symbol_package_name(sym);
 		switch (sym->kind)
 		{
 		// in case the function is a builtin function we don't use it's package name
@@ -369,6 +372,16 @@ namespace sabre
 		return res;
 	}
 
+	inline static void
+	_glsl_require_extension(GLSL& self, const char* name)
+	{
+		auto extension = unit_intern(self.unit->parent_unit, name);
+		for (auto it: self.extensions)
+			if (it == extension)
+				return;
+		mn::buf_push(self.extensions, extension);
+	}
+
 	inline static const char*
 	_glsl_tmp_name(GLSL& self)
 	{
@@ -387,9 +400,25 @@ namespace sabre
 		return _glsl_name(self, interned_res);
 	}
 
+	inline static bool
+	_glsl_is_half(Type* type)
+	{
+		return (
+			type == type_half ||
+			(type->kind == Type::KIND_VEC && type->vec.base == type_half) ||
+			(type->kind == Type::KIND_MAT && type->mat.base == type_half)
+		);
+	}
+
 	inline static mn::Str
 	_glsl_write_field(GLSL& self, mn::Str str, Type* type, const char* name)
 	{
+		// half types are written as relaxed precision floats, precision qualifiers are only
+		// allowed in declarations so we don't write them in constructors and casts
+		auto is_declaration = name != nullptr && name[0] != '[';
+		if (is_declaration && _glsl_is_half(type))
+			str = mn::strf(str, "mediump ");
+
 		bool can_write_name = false;
 		switch (type->kind)
 		{
@@ -406,6 +435,7 @@ namespace sabre
 			str = mn::strf(str, "int");
 			break;
 		case Type::KIND_FLOAT:
+		case Type::KIND_HALF:
 			can_write_name = true;
 			str = mn::strf(str, "float");
 			break;
@@ -469,7 +499,7 @@ namespace sabre
 					break;
 				}
 			}
-			else if (type->vec.base == type_float)
+			else if (type->vec.base == type_float || type->vec.base == type_half)
 			{
 				switch(type->vec.width)
 				{
@@ -508,15 +538,15 @@ namespace sabre
 			break;
 		case Type::KIND_MAT:
 			can_write_name = true;
-			if (type == type_mat2)
+			if (type == type_mat2 || type == type_hmat2)
 			{
 				str = mn::strf(str, "mat2");
 			}
-			else if (type == type_mat3)
+			else if (type == type_mat3 || type == type_hmat3)
 			{
 				str = mn::strf(str, "mat3");
 			}
-			else if (type == type_mat4)
+			else if (type == type_mat4 || type == type_hmat4)
 			{
 				str = mn::strf(str, "mat4");
 			}
@@ -599,6 +629,7 @@ namespace sabre
 			break;
 		case Type::KIND_FLOAT:
 		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
 			mn::print_to(self.out, "0.0");
 			break;
 		case Type::KIND_VEC:
@@ -658,6 +689,99 @@ namespace sabre
 		}
 	}
 
+	inline static bool
+	_glsl_can_fold_value(Type* t, Expr_Value v)
+	{
+		switch (t->kind)
+		{
+		case Type::KIND_BOOL:
+			return v.type == type_bool;
+		case Type::KIND_INT:
+		case Type::KIND_UINT:
+		case Type::KIND_FLOAT:
+		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
+		case Type::KIND_ENUM:
+			return v.type == type_int || (v.type == type_double && std::isfinite(v.as_double));
+		case Type::KIND_VEC:
+		{
+			if (v.type == nullptr || type_is_vec(v.type) == false)
+				return false;
+			// vector upcasts store the sub vector as a single component, we don't fold those
+			for (size_t i = 0; i < t->vec.width; ++i)
+				if (_glsl_can_fold_value(t->vec.base, expr_value_aggregate_get(v, i)) == false)
+					return false;
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	inline static void
+	_glsl_folded_value_gen(GLSL& self, Type* t, Expr_Value v)
+	{
+		switch (t->kind)
+		{
+		case Type::KIND_BOOL:
+			mn::print_to(self.out, "{}", v.as_bool ? "true" : "false");
+			break;
+		case Type::KIND_INT:
+		case Type::KIND_ENUM:
+			mn::print_to(self.out, "{}", (int32_t)expr_value_as_int(v));
+			break;
+		case Type::KIND_UINT:
+			mn::print_to(self.out, "{}u", (uint32_t)expr_value_as_int(v));
+			break;
+		case Type::KIND_FLOAT:
+		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
+		{
+			auto str = mn::str_tmpf("{}", expr_value_as_double(v));
+			if (mn::str_find(str, '.', 0) == SIZE_MAX && mn::str_find(str, 'e', 0) == SIZE_MAX)
+				str = mn::strf(str, ".0");
+			if (t->kind == Type::KIND_DOUBLE)
+				str = mn::strf(str, "lf");
+			mn::print_to(self.out, "{}", str);
+			break;
+		}
+		case Type::KIND_VEC:
+			mn::print_to(self.out, "{}(", _glsl_write_field(self, t, nullptr));
+			for (size_t i = 0; i < t->vec.width; ++i)
+			{
+				if (i > 0)
+					mn::print_to(self.out, ", ");
+				_glsl_folded_value_gen(self, t->vec.base, expr_value_aggregate_get(v, i));
+			}
+			mn::print_to(self.out, ")");
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	// constant expressions are emitted as their folded literal value if the fold constants option is set
+	inline static bool
+	_glsl_fold_const_expr(GLSL& self, Expr* e)
+	{
+		if (self.unit->parent_unit->options.fold_constants == false)
+			return false;
+
+		if (e->mode != ADDRESS_MODE_CONST || e->const_value.type == nullptr)
+			return false;
+
+		// literals are already folded, and compound literals are emitted as temporary variables
+		if ((e->kind == Expr::KIND_ATOM && e->atom.tkn.kind != Tkn::KIND_ID) || e->kind == Expr::KIND_COMPLIT)
+			return false;
+
+		if (_glsl_can_fold_value(e->type, e->const_value) == false)
+			return false;
+
+		_glsl_folded_value_gen(self, e->type, e->const_value);
+		return true;
+	}
+
 	inline static void
 	_glsl_gen_atom_expr(GLSL& self, Expr* e)
 	{
@@ -769,6 +893,13 @@ namespace sabre
 	inline static void
 	_glsl_gen_call_expr(GLSL& self, Expr* e)
 	{
+		if (auto func = e->call.func)
+		{
+			if (auto tag = mn::map_lookup(func->tags.table, KEYWORD_BUILTIN))
+				if (auto arg = mn::map_lookup(tag->value.args, KEYWORD_GLSL_EXTENSION))
+					_glsl_require_extension(self, arg->value.value.str);
+		}
+
 		glsl_expr_gen(self, e->call.base);
 		mn::print_to(self.out, "(");
 		for (size_t i = 0; i < e->call.args.count; ++i)
@@ -783,7 +914,7 @@ namespace sabre
 	inline static void
 	_glsl_gen_cast_expr(GLSL& self, Expr* e)
 	{
-		mn::print_to(self.out, "{}(", _glsl_write_field(self, e->type, ""));
+		mn::print_to(self.out, "{}(", _glsl_write_field(self, e->type, nullptr));
 		glsl_expr_gen(self, e->cast.base);
 		mn::print_to(self.out, ")");
 	}
@@ -809,7 +940,8 @@ namespace sabre
 			s->kind == Stmt::KIND_DISCARD ||
 			s->kind == Stmt::KIND_RETURN ||
 			s->kind == Stmt::KIND_ASSIGN ||
-			s->kind == Stmt::KIND_EXPR)
+			s->kind == Stmt::KIND_EXPR ||
+			(s->kind == Stmt::KIND_IF && s->if_stmt.is_select))
 		{
 			return true;
 		}
@@ -860,9 +992,58 @@ namespace sabre
 	inline static void
 	_glsl_gen_block_stmt(GLSL& self, Stmt* s);
 
+	// emits the control flow hints of for and if statements using GL_EXT_control_flow_attributes
+	inline static void
+	_glsl_gen_stmt_tags(GLSL& self, Stmt* s)
+	{
+		const char* attribute = nullptr;
+		if (mn::map_lookup(s->tags.table, KEYWORD_UNROLL))
+			attribute = "unroll";
+		else if (mn::map_lookup(s->tags.table, KEYWORD_LOOP))
+			attribute = "dont_unroll";
+		else if (mn::map_lookup(s->tags.table, KEYWORD_BRANCH))
+			attribute = "dont_flatten";
+		else if (mn::map_lookup(s->tags.table, KEYWORD_FLATTEN))
+			attribute = "flatten";
+
+		if (attribute == nullptr)
+			return;
+
+		_glsl_require_extension(self, "GL_EXT_control_flow_attributes");
+		mn::print_to(self.out, "[[{}]]", attribute);
+		_glsl_newline(self);
+	}
+
+	// emits if statements which were marked by the if conversion pass as conditional assignments
+	// x = c ? a : b, the then branch and the else branch (if it exists) assign the same local variable
+	inline static void
+	_glsl_gen_select_stmt(GLSL& self, Stmt* s)
+	{
+		auto then_assign = s->if_stmt.body[0]->block_stmt[0];
+		auto lhs = then_assign->assign_stmt.lhs[0];
+
+		glsl_expr_gen(self, lhs);
+		mn::print_to(self.out, " = ");
+		glsl_expr_gen(self, s->if_stmt.cond[0]);
+		mn::print_to(self.out, " ? ");
+		glsl_expr_gen(self, then_assign->assign_stmt.rhs[0]);
+		mn::print_to(self.out, " : ");
+		if (s->if_stmt.else_body)
+			glsl_expr_gen(self, s->if_stmt.else_body->block_stmt[0]->assign_stmt.rhs[0]);
+		else
+			glsl_expr_gen(self, lhs);
+	}
+
 	inline static void
 	_glsl_gen_if_stmt(GLSL& self, Stmt* s)
 	{
+		if (s->if_stmt.is_select)
+		{
+			_glsl_gen_select_stmt(self, s);
+			return;
+		}
+
+		_glsl_gen_stmt_tags(self, s);
 		for (size_t i = 0; i < s->if_stmt.body.count; ++i)
 		{
 			if (i > 0)
@@ -881,12 +1062,57 @@ namespace sabre
 		}
 	}
 
+	// checks whether the given for init/post statement can be written in a native for loop header
+	inline static bool
+	_glsl_for_header_stmt_is_simple(Stmt* s, bool allow_decl)
+	{
+		if (s == nullptr)
+			return true;
+
+		switch (s->kind)
+		{
+		case Stmt::KIND_ASSIGN:
+			return (
+				s->assign_stmt.lhs.count == 1 &&
+				expr_has_complit(s->assign_stmt.lhs[0]) == false &&
+				expr_has_complit(s->assign_stmt.rhs[0]) == false
+			);
+		case Stmt::KIND_EXPR:
+			return expr_has_complit(s->expr_stmt) == false;
+		case Stmt::KIND_DECL:
+		{
+			auto d = s->decl_stmt;
+			if (allow_decl == false || d->kind != Decl::KIND_VAR || d->var_decl.names.count != 1)
+				return false;
+			for (auto value: d->var_decl.values)
+				if (expr_has_complit(value))
+					return false;
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
 	inline static void
-	_glsl_gen_for_stmt(GLSL& self, Stmt* s)
+	_glsl_gen_for_body(GLSL& self, Stmt* s)
 	{
-		_glsl_enter_scope(self, unit_scope_find(self.unit->parent_unit, s));
-		mn_defer{_glsl_leave_scope(self);};
+		for (auto stmt: s->for_stmt.body->block_stmt)
+		{
+			_glsl_newline(self);
+			glsl_stmt_gen(self, stmt);
+			if (_glsl_add_semicolon_after(self, stmt))
+			{
+				mn::print_to(self.out, ";");
+			}
+		}
+	}
 
+	// lowers the for loop into a while loop, it's used when the init or post statements can't be written
+	// in the for loop header, we duplicate the post statement at each continue in this case
+	inline static void
+	_glsl_gen_lowered_for_stmt(GLSL& self, Stmt* s)
+	{
 		mn::print_to(self.out, "{{ // for scope");
 		++self.indent;
 
@@ -901,6 +1127,7 @@ namespace sabre
 		}
 
 		_glsl_newline(self);
+		_glsl_gen_stmt_tags(self, s);
 		mn::print_to(self.out, "while (");
 		if (s->for_stmt.cond != nullptr)
 			glsl_expr_gen(self, s->for_stmt.cond);
@@ -912,15 +1139,7 @@ namespace sabre
 		_glsl_newline(self);
 		mn::print_to(self.out, "// for body");
 		_glsl_loop_post_stmt_enter(self, s->for_stmt.post);
-		for (auto stmt: s->for_stmt.body->block_stmt)
-		{
-			_glsl_newline(self);
-			glsl_stmt_gen(self, stmt);
-			if (_glsl_add_semicolon_after(self, stmt))
-			{
-				mn::print_to(self.out, ";");
-			}
-		}
+		_glsl_gen_for_body(self, s);
 		_glsl_loop_post_stmt_leave(self);
 
 		if (s->for_stmt.post != nullptr)
@@ -941,6 +1160,72 @@ namespace sabre
 		mn::print_to(self.out, "}} // for scope");
 	}
 
+	inline static void
+	_glsl_gen_for_stmt(GLSL& self, Stmt* s)
+	{
+		_glsl_enter_scope(self, s->scope);
+		mn_defer{_glsl_leave_scope(self);};
+
+		auto init = s->for_stmt.init;
+		auto post = s->for_stmt.post;
+
+		if (init == nullptr && post == nullptr)
+		{
+			_glsl_gen_stmt_tags(self, s);
+			mn::print_to(self.out, "while (");
+			if (s->for_stmt.cond != nullptr)
+				glsl_expr_gen(self, s->for_stmt.cond);
+			else
+				mn::print_to(self.out, "true");
+			mn::print_to(self.out, ") {{");
+		}
+		else if (_glsl_for_header_stmt_is_simple(init, true) && _glsl_for_header_stmt_is_simple(post, false))
+		{
+			// we emit the canonical for loop form to expose the induction variable to the driver compiler
+			_glsl_gen_stmt_tags(self, s);
+			mn::print_to(self.out, "for (");
+			if (init != nullptr)
+			{
+				glsl_stmt_gen(self, init);
+				if (_glsl_add_semicolon_after(self, init))
+					mn::print_to(self.out, ";");
+			}
+			else
+			{
+				mn::print_to(self.out, ";");
+			}
+
+			if (s->for_stmt.cond != nullptr)
+			{
+				mn::print_to(self.out, " ");
+				glsl_expr_gen(self, s->for_stmt.cond);
+			}
+			mn::print_to(self.out, ";");
+
+			if (post != nullptr)
+			{
+				mn::print_to(self.out, " ");
+				glsl_stmt_gen(self, post);
+			}
+			mn::print_to(self.out, ") {{");
+		}
+		else
+		{
+			_glsl_gen_lowered_for_stmt(self, s);
+			return;
+		}
+
+		++self.indent;
+		// native loops handle the post statement on continue themselves
+		_glsl_loop_post_stmt_enter(self, nullptr);
+		_glsl_gen_for_body(self, s);
+		_glsl_loop_post_stmt_leave(self);
+		--self.indent;
+
+		_glsl_newline(self);
+		mn::print_to(self.out, "}}");
+	}
+
 	inline static void
 	_glsl_assign(GLSL& self, Expr* lhs, const char* op, Expr* rhs)
 	{
@@ -979,7 +1264,7 @@ namespace sabre
 	inline static void
 	_glsl_gen_block_stmt(GLSL& self, Stmt* s)
 	{
-		auto scope = unit_scope_find(self.unit->parent_unit, s);
+		auto scope = s->scope;
 		if (scope)
 			_glsl_enter_scope(self, scope);
 
@@ -1019,7 +1304,7 @@ namespace sabre
 		mn::print_to(self.out, "{} {}(", _glsl_write_field(self, return_type, ""), _glsl_name(self, name));
 
 		if (d->func_decl.body != nullptr)
-			_glsl_enter_scope(self, unit_scope_find(self.unit->parent_unit, d));
+			_glsl_enter_scope(self, d->scope);
 		mn_defer{if (d->func_decl.body) _glsl_leave_scope(self);};
 
 		size_t i = 0;
@@ -1053,6 +1338,18 @@ namespace sabre
 	inline static void
 	_glsl_rewrite_complits_in_expr(GLSL& self, Expr* e, bool is_const);
 
+	// resources outside the per frame set (set 0) are written with their descriptor set for vulkan style output
+	inline static mn::Str
+	_glsl_uniform_layout(Symbol* sym)
+	{
+		if (sym->var_sym.is_push_constant)
+			return mn::str_tmpf("push_constant");
+		else if (sym->var_sym.uniform_set == 0)
+			return mn::str_tmpf("binding = {}", sym->var_sym.uniform_binding);
+		else
+			return mn::str_tmpf("set = {}, binding = {}", sym->var_sym.uniform_set, sym->var_sym.uniform_binding);
+	}
+
 	inline static void
 	_glsl_var_gen(GLSL& self, Symbol* sym, bool in_stmt)
 	{
@@ -1063,24 +1360,44 @@ namespace sabre
 		{
 			auto uniform_name = _glsl_name(self, _glsl_symbol_name(sym));
 			auto uniform_block_name = uniform_name;
-			if (sym->type->kind != Type::KIND_STRUCT)
+			if (type_is_buffer(sym->type))
+			{
+				// the block name can't be the same as the name of its elements array
+				uniform_block_name = _glsl_name(self, mn::str_tmpf("{}_block", uniform_name).ptr);
+			}
+			else if (sym->type->kind != Type::KIND_STRUCT)
 			{
 				uniform_block_name = _glsl_name(self, mn::str_tmpf("uniform{}", _glsl_tmp_name(self)).ptr);
 			}
 
 			if (sym->type->kind == Type::KIND_TEXTURE)
 			{
-				mn::print_to(self.out, "layout(binding = {}) uniform {}", sym->var_sym.uniform_binding, _glsl_write_field(self, sym->type, uniform_name));
+				mn::print_to(self.out, "layout({}) uniform {}", _glsl_uniform_layout(sym), _glsl_write_field(self, sym->type, uniform_name));
+			}
+			else if (type_is_buffer(sym->type))
+			{
+				// buffers are storage blocks with a single runtime sized array of their elements
+				auto access = sym->type->kind == Type::KIND_BUFFER ? "readonly " : "";
+				mn::print_to(self.out, "layout({}, std430) {}buffer {} {{", _glsl_uniform_layout(sym), access, uniform_block_name);
+				++self.indent;
+				{
+					_glsl_newline(self);
+					auto elements_name = mn::str_tmpf("{}[]", uniform_name);
+					mn::print_to(self.out, "{};", _glsl_write_field(self, type_buffer_element(sym->type), elements_name.ptr));
+				}
+				--self.indent;
+				_glsl_newline(self);
+				mn::print_to(self.out, "}}");
 			}
 			else
 			{
-				mn::print_to(self.out, "layout(binding = {}, std140) uniform {} {{", sym->var_sym.uniform_binding, uniform_block_name);
+				mn::print_to(self.out, "layout({}, std140) uniform {} {{", _glsl_uniform_layout(sym), uniform_block_name);
 				++self.indent;
 				{
 					auto type = sym->type;
 					if (type->kind == Type::KIND_STRUCT)
 					{
-						for (auto field: type->struct_type.fields)
+						for (auto field: sym->var_sym.uniform_fields)
 						{
 							_glsl_newline(self);
 							auto name = mn::str_tmpf("{}_{}", uniform_name, field.name.str);
@@ -1100,6 +1417,8 @@ namespace sabre
 		}
 		else
 		{
+			if (sym->var_sym.is_shared)
+				mn::print_to(self.out, "shared ");
 			mn::print_to(self.out, "{}", _glsl_write_field(self, sym->type, _glsl_symbol_name(sym)));
 			if (sym->var_sym.value != nullptr)
 			{
@@ -1571,6 +1890,77 @@ namespace sabre
 		}
 	}
 
+	// returns whether the struct passed from the vertex stage to the pixel stage should be generated using its
+	// varying layout, which is the case when it's packed or when some of its fields were removed by linking
+	inline static bool
+	_glsl_uses_varying_layout(GLSL& self)
+	{
+		return self.unit->parent_unit->options.pack_varyings || self.entry->removed_varyings.count > 0;
+	}
+
+	// declares the vec4 slots and the unpacked locations of the given varying struct, and pushes the name which
+	// each field of the struct is read from or written to into names (removed fields get an empty name),
+	// returns the number of used locations
+	inline static size_t
+	_glsl_generate_varyings(GLSL& self, Type* type, bool is_output, const char* prefix, mn::Buf<mn::Str>& names)
+	{
+		auto direction = is_output ? "out" : "in";
+		auto layout = varying_layout_new(type, self.unit->parent_unit->options.pack_varyings, self.entry->removed_varyings);
+		mn_defer{varying_layout_free(layout);};
+
+		for (size_t i = 0; i < layout.slots_count; ++i)
+		{
+			auto slot_name = mn::str_tmpf("{}_varying{}", prefix, i);
+			mn::print_to(self.out, "layout(location = {}) {} vec4 {};", i, direction, slot_name);
+			_glsl_newline(self);
+		}
+
+		auto decl = symbol_decl(type->struct_type.symbol);
+		size_t field_index = 0;
+		for (const auto& decl_field: decl->struct_decl.fields)
+		{
+			for (size_t i = 0; i < decl_field.names.count; ++i)
+			{
+				const auto& type_field = type->struct_type.fields[field_index];
+				const auto& field = layout.fields[field_index];
+				++field_index;
+
+				switch (field.kind)
+				{
+				case Varying_Field::KIND_BUILTIN:
+					if (mn::map_lookup(decl_field.tags.table, KEYWORD_SV_POSITION) != nullptr)
+						mn::buf_push(names, mn::str_lit(is_output ? "gl_Position" : "gl_FragCoord"));
+					else
+						mn::buf_push(names, mn::str_lit("gl_FragDepth"));
+					break;
+				case Varying_Field::KIND_PACKED:
+					mn::buf_push(names, mn::strf("{}_varying{}.{}", prefix, field.location, varying_field_swizzle(field)));
+					break;
+				case Varying_Field::KIND_UNPACKED:
+				{
+					auto field_name = mn::strf("{}_{}", prefix, type_field.name.str);
+					mn::print_to(self.out, "layout(location = {}) {} {};", field.location, direction, _glsl_write_field(self, type_field.type, field_name.ptr));
+					_glsl_newline(self);
+					mn::buf_push(names, field_name);
+					break;
+				}
+				case Varying_Field::KIND_REMOVED:
+					mn::buf_push(names, mn::Str{});
+					break;
+				default:
+					mn_unreachable();
+					break;
+				}
+			}
+		}
+
+		size_t locations_count = layout.slots_count;
+		for (const auto& field: layout.fields)
+			if (field.kind == Varying_Field::KIND_UNPACKED)
+				++locations_count;
+		return locations_count;
+	}
+
 	inline static void
 	_glsl_generate_vertex_shader_io(GLSL& self, Symbol* entry)
 	{
@@ -1614,6 +2004,14 @@ namespace sabre
 			auto ret_type = entry_type->as_func.sign.return_type;
 			auto output_name = _glsl_name(self, "_entry_point_output");
 
+			if (ret_type->kind == Type::KIND_STRUCT && _glsl_uses_varying_layout(self))
+			{
+				out_location = _glsl_generate_varyings(self, ret_type, true, output_name, self.output_names);
+				if (out_location > 0)
+					_glsl_newline(self);
+				return;
+			}
+
 			switch(ret_type->kind)
 			{
 			case Type::KIND_STRUCT:
@@ -1663,6 +2061,12 @@ namespace sabre
 			{
 				auto input_name = _glsl_name(self, name.str);
 				auto arg_type = entry_type->as_func.sign.args.types[type_index++];
+				if (arg_type->kind == Type::KIND_STRUCT && _glsl_uses_varying_layout(self))
+				{
+					in_location += _glsl_generate_varyings(self, arg_type, false, input_name, self.input_names);
+					continue;
+				}
+
 				switch(arg_type->kind)
 				{
 				case Type::KIND_STRUCT:
@@ -1741,6 +2145,66 @@ namespace sabre
 			_glsl_newline(self);
 	}
 
+	inline static const char*
+	_glsl_compute_system_value_name(const Tag_Table& tags)
+	{
+		if (mn::map_lookup(tags.table, KEYWORD_SV_DISPATCH_THREAD_ID) != nullptr)
+			return "gl_GlobalInvocationID";
+		else if (mn::map_lookup(tags.table, KEYWORD_SV_GROUP_ID) != nullptr)
+			return "gl_WorkGroupID";
+		else if (mn::map_lookup(tags.table, KEYWORD_SV_GROUP_THREAD_ID) != nullptr)
+			return "gl_LocalInvocationID";
+		else if (mn::map_lookup(tags.table, KEYWORD_SV_GROUP_INDEX) != nullptr)
+			return "gl_LocalInvocationIndex";
+		mn_unreachable();
+		return nullptr;
+	}
+
+	inline static void
+	_glsl_generate_compute_shader_io(GLSL& self, Entry_Point* entry)
+	{
+		mn::print_to(
+			self.out,
+			"layout(local_size_x = {}, local_size_y = {}, local_size_z = {}) in;",
+			entry->workgroup_size[0],
+			entry->workgroup_size[1],
+			entry->workgroup_size[2]
+		);
+		_glsl_newline(self);
+		_glsl_newline(self);
+
+		// compute shaders only have system value inputs, so we read the builtin variables directly
+		auto decl = entry->symbol->func_sym.decl;
+		auto entry_type = entry->symbol->type;
+		size_t type_index = 0;
+		for (size_t i = 0; i < decl->func_decl.args.count; ++i)
+		{
+			const auto& arg = decl->func_decl.args[i];
+
+			for (size_t j = 0; j < arg.names.count; ++j)
+			{
+				auto arg_type = entry_type->as_func.sign.args.types[type_index++];
+				switch(arg_type->kind)
+				{
+				case Type::KIND_STRUCT:
+				{
+					auto decl = symbol_decl(arg_type->struct_type.symbol);
+					for (auto field: decl->struct_decl.fields)
+					{
+						auto system_value_name = _glsl_compute_system_value_name(field.tags);
+						for (size_t k = 0; k < field.names.count; ++k)
+							mn::buf_push(self.input_names, mn::str_lit(system_value_name));
+					}
+					break;
+				}
+				default:
+					mn_unreachable();
+					break;
+				}
+			}
+		}
+	}
+
 	inline static void
 	_glsl_generate_main_func(GLSL& self, Symbol* entry)
 	{
@@ -1770,8 +2234,12 @@ namespace sabre
 					{
 						for (const auto& field: arg_type->struct_type.fields)
 						{
+							const auto& input_name = self.input_names[input_index++];
+							// removed varyings are never read
+							if (input_name.count == 0)
+								continue;
 							_glsl_newline(self);
-							mn::print_to(self.out, "{}.{} = {};", arg_name, field.name.str, self.input_names[input_index++]);
+							mn::print_to(self.out, "{}.{} = {};", arg_name, field.name.str, input_name);
 						}
 					}
 					else
@@ -1785,7 +2253,27 @@ namespace sabre
 
 			// handle function return
 			auto return_type = type->as_func.sign.return_type;
-			if (return_type != type_void)
+			if (return_type == type_void)
+			{
+				// entries without outputs (compute shaders) just call the function
+				_glsl_newline(self);
+				_glsl_newline(self);
+
+				mn::print_to(self.out, "{}(", _glsl_symbol_name(entry));
+				size_t arg_index = 0;
+				for (auto arg: decl->func_decl.args)
+				{
+					for (auto name: arg.names)
+					{
+						if (arg_index > 0)
+							mn::print_to(self.out, ", ");
+						mn::print_to(self.out, "{}", _glsl_name(self, name.str));
+						++arg_index;
+					}
+				}
+				mn::print_to(self.out, ");");
+			}
+			else
 			{
 				_glsl_newline(self);
 				_glsl_newline(self);
@@ -1812,8 +2300,12 @@ namespace sabre
 				{
 					for (const auto& field: return_type->struct_type.fields)
 					{
+						const auto& field_output_name = self.output_names[output_index++];
+						// removed varyings are never written
+						if (field_output_name.count == 0)
+							continue;
 						_glsl_newline(self);
-						mn::print_to(self.out, "{} = {}.{};", self.output_names[output_index++], output_name, field.name.str);
+						mn::print_to(self.out, "{} = {}.{};", field_output_name, output_name, field.name.str);
 					}
 				}
 				else
@@ -1828,7 +2320,6 @@ namespace sabre
 		mn::print_to(self.out, "}}");
 	}
 
-
 	// API
 	GLSL
 	glsl_new(Unit_Package* unit, mn::Stream out)
@@ -1863,11 +2354,15 @@ namespace sabre
 		mn::map_free(self.symbol_to_names);
 		destruct(self.input_names);
 		destruct(self.output_names);
+		mn::buf_free(self.extensions);
 	}
 
 	void
 	glsl_expr_gen(GLSL& self, Expr* e)
 	{
+		if (_glsl_fold_const_expr(self, e))
+			return;
+
 		if (e->in_parens)
 			mn::print_to(self.out, "(");
 
@@ -1958,8 +2453,12 @@ namespace sabre
 
 		self.entry = entry;
 
-		mn::print_to(self.out, "#version 450");
-		_glsl_newline(self);
+		// the extensions are only known after the code is generated, so we generate the code into a
+		// separate stream then write it after the version and extension lines
+		auto out = self.out;
+		auto code = mn::memory_stream_new();
+		mn_defer{mn::memory_stream_free(code);};
+		self.out = code;
 
 		switch (entry->mode)
 		{
@@ -1969,6 +2468,9 @@ namespace sabre
 		case COMPILATION_MODE_PIXEL:
 			_glsl_generate_pixel_shader_io(self, entry->symbol);
 			break;
+		case COMPILATION_MODE_COMPUTE:
+			_glsl_generate_compute_shader_io(self, entry);
+			break;
 		case COMPILATION_MODE_LIBRARY:
 			// library mode is not allowed
 		default:
@@ -1992,6 +2494,16 @@ namespace sabre
 		_glsl_newline(self);
 		_glsl_newline(self);
 		_glsl_generate_main_func(self, entry->symbol);
+
+		self.out = out;
+		mn::print_to(self.out, "#version 450");
+		_glsl_newline(self);
+		for (auto extension: self.extensions)
+		{
+			mn::print_to(self.out, "#extension {} : enable", extension);
+			_glsl_newline(self);
+		}
+		mn::print_to(self.out, "{}", code->str);
 	}
 
 	void
@@ -2,10 +2,13 @@
 #include "sabre/AST.h"
 #include "sabre/Type_Interner.h"
 #include "sabre/Unit.h"
+#include "sabre/Varying.h"
 
 #include <mn/Assert.h>
 #include <mn/Defer.h>
 
+#include <cmath>
+
 namespace sabre
 {
 	inline static const char* HLSL_KEYWORDS[] = {
@@ -462,6 +465,7 @@ namespace sabre
 		case Type::KIND_UINT: res_str = mn::str_lit("uint"); break;
 		case Type::KIND_FLOAT: res_str = mn::str_lit("float"); break;
 		case Type::KIND_DOUBLE: res_str = mn::str_lit("double"); break;
+		case Type::KIND_HALF: res_str = mn::str_lit("min16float"); break;
 		case Type::KIND_VEC:
 			res_str = mn::strf(res_str, "{}{}", _hlsl_templated_type_name(self, type->vec.base), type->vec.width);
 			break;
@@ -520,7 +524,7 @@ namespace sabre
 	{
 		bool use_raw_name = false;
 
-		const char* res = sym->package_name;
+		const char* res = symbol_package_name(sym);
 		switch (sym->kind)
 		{
 		case Symbol::KIND_STRUCT_INSTANTIATION:
@@ -647,6 +651,10 @@ namespace sabre
 			can_write_name = true;
 			str = mn::strf(str, "double");
 			break;
+		case Type::KIND_HALF:
+			can_write_name = true;
+			str = mn::strf(str, "min16float");
+			break;
 		case Type::KIND_VEC:
 			can_write_name = true;
 			if (type->vec.base == type_bool)
@@ -739,6 +747,24 @@ namespace sabre
 					break;
 				}
 			}
+			else if (type->vec.base == type_half)
+			{
+				switch(type->vec.width)
+				{
+				case 2:
+					str = mn::strf(str, "min16float2");
+					break;
+				case 3:
+					str = mn::strf(str, "min16float3");
+					break;
+				case 4:
+					str = mn::strf(str, "min16float4");
+					break;
+				default:
+					mn_unreachable();
+					break;
+				}
+			}
 			break;
 		case Type::KIND_MAT:
 			can_write_name = true;
@@ -754,6 +780,18 @@ namespace sabre
 			{
 				str = mn::strf(str, "column_major float4x4");
 			}
+			else if (type == type_hmat2)
+			{
+				str = mn::strf(str, "column_major min16float2x2");
+			}
+			else if (type == type_hmat3)
+			{
+				str = mn::strf(str, "column_major min16float3x3");
+			}
+			else if (type == type_hmat4)
+			{
+				str = mn::strf(str, "column_major min16float4x4");
+			}
 			else
 			{
 				mn_unreachable();
@@ -839,6 +877,18 @@ namespace sabre
 			}
 			str = mn::strf(str, ">");
 			break;
+		case Type::KIND_BUFFER:
+			can_write_name = true;
+			str = mn::strf(str, "StructuredBuffer<");
+			str = _hlsl_write_field(self, str, type_buffer_element(type), "");
+			str = mn::strf(str, ">");
+			break;
+		case Type::KIND_RW_BUFFER:
+			can_write_name = true;
+			str = mn::strf(str, "RWStructuredBuffer<");
+			str = _hlsl_write_field(self, str, type_buffer_element(type), "");
+			str = mn::strf(str, ">");
+			break;
 		case Type::KIND_TYPENAME:
 			mn_unreachable_msg("codegen for typename types is not supported");
 			break;
@@ -878,6 +928,7 @@ namespace sabre
 			break;
 		case Type::KIND_FLOAT:
 		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
 			mn::print_to(self.out, "0.0");
 			break;
 		case Type::KIND_VEC:
@@ -937,6 +988,99 @@ namespace sabre
 		}
 	}
 
+	inline static bool
+	_hlsl_can_fold_value(Type* t, Expr_Value v)
+	{
+		switch (t->kind)
+		{
+		case Type::KIND_BOOL:
+			return v.type == type_bool;
+		case Type::KIND_INT:
+		case Type::KIND_UINT:
+		case Type::KIND_FLOAT:
+		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
+		case Type::KIND_ENUM:
+			return v.type == type_int || (v.type == type_double && std::isfinite(v.as_double));
+		case Type::KIND_VEC:
+		{
+			if (v.type == nullptr || type_is_vec(v.type) == false)
+				return false;
+			// vector upcasts store the sub vector as a single component, we don't fold those
+			for (size_t i = 0; i < t->vec.width; ++i)
+				if (_hlsl_can_fold_value(t->vec.base, expr_value_aggregate_get(v, i)) == false)
+					return false;
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	inline static void
+	_hlsl_folded_value_gen(HLSL& self, Type* t, Expr_Value v)
+	{
+		switch (t->kind)
+		{
+		case Type::KIND_BOOL:
+			mn::print_to(self.out, "{}", v.as_bool ? "true" : "false");
+			break;
+		case Type::KIND_INT:
+		case Type::KIND_ENUM:
+			mn::print_to(self.out, "{}", (int32_t)expr_value_as_int(v));
+			break;
+		case Type::KIND_UINT:
+			mn::print_to(self.out, "{}u", (uint32_t)expr_value_as_int(v));
+			break;
+		case Type::KIND_FLOAT:
+		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
+		{
+			auto str = mn::str_tmpf("{}", expr_value_as_double(v));
+			if (mn::str_find(str, '.', 0) == SIZE_MAX && mn::str_find(str, 'e', 0) == SIZE_MAX)
+				str = mn::strf(str, ".0");
+			if (t->kind == Type::KIND_DOUBLE)
+				str = mn::strf(str, "L");
+			mn::print_to(self.out, "{}", str);
+			break;
+		}
+		case Type::KIND_VEC:
+			mn::print_to(self.out, "{}(", _hlsl_write_field(self, t, nullptr));
+			for (size_t i = 0; i < t->vec.width; ++i)
+			{
+				if (i > 0)
+					mn::print_to(self.out, ", ");
+				_hlsl_folded_value_gen(self, t->vec.base, expr_value_aggregate_get(v, i));
+			}
+			mn::print_to(self.out, ")");
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	// constant expressions are emitted as their folded literal value if the fold constants option is set
+	inline static bool
+	_hlsl_fold_const_expr(HLSL& self, Expr* e)
+	{
+		if (self.unit->parent_unit->options.fold_constants == false)
+			return false;
+
+		if (e->mode != ADDRESS_MODE_CONST || e->const_value.type == nullptr)
+			return false;
+
+		// literals are already folded, and compound literals are emitted as temporary variables
+		if ((e->kind == Expr::KIND_ATOM && e->atom.tkn.kind != Tkn::KIND_ID) || e->kind == Expr::KIND_COMPLIT)
+			return false;
+
+		if (_hlsl_can_fold_value(e->type, e->const_value) == false)
+			return false;
+
+		_hlsl_folded_value_gen(self, e->type, e->const_value);
+		return true;
+	}
+
 	inline static void
 	_hlsl_gen_atom_expr(HLSL& self, Expr* e)
 	{
@@ -1410,7 +1554,8 @@ namespace sabre
 			s->kind == Stmt::KIND_DISCARD ||
 			s->kind == Stmt::KIND_RETURN ||
 			s->kind == Stmt::KIND_ASSIGN ||
-			s->kind == Stmt::KIND_EXPR)
+			s->kind == Stmt::KIND_EXPR ||
+			(s->kind == Stmt::KIND_IF && s->if_stmt.is_select))
 		{
 			return true;
 		}
@@ -1461,7 +1606,7 @@ namespace sabre
 	inline static void
 	_hlsl_gen_block_stmt(HLSL& self, Stmt* s)
 	{
-		auto scope = unit_scope_find(self.unit->parent_unit, s);
+		auto scope = s->scope;
 		if (scope)
 			_hlsl_enter_scope(self, scope);
 
@@ -1486,9 +1631,66 @@ namespace sabre
 			_hlsl_leave_scope(self);
 	}
 
+	// emits the control flow hints of for and if statements as HLSL attributes
+	inline static void
+	_hlsl_gen_stmt_tags(HLSL& self, Stmt* s)
+	{
+		if (auto it = mn::map_lookup(s->tags.table, KEYWORD_UNROLL))
+		{
+			if (auto count_it = mn::map_lookup(it->value.args, KEYWORD_COUNT))
+				mn::print_to(self.out, "[unroll({})]", count_it->value.value.str);
+			else
+				mn::print_to(self.out, "[unroll]");
+		}
+		else if (mn::map_lookup(s->tags.table, KEYWORD_LOOP))
+		{
+			mn::print_to(self.out, "[loop]");
+		}
+		else if (mn::map_lookup(s->tags.table, KEYWORD_BRANCH))
+		{
+			mn::print_to(self.out, "[branch]");
+		}
+		else if (mn::map_lookup(s->tags.table, KEYWORD_FLATTEN))
+		{
+			mn::print_to(self.out, "[flatten]");
+		}
+		else
+		{
+			return;
+		}
+		_hlsl_newline(self);
+	}
+
+	// emits if statements which were marked by the if conversion pass as conditional assignments
+	// x = c ? a : b, the then branch and the else branch (if it exists) assign the same local variable
+	inline static void
+	_hlsl_gen_select_stmt(HLSL& self, Stmt* s)
+	{
+		auto then_assign = s->if_stmt.body[0]->block_stmt[0];
+		auto lhs = then_assign->assign_stmt.lhs[0];
+
+		hlsl_expr_gen(self, lhs);
+		mn::print_to(self.out, " = ");
+		hlsl_expr_gen(self, s->if_stmt.cond[0]);
+		mn::print_to(self.out, " ? ");
+		hlsl_expr_gen(self, then_assign->assign_stmt.rhs[0]);
+		mn::print_to(self.out, " : ");
+		if (s->if_stmt.else_body)
+			hlsl_expr_gen(self, s->if_stmt.else_body->block_stmt[0]->assign_stmt.rhs[0]);
+		else
+			hlsl_expr_gen(self, lhs);
+	}
+
 	inline static void
 	_hlsl_gen_if_stmt(HLSL& self, Stmt* s)
 	{
+		if (s->if_stmt.is_select)
+		{
+			_hlsl_gen_select_stmt(self, s);
+			return;
+		}
+
+		_hlsl_gen_stmt_tags(self, s);
 		for (size_t i = 0; i < s->if_stmt.body.count; ++i)
 		{
 			if (i > 0)
@@ -1507,12 +1709,57 @@ namespace sabre
 		}
 	}
 
+	// checks whether the given for init/post statement can be written in a native for loop header
+	inline static bool
+	_hlsl_for_header_stmt_is_simple(Stmt* s, bool allow_decl)
+	{
+		if (s == nullptr)
+			return true;
+
+		switch (s->kind)
+		{
+		case Stmt::KIND_ASSIGN:
+			return (
+				s->assign_stmt.lhs.count == 1 &&
+				expr_has_complit(s->assign_stmt.lhs[0]) == false &&
+				expr_has_complit(s->assign_stmt.rhs[0]) == false
+			);
+		case Stmt::KIND_EXPR:
+			return expr_has_complit(s->expr_stmt) == false;
+		case Stmt::KIND_DECL:
+		{
+			auto d = s->decl_stmt;
+			if (allow_decl == false || d->kind != Decl::KIND_VAR || d->var_decl.names.count != 1)
+				return false;
+			for (auto value: d->var_decl.values)
+				if (expr_has_complit(value))
+					return false;
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
 	inline static void
-	_hlsl_gen_for_stmt(HLSL& self, Stmt* s)
+	_hlsl_gen_for_body(HLSL& self, Stmt* s)
 	{
-		_hlsl_enter_scope(self, unit_scope_find(self.unit->parent_unit, s));
-		mn_defer{_hlsl_leave_scope(self);};
+		for (auto stmt: s->for_stmt.body->block_stmt)
+		{
+			_hlsl_newline(self);
+			hlsl_stmt_gen(self, stmt);
+			if (_hlsl_add_semicolon_after(self, stmt))
+			{
+				mn::print_to(self.out, ";");
+			}
+		}
+	}
 
+	// lowers the for loop into a while loop, it's used when the init or post statements can't be written
+	// in the for loop header, we duplicate the post statement at each continue in this case
+	inline static void
+	_hlsl_gen_lowered_for_stmt(HLSL& self, Stmt* s)
+	{
 		mn::print_to(self.out, "{{ // for scope");
 		++self.indent;
 
@@ -1527,6 +1774,7 @@ namespace sabre
 		}
 
 		_hlsl_newline(self);
+		_hlsl_gen_stmt_tags(self, s);
 		mn::print_to(self.out, "while (");
 		if (s->for_stmt.cond != nullptr)
 			hlsl_expr_gen(self, s->for_stmt.cond);
@@ -1538,15 +1786,7 @@ namespace sabre
 		_hlsl_newline(self);
 		mn::print_to(self.out, "// for body");
 		_hlsl_loop_post_stmt_enter(self, s->for_stmt.post);
-		for (auto stmt: s->for_stmt.body->block_stmt)
-		{
-			_hlsl_newline(self);
-			hlsl_stmt_gen(self, stmt);
-			if (_hlsl_add_semicolon_after(self, stmt))
-			{
-				mn::print_to(self.out, ";");
-			}
-		}
+		_hlsl_gen_for_body(self, s);
 		_hlsl_loop_post_stmt_leave(self);
 
 		if (s->for_stmt.post != nullptr)
@@ -1567,6 +1807,88 @@ namespace sabre
 		mn::print_to(self.out, "}} // for scope");
 	}
 
+	inline static void
+	_hlsl_gen_for_stmt(HLSL& self, Stmt* s)
+	{
+		_hlsl_enter_scope(self, s->scope);
+		mn_defer{_hlsl_leave_scope(self);};
+
+		auto init = s->for_stmt.init;
+		auto post = s->for_stmt.post;
+		// fxc leaks variables declared in the for loop header into the enclosing scope, so we wrap the loop
+		// in its own scope block to make sibling loops which declare the same variable compile
+		auto scoped = init != nullptr && init->kind == Stmt::KIND_DECL;
+
+		if (init == nullptr && post == nullptr)
+		{
+			_hlsl_gen_stmt_tags(self, s);
+			mn::print_to(self.out, "while (");
+			if (s->for_stmt.cond != nullptr)
+				hlsl_expr_gen(self, s->for_stmt.cond);
+			else
+				mn::print_to(self.out, "true");
+			mn::print_to(self.out, ") {{");
+		}
+		else if (_hlsl_for_header_stmt_is_simple(init, true) && _hlsl_for_header_stmt_is_simple(post, false))
+		{
+			// we emit the canonical for loop form to expose the induction variable to the driver compiler
+			if (scoped)
+			{
+				mn::print_to(self.out, "{{ // for scope");
+				++self.indent;
+				_hlsl_newline(self);
+			}
+			_hlsl_gen_stmt_tags(self, s);
+			mn::print_to(self.out, "for (");
+			if (init != nullptr)
+			{
+				hlsl_stmt_gen(self, init);
+				if (_hlsl_add_semicolon_after(self, init))
+					mn::print_to(self.out, ";");
+			}
+			else
+			{
+				mn::print_to(self.out, ";");
+			}
+
+			if (s->for_stmt.cond != nullptr)
+			{
+				mn::print_to(self.out, " ");
+				hlsl_expr_gen(self, s->for_stmt.cond);
+			}
+			mn::print_to(self.out, ";");
+
+			if (post != nullptr)
+			{
+				mn::print_to(self.out, " ");
+				hlsl_stmt_gen(self, post);
+			}
+			mn::print_to(self.out, ") {{");
+		}
+		else
+		{
+			_hlsl_gen_lowered_for_stmt(self, s);
+			return;
+		}
+
+		++self.indent;
+		// native loops handle the post statement on continue themselves
+		_hlsl_loop_post_stmt_enter(self, nullptr);
+		_hlsl_gen_for_body(self, s);
+		_hlsl_loop_post_stmt_leave(self);
+		--self.indent;
+
+		_hlsl_newline(self);
+		mn::print_to(self.out, "}}");
+
+		if (scoped)
+		{
+			--self.indent;
+			_hlsl_newline(self);
+			mn::print_to(self.out, "}} // for scope");
+		}
+	}
+
 	inline static void
 	_hlsl_assign(HLSL& self, Expr* lhs, const char* op, Expr* rhs)
 	{
@@ -1670,7 +1992,7 @@ namespace sabre
 		}
 
 		if (d->func_decl.body != nullptr)
-			_hlsl_enter_scope(self, unit_scope_find(self.unit->parent_unit, d));
+			_hlsl_enter_scope(self, d->scope);
 		mn_defer{if (d->func_decl.body) _hlsl_leave_scope(self);};
 
 		size_t i = 0;
@@ -1721,6 +2043,19 @@ namespace sabre
 		_hlsl_func_gen_internal(self, sym->as_func_instantiation.decl, sym->type, _hlsl_symbol_name(self, sym));
 	}
 
+	// resources outside the per frame set (space0) are written with their register space, push constants are
+	// root constants at b0 in their own space
+	inline static mn::Str
+	_hlsl_uniform_register(Symbol* sym, char register_class)
+	{
+		if (sym->var_sym.is_push_constant)
+			return mn::str_tmpf("{}0, space{}", register_class, PUSH_CONSTANT_SPACE);
+		else if (sym->var_sym.uniform_set == 0)
+			return mn::str_tmpf("{}{}", register_class, sym->var_sym.uniform_binding);
+		else
+			return mn::str_tmpf("{}{}, space{}", register_class, sym->var_sym.uniform_binding, sym->var_sym.uniform_set);
+	}
+
 	inline static void
 	_hlsl_var_gen(HLSL& self, Symbol* sym, bool in_stmt)
 	{
@@ -1738,21 +2073,26 @@ namespace sabre
 
 			if (sym->type->kind == Type::KIND_TEXTURE)
 			{
-				mn::print_to(self.out, "{}: register(t{})", _hlsl_write_field(self, sym->type, uniform_name), sym->var_sym.uniform_binding);
+				mn::print_to(self.out, "{}: register({})", _hlsl_write_field(self, sym->type, uniform_name), _hlsl_uniform_register(sym, 't'));
 			}
 			else if (type_is_sampler(sym->type))
 			{
-				mn::print_to(self.out, "{}: register(s{})", _hlsl_write_field(self, sym->type, uniform_name), sym->var_sym.uniform_binding);
+				mn::print_to(self.out, "{}: register({})", _hlsl_write_field(self, sym->type, uniform_name), _hlsl_uniform_register(sym, 's'));
+			}
+			else if (type_is_buffer(sym->type))
+			{
+				auto register_class = sym->type->kind == Type::KIND_BUFFER ? 't' : 'u';
+				mn::print_to(self.out, "{}: register({})", _hlsl_write_field(self, sym->type, uniform_name), _hlsl_uniform_register(sym, register_class));
 			}
 			else
 			{
-				mn::print_to(self.out, "cbuffer {}: register(b{}) {{", uniform_block_name, sym->var_sym.uniform_binding);
+				mn::print_to(self.out, "cbuffer {}: register({}) {{", uniform_block_name, _hlsl_uniform_register(sym, 'b'));
 				++self.indent;
 				{
 					auto type = sym->type;
 					if (type->kind == Type::KIND_STRUCT)
 					{
-						for (auto field: type->struct_type.fields)
+						for (auto field: sym->var_sym.uniform_fields)
 						{
 							_hlsl_newline(self);
 							auto name = mn::str_tmpf("{}_{}", uniform_name, field.name.str);
@@ -1796,6 +2136,8 @@ namespace sabre
 		}
 		else
 		{
+			if (sym->var_sym.is_shared)
+				mn::print_to(self.out, "groupshared ");
 			mn::print_to(self.out, "{}", _hlsl_write_field(self, sym->type, _hlsl_symbol_name(self, sym)));
 			if (sym->var_sym.value != nullptr)
 			{
@@ -1830,6 +2172,20 @@ namespace sabre
 		mn::print_to(self.out, ";");
 	}
 
+	inline static const char*
+	_hlsl_compute_system_value_semantic(const Tag_Table& tags)
+	{
+		if (mn::map_lookup(tags.table, KEYWORD_SV_DISPATCH_THREAD_ID) != nullptr)
+			return "SV_DispatchThreadID";
+		else if (mn::map_lookup(tags.table, KEYWORD_SV_GROUP_ID) != nullptr)
+			return "SV_GroupID";
+		else if (mn::map_lookup(tags.table, KEYWORD_SV_GROUP_THREAD_ID) != nullptr)
+			return "SV_GroupThreadID";
+		else if (mn::map_lookup(tags.table, KEYWORD_SV_GROUP_INDEX) != nullptr)
+			return "SV_GroupIndex";
+		return nullptr;
+	}
+
 	inline static void
 	_hlsl_struct_gen_internal(HLSL& self, Symbol* sym, Decl* decl)
 	{
@@ -1862,6 +2218,10 @@ namespace sabre
 					{
 						mn::print_to(self.out, ": SV_DEPTH");
 					}
+					else if (auto semantic = _hlsl_compute_system_value_semantic(field.tags))
+					{
+						mn::print_to(self.out, ": {}", semantic);
+					}
 					else if (io_flags_it->value == ENTRY_IO_FLAG_PIXEL_OUT)
 					{
 						mn::print_to(self.out, ": SV_TARGET{}", i);
@@ -2013,6 +2373,20 @@ namespace sabre
 		}
 	}
 
+	// returns whether the struct passed from the vertex stage to the pixel stage should be generated using its
+	// varying layout, which is the case when it's packed or when some of its fields were removed by linking
+	inline static bool
+	_hlsl_uses_varying_layout(HLSL& self)
+	{
+		return self.unit->parent_unit->options.pack_varyings || self.entry->removed_varyings.count > 0;
+	}
+
+	inline static Varying_Layout
+	_hlsl_varying_layout(HLSL& self)
+	{
+		return varying_layout_new(self.varyings_type, self.unit->parent_unit->options.pack_varyings, self.entry->removed_varyings);
+	}
+
 	inline static void
 	_hlsl_generate_vertex_shader_io(HLSL& self, Symbol* entry)
 	{
@@ -2044,7 +2418,9 @@ namespace sabre
 		if (entry_type->as_func.sign.return_type != type_void)
 		{
 			auto ret_type = entry_type->as_func.sign.return_type;
-			if (auto sym = type_symbol(ret_type))
+			if (ret_type->kind == Type::KIND_STRUCT && _hlsl_uses_varying_layout(self))
+				self.varyings_type = ret_type;
+			else if (auto sym = type_symbol(ret_type))
 				mn::map_insert(self.io_structs, sym, ENTRY_IO_FLAG_NONE);
 		}
 
@@ -2070,7 +2446,10 @@ namespace sabre
 				switch(arg_type->kind)
 				{
 				case Type::KIND_STRUCT:
-					mn::map_insert(self.io_structs, arg_type->struct_type.symbol, ENTRY_IO_FLAG_NONE);
+					if (_hlsl_uses_varying_layout(self))
+						self.varyings_type = arg_type;
+					else
+						mn::map_insert(self.io_structs, arg_type->struct_type.symbol, ENTRY_IO_FLAG_NONE);
 					break;
 				default:
 					mn_unreachable();
@@ -2147,6 +2526,128 @@ namespace sabre
 			_hlsl_newline(self);
 	}
 
+	inline static void
+	_hlsl_generate_compute_shader_io(HLSL& self, Symbol* entry)
+	{
+		auto decl = entry->func_sym.decl;
+		auto entry_type = entry->type;
+		size_t type_index = 0;
+		// inputs are system values, their semantics are generated along with the struct
+		for (size_t i = 0; i < decl->func_decl.args.count; ++i)
+		{
+			const auto& arg = decl->func_decl.args[i];
+
+			for (size_t j = 0; j < arg.names.count; ++j)
+			{
+				auto arg_type = entry_type->as_func.sign.args.types[type_index++];
+				switch(arg_type->kind)
+				{
+				case Type::KIND_STRUCT:
+					mn::map_insert(self.io_structs, arg_type->struct_type.symbol, ENTRY_IO_FLAG_NONE);
+					break;
+				default:
+					mn_unreachable();
+					break;
+				}
+			}
+		}
+	}
+
+	inline static mn::Str
+	_hlsl_varyings_struct_name(HLSL& self)
+	{
+		if (self.unit->parent_unit->options.pack_varyings)
+			return mn::str_tmpf("{}_packed", _hlsl_write_field(self, self.varyings_type, ""));
+		else
+			return mn::str_tmpf("{}_linked", _hlsl_write_field(self, self.varyings_type, ""));
+	}
+
+	// generates the struct which follows the varying layout, it's what the vertex stage returns and what the
+	// pixel stage reads instead of the varyings struct
+	inline static void
+	_hlsl_generate_varyings_struct(HLSL& self)
+	{
+		auto type = self.varyings_type;
+		auto layout = _hlsl_varying_layout(self);
+		mn_defer{varying_layout_free(layout);};
+
+		mn::print_to(self.out, "struct {} {{", _hlsl_varyings_struct_name(self));
+		++self.indent;
+
+		auto decl = symbol_decl(type->struct_type.symbol);
+		size_t field_index = 0;
+		for (const auto& decl_field: decl->struct_decl.fields)
+		{
+			for (size_t i = 0; i < decl_field.names.count; ++i)
+			{
+				const auto& type_field = type->struct_type.fields[field_index];
+				const auto& field = layout.fields[field_index];
+				++field_index;
+
+				if (field.kind != Varying_Field::KIND_BUILTIN)
+					continue;
+
+				_hlsl_newline(self);
+				mn::print_to(self.out, "{}", _hlsl_write_field(self, type_field.type, type_field.name.str));
+				if (mn::map_lookup(decl_field.tags.table, KEYWORD_SV_POSITION) != nullptr)
+					mn::print_to(self.out, ": SV_POSITION;");
+				else
+					mn::print_to(self.out, ": SV_DEPTH;");
+			}
+		}
+
+		for (size_t i = 0; i < layout.slots_count; ++i)
+		{
+			_hlsl_newline(self);
+			mn::print_to(self.out, "float4 varying{}: TEXCOORD{};", i, i);
+		}
+
+		for (size_t i = 0; i < layout.fields.count; ++i)
+		{
+			const auto& field = layout.fields[i];
+			if (field.kind != Varying_Field::KIND_UNPACKED)
+				continue;
+
+			const auto& type_field = type->struct_type.fields[i];
+			_hlsl_newline(self);
+			mn::print_to(self.out, "{}: TEXCOORD{};", _hlsl_write_field(self, type_field.type, type_field.name.str), field.location);
+		}
+
+		--self.indent;
+		_hlsl_newline(self);
+		mn::print_to(self.out, "}};");
+	}
+
+	// copies the fields between the varyings struct and the generated struct, packed fields are read from and
+	// written to their slots, and removed fields are skipped
+	inline static void
+	_hlsl_copy_varyings(HLSL& self, const char* varyings_name, const char* packed_name, bool to_packed)
+	{
+		auto type = self.varyings_type;
+		auto layout = _hlsl_varying_layout(self);
+		mn_defer{varying_layout_free(layout);};
+
+		for (size_t i = 0; i < layout.fields.count; ++i)
+		{
+			const auto& field = layout.fields[i];
+			if (field.kind == Varying_Field::KIND_REMOVED)
+				continue;
+
+			auto field_name = _hlsl_name(self, type->struct_type.fields[i].name.str);
+
+			auto varying = mn::str_tmpf("{}.{}", varyings_name, field_name);
+			auto packed = mn::str_tmpf("{}.{}", packed_name, field_name);
+			if (field.kind == Varying_Field::KIND_PACKED)
+				packed = mn::str_tmpf("{}.varying{}.{}", packed_name, field.location, varying_field_swizzle(field));
+
+			_hlsl_newline(self);
+			if (to_packed)
+				mn::print_to(self.out, "{} = {};", packed, varying);
+			else
+				mn::print_to(self.out, "{} = {};", varying, packed);
+		}
+	}
+
 	inline static void
 	_hlsl_generate_main_func(HLSL& self, Symbol* entry)
 	{
@@ -2161,11 +2662,29 @@ namespace sabre
 			mn::print_to(self.out, "[maxvertexcount({})]", geometry_max_vertex_count->value.value.str);
 			_hlsl_newline(self);
 		}
+		else if (self.entry->mode == COMPILATION_MODE_COMPUTE)
+		{
+			mn::print_to(
+				self.out,
+				"[numthreads({}, {}, {})]",
+				self.entry->workgroup_size[0],
+				self.entry->workgroup_size[1],
+				self.entry->workgroup_size[2]
+			);
+			_hlsl_newline(self);
+		}
+
+		// with varying packing (or linking) the vertex stage returns the generated struct and the pixel stage reads it
+		bool pack_output = self.varyings_type != nullptr && self.entry->mode == COMPILATION_MODE_VERTEX;
+		bool unpack_input = self.varyings_type != nullptr && self.entry->mode == COMPILATION_MODE_PIXEL;
 
-		mn::print_to(self.out, "{} main(", _hlsl_write_field(self, return_type, ""));
+		if (pack_output)
+			mn::print_to(self.out, "{} main(", _hlsl_varyings_struct_name(self));
+		else
+			mn::print_to(self.out, "{} main(", _hlsl_write_field(self, return_type, ""));
 
 		if (d->func_decl.body != nullptr)
-			_hlsl_enter_scope(self, unit_scope_find(self.unit->parent_unit, d));
+			_hlsl_enter_scope(self, d->scope);
 		mn_defer{if (d->func_decl.body) _hlsl_leave_scope(self);};
 
 		size_t i = 0;
@@ -2191,7 +2710,10 @@ namespace sabre
 				else if (mn::map_lookup(arg.tags.table, KEYWORD_INOUT))
 					mn::print_to(self.out, "inout ");
 
-				mn::print_to(self.out, "{}", _hlsl_write_field(self, arg_type, name.str));
+				if (unpack_input && arg_type == self.varyings_type)
+					mn::print_to(self.out, "{} {}", _hlsl_varyings_struct_name(self), _hlsl_name(self, name.str));
+				else
+					mn::print_to(self.out, "{}", _hlsl_write_field(self, arg_type, name.str));
 				++i;
 			}
 		}
@@ -2201,27 +2723,64 @@ namespace sabre
 		mn::print_to(self.out, "{{");
 		++self.indent;
 
-		_hlsl_newline(self);
-		if (return_type && return_type != type_void)
-		{
-			mn::print_to(self.out, "return ");
-		}
-
-		mn::print_to(self.out, "{}(", _hlsl_name(self, _hlsl_symbol_name(self, entry)));
+		// unpack the varyings into the struct which the entry point expects
+		auto arg_names = mn::buf_with_allocator<const char*>(mn::memory::tmp());
 		i = 0;
 		for (auto arg: d->func_decl.args)
 		{
 			auto arg_type = t->as_func.sign.args.types[i];
 			for (auto name: arg.names)
 			{
-				if (i > 0)
-					mn::print_to(self.out, ", ");
-				mn::print_to(self.out, "{}", name.str);
+				auto arg_name = name.str;
+				if (unpack_input && arg_type == self.varyings_type)
+				{
+					arg_name = _hlsl_tmp_name(self);
+					_hlsl_newline(self);
+					// removed fields are never read, but we zero them so the struct is fully initialized
+					if (self.entry->removed_varyings.count > 0)
+						mn::print_to(self.out, "{} = ({})0;", _hlsl_write_field(self, arg_type, arg_name), _hlsl_write_field(self, arg_type, ""));
+					else
+						mn::print_to(self.out, "{};", _hlsl_write_field(self, arg_type, arg_name));
+					_hlsl_copy_varyings(self, arg_name, _hlsl_name(self, name.str), false);
+				}
+				mn::buf_push(arg_names, arg_name);
 				++i;
 			}
 		}
+
+		const char* output_name = nullptr;
+		_hlsl_newline(self);
+		if (pack_output)
+		{
+			output_name = _hlsl_tmp_name(self);
+			mn::print_to(self.out, "{} = ", _hlsl_write_field(self, return_type, output_name));
+		}
+		else if (return_type && return_type != type_void)
+		{
+			mn::print_to(self.out, "return ");
+		}
+
+		mn::print_to(self.out, "{}(", _hlsl_name(self, _hlsl_symbol_name(self, entry)));
+		for (size_t j = 0; j < arg_names.count; ++j)
+		{
+			if (j > 0)
+				mn::print_to(self.out, ", ");
+			mn::print_to(self.out, "{}", arg_names[j]);
+		}
 		mn::print_to(self.out, ");");
 
+		// pack the varyings which the entry point returned
+		if (pack_output)
+		{
+			auto packed_name = _hlsl_tmp_name(self);
+			auto packed_type_name = _hlsl_varyings_struct_name(self);
+			_hlsl_newline(self);
+			mn::print_to(self.out, "{} {} = ({})0;", packed_type_name, packed_name, packed_type_name);
+			_hlsl_copy_varyings(self, output_name, packed_name, true);
+			_hlsl_newline(self);
+			mn::print_to(self.out, "return {};", packed_name);
+		}
+
 		--self.indent;
 		_hlsl_newline(self);
 		mn::print_to(self.out, "}}");
@@ -2266,6 +2825,9 @@ namespace sabre
 	void
 	hlsl_expr_gen(HLSL& self, Expr* e)
 	{
+		if (_hlsl_fold_const_expr(self, e))
+			return;
+
 		if (e->in_parens)
 			mn::print_to(self.out, "(");
 
@@ -2367,6 +2929,9 @@ namespace sabre
 		case COMPILATION_MODE_GEOMETRY:
 			_hlsl_generate_geometry_shader_io(self, entry->symbol);
 			break;
+		case COMPILATION_MODE_COMPUTE:
+			_hlsl_generate_compute_shader_io(self, entry->symbol);
+			break;
 		case COMPILATION_MODE_LIBRARY:
 			// library mode is not allowed
 		default:
@@ -2386,6 +2951,13 @@ namespace sabre
 			last_symbol_was_generated = _hlsl_code_generated_after(self, pos);
 		}
 
+		if (self.varyings_type)
+		{
+			_hlsl_newline(self);
+			_hlsl_newline(self);
+			_hlsl_generate_varyings_struct(self);
+		}
+
 		// generate real entry function
 		_hlsl_newline(self);
 		_hlsl_newline(self);
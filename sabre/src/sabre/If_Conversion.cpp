@@ -0,0 +1,234 @@
+#include "sabre/If_Conversion.h"
+#include "sabre/Unit.h"
+#include "sabre/AST.h"
+#include "sabre/Scope.h"
+#include "sabre/Type_Interner.h"
+
+#include <mn/Buf.h>
+#include <mn/Map.h>
+#include <mn/Memory.h>
+#include <mn/Assert.h>
+
+namespace sabre
+{
+	// both sides of the converted if statement are evaluated, so we only convert the if statements which
+	// cost less than this (roughly the number of operations in the assigned values)
+	constexpr size_t IF_CONVERSION_COST_THRESHOLD = 8;
+
+	// cost of a pure builtin call compared to a single arithmetic operation
+	constexpr size_t IF_CONVERSION_CALL_COST = 4;
+
+	struct If_Conversion
+	{
+		If_Conversion_Stats stats;
+	};
+
+	inline static If_Conversion
+	_if_conversion_new()
+	{
+		If_Conversion self{};
+		return self;
+	}
+
+	inline static size_t
+	_if_conversion_add_cost(size_t a, size_t b)
+	{
+		if (a == SIZE_MAX || b == SIZE_MAX)
+			return SIZE_MAX;
+		return a + b;
+	}
+
+	// returns the cost of evaluating the given expression, or SIZE_MAX if it should never be evaluated
+	// unconditionally (texture samples for example)
+	inline static size_t
+	_if_conversion_expr_cost(const Expr* e)
+	{
+		if (e == nullptr)
+			return 0;
+
+		// constants are emitted as is
+		if (e->const_value.type != nullptr)
+			return 0;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return 0;
+		case Expr::KIND_BINARY:
+			return _if_conversion_add_cost(1, _if_conversion_add_cost(_if_conversion_expr_cost(e->binary.left), _if_conversion_expr_cost(e->binary.right)));
+		case Expr::KIND_UNARY:
+			return _if_conversion_add_cost(1, _if_conversion_expr_cost(e->unary.base));
+		case Expr::KIND_CALL:
+		{
+			// texture samples are expensive, and they need the derivatives which might not be valid in the other branch
+			if (e->call.func == nullptr || mn::map_lookup(e->call.func->tags.table, KEYWORD_SAMPLE_FUNC))
+				return SIZE_MAX;
+
+			// subgroup operations depend on which invocations are active, so they can't leave their branch
+			if (mn::map_lookup(e->call.func->tags.table, KEYWORD_SUBGROUP))
+				return SIZE_MAX;
+
+			size_t res = IF_CONVERSION_CALL_COST;
+			for (auto arg: e->call.args)
+				res = _if_conversion_add_cost(res, _if_conversion_expr_cost(arg));
+			return res;
+		}
+		case Expr::KIND_CAST:
+			return _if_conversion_add_cost(1, _if_conversion_expr_cost(e->cast.base));
+		case Expr::KIND_DOT:
+			return _if_conversion_expr_cost(e->dot.lhs);
+		case Expr::KIND_INDEXED:
+			// buffer loads might be out of range in the branch which isn't taken
+			if (type_is_buffer(e->indexed.base->type))
+				return SIZE_MAX;
+			return _if_conversion_add_cost(1, _if_conversion_add_cost(_if_conversion_expr_cost(e->indexed.base), _if_conversion_expr_cost(e->indexed.index)));
+		case Expr::KIND_COMPLIT:
+			return SIZE_MAX;
+		default:
+			mn_unreachable();
+			return SIZE_MAX;
+		}
+	}
+
+	// checks whether the given type can be selected with the ternary operator in all the backends, HLSL
+	// doesn't support it for structs and GLSL doesn't support it for arrays
+	inline static bool
+	_if_conversion_type_is_selectable(Type* t)
+	{
+		switch (t->kind)
+		{
+		case Type::KIND_BOOL:
+		case Type::KIND_INT:
+		case Type::KIND_UINT:
+		case Type::KIND_FLOAT:
+		case Type::KIND_DOUBLE:
+		case Type::KIND_HALF:
+		case Type::KIND_ENUM:
+		case Type::KIND_VEC:
+		case Type::KIND_MAT:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// returns the assignment statement if the given block consists of a single plain assignment to a local variable
+	inline static Stmt*
+	_if_conversion_single_assign(Stmt* block)
+	{
+		if (block == nullptr || block->kind != Stmt::KIND_BLOCK || block->block_stmt.count != 1)
+			return nullptr;
+
+		auto s = block->block_stmt[0];
+		if (s->kind != Stmt::KIND_ASSIGN || s->assign_stmt.op.kind != Tkn::KIND_EQUAL || s->assign_stmt.lhs.count != 1)
+			return nullptr;
+
+		auto lhs = s->assign_stmt.lhs[0];
+		if (lhs->kind != Expr::KIND_ATOM || lhs->symbol == nullptr)
+			return nullptr;
+
+		if (lhs->symbol->kind != Symbol::KIND_VAR || lhs->symbol->is_top_level)
+			return nullptr;
+
+		if (_if_conversion_type_is_selectable(lhs->type) == false)
+			return nullptr;
+
+		if (expr_is_pure(s->assign_stmt.rhs[0]) == false)
+			return nullptr;
+
+		return s;
+	}
+
+	// checks whether the given if statement is a small diamond which assigns the same local variable
+	// in both of its branches (or only in the then branch)
+	inline static bool
+	_if_conversion_can_convert(Stmt* s)
+	{
+		// @branch forces a real branch
+		if (mn::map_lookup(s->tags.table, KEYWORD_BRANCH))
+			return false;
+
+		// else if chains are not converted
+		if (s->if_stmt.cond.count != 1 || s->if_stmt.body.count != 1)
+			return false;
+
+		if (s->if_stmt.cond[0]->type != type_bool || expr_has_side_effects(s->if_stmt.cond[0]))
+			return false;
+
+		auto then_assign = _if_conversion_single_assign(s->if_stmt.body[0]);
+		if (then_assign == nullptr)
+			return false;
+
+		auto target = then_assign->assign_stmt.lhs[0]->symbol;
+		auto cost = _if_conversion_expr_cost(then_assign->assign_stmt.rhs[0]);
+
+		if (s->if_stmt.else_body)
+		{
+			auto else_assign = _if_conversion_single_assign(s->if_stmt.else_body);
+			if (else_assign == nullptr || else_assign->assign_stmt.lhs[0]->symbol != target)
+				return false;
+
+			cost = _if_conversion_add_cost(cost, _if_conversion_expr_cost(else_assign->assign_stmt.rhs[0]));
+		}
+
+		return cost <= IF_CONVERSION_COST_THRESHOLD;
+	}
+
+	inline static void
+	_if_conversion_stmt(If_Conversion& self, Stmt* s)
+	{
+		if (s == nullptr)
+			return;
+
+		switch (s->kind)
+		{
+		case Stmt::KIND_IF:
+			if (s->if_stmt.is_select)
+				break;
+
+			if (_if_conversion_can_convert(s))
+			{
+				s->if_stmt.is_select = true;
+				++self.stats.converted_ifs;
+				break;
+			}
+
+			for (auto body: s->if_stmt.body)
+				_if_conversion_stmt(self, body);
+			_if_conversion_stmt(self, s->if_stmt.else_body);
+			break;
+		case Stmt::KIND_FOR:
+			_if_conversion_stmt(self, s->for_stmt.body);
+			break;
+		case Stmt::KIND_BLOCK:
+			for (auto stmt: s->block_stmt)
+				_if_conversion_stmt(self, stmt);
+			break;
+		default:
+			break;
+		}
+	}
+
+	inline static void
+	_if_conversion_func(If_Conversion& self, Decl* d)
+	{
+		_if_conversion_stmt(self, d->func_decl.body);
+	}
+
+	// API
+	If_Conversion_Stats
+	if_conversion_entry(Entry_Point* entry)
+	{
+		auto self = _if_conversion_new();
+		unit_reachable_funcs_walk(entry, nullptr, [&](Decl* d) { _if_conversion_func(self, d); });
+		return self.stats;
+	}
+
+	If_Conversion_Stats
+	if_conversion_package(Unit_Package* package)
+	{
+		auto self = _if_conversion_new();
+		unit_reachable_funcs_walk(nullptr, package, [&](Decl* d) { _if_conversion_func(self, d); });
+		return self.stats;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,834 @@
+#include "sabre/Inline.h"
+#include "sabre/Unit.h"
+#include "sabre/AST.h"
+#include "sabre/Scope.h"
+#include "sabre/Type_Interner.h"
+
+#include <mn/Buf.h>
+#include <mn/Map.h>
+#include <mn/Memory.h>
+#include <mn/Defer.h>
+#include <mn/Assert.h>
+
+namespace sabre
+{
+	// functions which cost more than this (roughly the number of AST nodes in their body) are only
+	// inlined if they're tagged with @inline
+	constexpr size_t INLINE_COST_THRESHOLD = 16;
+
+	struct Inline
+	{
+		Inline_Stats stats;
+		mn::Buf<Scope*> scope_stack;
+		// functions which we have already processed, and the ones which we're processing right now
+		mn::Buf<Decl*> funcs;
+		mn::Set<Decl*> visited_funcs;
+		mn::Set<Decl*> visiting_funcs;
+		// whether the function can be inlined, it's calculated after the function itself is processed
+		mn::Map<Decl*, bool> inlinable_funcs;
+		// functions which were inlined at least once
+		mn::Set<Decl*> inlined_funcs;
+		size_t inline_id;
+	};
+
+	inline static Inline
+	_inline_new()
+	{
+		Inline self{};
+		self.scope_stack = mn::buf_with_allocator<Scope*>(mn::memory::tmp());
+		self.funcs = mn::buf_with_allocator<Decl*>(mn::memory::tmp());
+		self.visited_funcs = mn::set_with_allocator<Decl*>(mn::memory::tmp());
+		self.visiting_funcs = mn::set_with_allocator<Decl*>(mn::memory::tmp());
+		self.inlinable_funcs = mn::map_with_allocator<Decl*, bool>(mn::memory::tmp());
+		self.inlined_funcs = mn::set_with_allocator<Decl*>(mn::memory::tmp());
+		return self;
+	}
+
+	inline static void
+	_inline_enter_scope(Inline& self, Scope* scope)
+	{
+		if (scope)
+			mn::buf_push(self.scope_stack, scope);
+	}
+
+	inline static void
+	_inline_leave_scope(Inline& self, Scope* scope)
+	{
+		if (scope)
+			mn::buf_pop(self.scope_stack);
+	}
+
+	inline static Scope*
+	_inline_current_scope(Inline& self)
+	{
+		return mn::buf_top(self.scope_stack);
+	}
+
+	// scope which contains the local variables of the given function body
+	inline static Scope*
+	_inline_func_body_scope(Decl* d)
+	{
+		if (d->func_decl.body->scope)
+			return d->func_decl.body->scope;
+		return d->scope;
+	}
+
+	// returns whether the given symbol is an argument or a local variable of the given function
+	inline static bool
+	_inline_is_local(Decl* d, Symbol* sym)
+	{
+		if (sym == nullptr || sym->scope == nullptr)
+			return false;
+		return sym->scope == d->scope || sym->scope == d->func_decl.body->scope;
+	}
+
+	inline static size_t
+	_inline_expr_cost(const Expr* e)
+	{
+		if (e == nullptr)
+			return 0;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return 1;
+		case Expr::KIND_BINARY:
+			return 1 + _inline_expr_cost(e->binary.left) + _inline_expr_cost(e->binary.right);
+		case Expr::KIND_UNARY:
+			return 1 + _inline_expr_cost(e->unary.base);
+		case Expr::KIND_CALL:
+		{
+			size_t res = 1;
+			for (auto arg: e->call.args)
+				res += _inline_expr_cost(arg);
+			return res;
+		}
+		case Expr::KIND_CAST:
+			return 1 + _inline_expr_cost(e->cast.base);
+		case Expr::KIND_DOT:
+			return 1 + _inline_expr_cost(e->dot.lhs);
+		case Expr::KIND_INDEXED:
+			return 1 + _inline_expr_cost(e->indexed.base) + _inline_expr_cost(e->indexed.index);
+		case Expr::KIND_COMPLIT:
+		{
+			size_t res = 1;
+			for (const auto& field: e->complit.fields)
+				res += _inline_expr_cost(field.value);
+			return res;
+		}
+		default:
+			mn_unreachable();
+			return 0;
+		}
+	}
+
+	inline static size_t
+	_inline_expr_use_count(const Expr* e, Symbol* sym)
+	{
+		if (e == nullptr)
+			return 0;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return e->symbol == sym ? 1 : 0;
+		case Expr::KIND_BINARY:
+			return _inline_expr_use_count(e->binary.left, sym) + _inline_expr_use_count(e->binary.right, sym);
+		case Expr::KIND_UNARY:
+			return _inline_expr_use_count(e->unary.base, sym);
+		case Expr::KIND_CALL:
+		{
+			size_t res = 0;
+			for (auto arg: e->call.args)
+				res += _inline_expr_use_count(arg, sym);
+			return res;
+		}
+		case Expr::KIND_CAST:
+			return _inline_expr_use_count(e->cast.base, sym);
+		case Expr::KIND_DOT:
+			return _inline_expr_use_count(e->dot.lhs, sym);
+		case Expr::KIND_INDEXED:
+			return _inline_expr_use_count(e->indexed.base, sym) + _inline_expr_use_count(e->indexed.index, sym);
+		case Expr::KIND_COMPLIT:
+		{
+			size_t res = 0;
+			for (const auto& field: e->complit.fields)
+				res += _inline_expr_use_count(field.value, sym);
+			return res;
+		}
+		default:
+			mn_unreachable();
+			return 0;
+		}
+	}
+
+	// number of times the given argument is used in the body of an inlinable function
+	inline static size_t
+	_inline_func_use_count(Decl* d, Symbol* sym)
+	{
+		size_t res = 0;
+		for (auto s: d->func_decl.body->block_stmt)
+		{
+			switch (s->kind)
+			{
+			case Stmt::KIND_RETURN:
+				res += _inline_expr_use_count(s->return_stmt, sym);
+				break;
+			case Stmt::KIND_DECL:
+				for (auto value: s->decl_stmt->var_decl.values)
+					res += _inline_expr_use_count(value, sym);
+				break;
+			case Stmt::KIND_ASSIGN:
+				for (size_t i = 0; i < s->assign_stmt.lhs.count; ++i)
+				{
+					res += _inline_expr_use_count(s->assign_stmt.lhs[i], sym);
+					res += _inline_expr_use_count(s->assign_stmt.rhs[i], sym);
+				}
+				break;
+			default:
+				mn_unreachable();
+				break;
+			}
+		}
+		return res;
+	}
+
+	// returns whether the body of an inlinable function assigns to the given argument
+	inline static bool
+	_inline_func_assigns(Decl* d, Symbol* sym)
+	{
+		for (auto s: d->func_decl.body->block_stmt)
+		{
+			if (s->kind != Stmt::KIND_ASSIGN)
+				continue;
+
+			for (auto lhs: s->assign_stmt.lhs)
+				if (expr_assigned_symbol(lhs) == sym)
+					return true;
+		}
+		return false;
+	}
+
+	// we only inline straight line functions which end with a return statement and only write into their own
+	// arguments and local variables, so moving their body before the statement which calls them doesn't change
+	// the behavior of the program
+	inline static bool
+	_inline_func_check(Decl* d)
+	{
+		if (d->kind != Decl::KIND_FUNC || d->func_decl.body == nullptr || d->type == nullptr)
+			return false;
+
+		if (mn::map_lookup(d->tags.table, KEYWORD_BUILTIN) || mn::map_lookup(d->tags.table, KEYWORD_NOINLINE))
+			return false;
+
+		if (type_is_equal(d->type->as_func.sign.return_type, type_void))
+			return false;
+
+		// in/out arguments (geometry shader streams, etc...) should remain function arguments
+		for (const auto& arg: d->func_decl.args)
+			if (arg.tags.table.count > 0)
+				return false;
+
+		auto body = d->func_decl.body;
+		if (body->block_stmt.count == 0)
+			return false;
+
+		size_t cost = 0;
+		for (size_t i = 0; i < body->block_stmt.count; ++i)
+		{
+			auto s = body->block_stmt[i];
+			bool is_last = i + 1 == body->block_stmt.count;
+			switch (s->kind)
+			{
+			case Stmt::KIND_RETURN:
+				if (is_last == false || s->return_stmt == nullptr || expr_has_side_effects(s->return_stmt))
+					return false;
+				cost += 1 + _inline_expr_cost(s->return_stmt);
+				break;
+			case Stmt::KIND_DECL:
+				if (is_last || s->decl_stmt->kind != Decl::KIND_VAR)
+					return false;
+				cost += 1;
+				for (auto value: s->decl_stmt->var_decl.values)
+				{
+					if (expr_has_side_effects(value))
+						return false;
+					cost += _inline_expr_cost(value);
+				}
+				break;
+			case Stmt::KIND_ASSIGN:
+				if (is_last)
+					return false;
+				cost += 1;
+				for (size_t j = 0; j < s->assign_stmt.lhs.count; ++j)
+				{
+					auto lhs = s->assign_stmt.lhs[j];
+					auto rhs = s->assign_stmt.rhs[j];
+					if (_inline_is_local(d, expr_assigned_symbol(lhs)) == false)
+						return false;
+					if (expr_has_side_effects(lhs) || expr_has_side_effects(rhs))
+						return false;
+					cost += _inline_expr_cost(lhs) + _inline_expr_cost(rhs);
+				}
+				break;
+			default:
+				return false;
+			}
+		}
+
+		if (mn::map_lookup(d->tags.table, KEYWORD_INLINE))
+			return true;
+		return cost <= INLINE_COST_THRESHOLD;
+	}
+
+	inline static bool
+	_inline_func_is_inlinable(Inline& self, Decl* d)
+	{
+		if (auto it = mn::map_lookup(self.inlinable_funcs, d))
+			return it->value;
+
+		auto res = _inline_func_check(d);
+		mn::map_insert(self.inlinable_funcs, d, res);
+		return res;
+	}
+
+	// clones the given checked expression and replaces the arguments and local variables of the inlined function
+	// using the given replacements map
+	inline static Expr*
+	_inline_clone_expr(const Expr* e, const mn::Map<Symbol*, Expr*>* replacements)
+	{
+		if (e == nullptr)
+			return nullptr;
+
+		if (e->kind == Expr::KIND_ATOM && e->symbol && replacements)
+		{
+			if (auto it = mn::map_lookup(*replacements, e->symbol))
+			{
+				auto res = _inline_clone_expr(it->value, nullptr);
+				// keep the precedence of the substituted expression
+				if (res->kind == Expr::KIND_BINARY || res->kind == Expr::KIND_UNARY)
+					res->in_parens = true;
+				return res;
+			}
+		}
+
+		auto self = mn::alloc_zerod_from<Expr>(e->arena);
+		*self = *e;
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			break;
+		case Expr::KIND_BINARY:
+			self->binary.left = _inline_clone_expr(e->binary.left, replacements);
+			self->binary.right = _inline_clone_expr(e->binary.right, replacements);
+			break;
+		case Expr::KIND_UNARY:
+			self->unary.base = _inline_clone_expr(e->unary.base, replacements);
+			break;
+		case Expr::KIND_CALL:
+			self->call.args = mn::buf_with_allocator<Expr*>(e->arena);
+			for (auto arg: e->call.args)
+				mn::buf_push(self->call.args, _inline_clone_expr(arg, replacements));
+			break;
+		case Expr::KIND_CAST:
+			self->cast.base = _inline_clone_expr(e->cast.base, replacements);
+			break;
+		case Expr::KIND_DOT:
+			self->dot.lhs = _inline_clone_expr(e->dot.lhs, replacements);
+			break;
+		case Expr::KIND_INDEXED:
+			self->indexed.base = _inline_clone_expr(e->indexed.base, replacements);
+			self->indexed.index = _inline_clone_expr(e->indexed.index, replacements);
+			break;
+		case Expr::KIND_COMPLIT:
+			self->complit.fields = mn::buf_with_allocator<Complit_Field>(e->arena);
+			for (const auto& field: e->complit.fields)
+			{
+				auto new_field = field;
+				new_field.value = _inline_clone_expr(field.value, replacements);
+				mn::buf_push(self->complit.fields, new_field);
+			}
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+		return self;
+	}
+
+	inline static Expr*
+	_inline_atom_new(mn::Allocator arena, Decl* decl, Location loc)
+	{
+		auto self = expr_atom_new(arena, decl->name);
+		self->loc = loc;
+		self->type = decl->type;
+		self->mode = ADDRESS_MODE_VARIABLE;
+		self->symbol = decl->symbol;
+		self->atom.decl = decl;
+		return self;
+	}
+
+	// generates a local variable in the current scope which is used to hold the inlined function arguments,
+	// local variables, and return value
+	// returns the given temporary variable name, suffixed if it collides with a visible symbol in the given scope
+	inline static const char*
+	_inline_tmp_name(Unit_Package* package, Scope* scope, const char* name)
+	{
+		auto res = unit_intern(package->parent_unit, name);
+		for (size_t i = 1; scope_find(scope, res) != nullptr; ++i)
+			res = unit_intern(package->parent_unit, mn::str_tmpf("{}_{}", name, i).ptr);
+		return res;
+	}
+
+	inline static Decl*
+	_inline_var_new(Inline& self, mn::Allocator arena, Unit_Package* package, const char* name, Type* type, Expr* value, Location loc)
+	{
+		auto scope = _inline_current_scope(self);
+
+		Tkn tkn{};
+		tkn.kind = Tkn::KIND_ID;
+		tkn.str = _inline_tmp_name(package, scope, name);
+		tkn.loc = loc;
+
+		auto names = mn::buf_with_allocator<Tkn>(arena);
+		mn::buf_push(names, tkn);
+		auto values = mn::buf_with_allocator<Expr*>(arena);
+		if (value)
+			mn::buf_push(values, value);
+
+		auto decl = decl_var_new(arena, names, values, type_sign_new(arena));
+		decl->loc = loc;
+		decl->name = tkn;
+		decl->tags = tag_table_new(arena);
+		decl->type = type;
+
+		auto sym = symbol_var_new(package->symbols_arena, tkn, decl, decl->var_decl.type, value);
+		sym->type = type;
+		sym->state = STATE_RESOLVED;
+		scope_add(scope, sym);
+		sym->package = package;
+		sym->scope = scope;
+		return decl;
+	}
+
+	inline static void
+	_inline_push_decl_stmt(mn::Buf<Stmt*>& pre, mn::Allocator arena, Decl* decl)
+	{
+		auto stmt = stmt_decl_new(arena, decl);
+		stmt->loc = decl->loc;
+		mn::buf_push(pre, stmt);
+	}
+
+	// replaces the given call expression with the body of the called function, the statements of the body
+	// are pushed into pre and they should be inserted before the statement which contains the call
+	inline static void
+	_inline_call(Inline& self, Expr* e, mn::Buf<Stmt*>& pre)
+	{
+		auto d = e->call.func;
+		auto body = d->func_decl.body;
+		auto arena = e->arena;
+		auto package = e->loc.file->parent_package;
+		auto id = ++self.inline_id;
+
+		auto replacements = mn::map_with_allocator<Symbol*, Expr*>(mn::memory::tmp());
+
+		// arguments which are atoms or used at most once are substituted directly, the others are
+		// evaluated once into a local variable
+		size_t arg_index = 0;
+		for (const auto& arg: d->func_decl.args)
+		{
+			for (auto name: arg.names)
+			{
+				auto value = e->call.args[arg_index++];
+				auto param = scope_find(d->scope, name.str);
+				if (_inline_func_assigns(d, param) == false &&
+					(value->kind == Expr::KIND_ATOM || _inline_func_use_count(d, param) <= 1))
+				{
+					mn::map_insert(replacements, param, value);
+				}
+				else
+				{
+					auto decl = _inline_var_new(self, arena, package, mn::str_tmpf("_inline_{}_{}", id, name.str).ptr, param->type, value, value->loc);
+					_inline_push_decl_stmt(pre, arena, decl);
+					mn::map_insert(replacements, param, _inline_atom_new(arena, decl, value->loc));
+				}
+			}
+		}
+
+		auto body_scope = _inline_func_body_scope(d);
+		for (size_t i = 0; i + 1 < body->block_stmt.count; ++i)
+		{
+			auto s = body->block_stmt[i];
+			if (s->kind == Stmt::KIND_DECL)
+			{
+				const auto& names = s->decl_stmt->var_decl.names;
+				const auto& values = s->decl_stmt->var_decl.values;
+				for (size_t j = 0; j < names.count; ++j)
+				{
+					Expr* value = nullptr;
+					if (j < values.count)
+						value = _inline_clone_expr(values[j], &replacements);
+
+					auto local = scope_find(body_scope, names[j].str);
+					auto decl = _inline_var_new(self, arena, package, mn::str_tmpf("_inline_{}_{}", id, names[j].str).ptr, local->type, value, s->loc);
+					_inline_push_decl_stmt(pre, arena, decl);
+					mn::map_insert(replacements, local, _inline_atom_new(arena, decl, s->loc));
+				}
+			}
+			else if (s->kind == Stmt::KIND_ASSIGN)
+			{
+				auto stmt = mn::alloc_zerod_from<Stmt>(arena);
+				*stmt = *s;
+				stmt->arena = arena;
+				stmt->assign_stmt.lhs = mn::buf_with_allocator<Expr*>(arena);
+				stmt->assign_stmt.rhs = mn::buf_with_allocator<Expr*>(arena);
+				for (size_t j = 0; j < s->assign_stmt.lhs.count; ++j)
+				{
+					mn::buf_push(stmt->assign_stmt.lhs, _inline_clone_expr(s->assign_stmt.lhs[j], &replacements));
+					mn::buf_push(stmt->assign_stmt.rhs, _inline_clone_expr(s->assign_stmt.rhs[j], &replacements));
+				}
+				mn::buf_push(pre, stmt);
+			}
+			else
+			{
+				mn_unreachable();
+			}
+		}
+
+		auto result = _inline_clone_expr(mn::buf_top(body->block_stmt)->return_stmt, &replacements);
+		if (body->block_stmt.count == 1)
+		{
+			// the function is a single expression, so we use it in place of the call
+			if (result->kind == Expr::KIND_BINARY || result->kind == Expr::KIND_UNARY)
+				result->in_parens = true;
+			*e = *result;
+		}
+		else
+		{
+			auto decl = _inline_var_new(self, arena, package, mn::str_tmpf("_inline_{}", id).ptr, e->type, result, e->loc);
+			_inline_push_decl_stmt(pre, arena, decl);
+			*e = *_inline_atom_new(arena, decl, e->loc);
+		}
+
+		++self.stats.inlined_calls;
+		mn::set_insert(self.inlined_funcs, d);
+	}
+
+	inline static void
+	_inline_func(Inline& self, Decl* d);
+
+	inline static bool
+	_inline_call_is_inlinable(Inline& self, Expr* e)
+	{
+		auto d = e->call.func;
+		if (d == nullptr || d->kind != Decl::KIND_FUNC || d->func_decl.body == nullptr)
+			return false;
+
+		// recursive calls
+		if (mn::set_lookup(self.visiting_funcs, d))
+			return false;
+
+		// the called function is processed first so that we inline its body after its own calls are inlined
+		_inline_func(self, d);
+		if (_inline_func_is_inlinable(self, d) == false)
+			return false;
+
+		size_t args_count = 0;
+		for (const auto& arg: d->func_decl.args)
+			args_count += arg.names.count;
+		if (args_count != e->call.args.count)
+			return false;
+
+		// the arguments are evaluated before the statement which contains the call
+		for (auto arg: e->call.args)
+			if (expr_has_side_effects(arg))
+				return false;
+
+		return true;
+	}
+
+	inline static void
+	_inline_expr(Inline& self, Expr* e, mn::Buf<Stmt*>& pre)
+	{
+		if (e == nullptr)
+			return;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			break;
+		case Expr::KIND_BINARY:
+			_inline_expr(self, e->binary.left, pre);
+			// the right hand side of logical operators is conditionally evaluated so we don't inline in it
+			if (e->binary.op.kind != Tkn::KIND_LOGICAL_AND && e->binary.op.kind != Tkn::KIND_LOGICAL_OR)
+				_inline_expr(self, e->binary.right, pre);
+			break;
+		case Expr::KIND_UNARY:
+			_inline_expr(self, e->unary.base, pre);
+			break;
+		case Expr::KIND_CALL:
+			for (auto arg: e->call.args)
+				_inline_expr(self, arg, pre);
+			if (_inline_call_is_inlinable(self, e))
+				_inline_call(self, e, pre);
+			break;
+		case Expr::KIND_CAST:
+			_inline_expr(self, e->cast.base, pre);
+			break;
+		case Expr::KIND_DOT:
+			_inline_expr(self, e->dot.lhs, pre);
+			break;
+		case Expr::KIND_INDEXED:
+			_inline_expr(self, e->indexed.base, pre);
+			_inline_expr(self, e->indexed.index, pre);
+			break;
+		case Expr::KIND_COMPLIT:
+			for (const auto& field: e->complit.fields)
+				_inline_expr(self, field.value, pre);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static void
+	_inline_block(Inline& self, Stmt* s);
+
+	inline static void
+	_inline_stmt(Inline& self, Stmt* s, mn::Buf<Stmt*>& pre)
+	{
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+			break;
+		case Stmt::KIND_RETURN:
+			_inline_expr(self, s->return_stmt, pre);
+			break;
+		case Stmt::KIND_IF:
+			// only the first condition is always evaluated, the others depend on the conditions before them
+			_inline_expr(self, s->if_stmt.cond[0], pre);
+			for (auto body: s->if_stmt.body)
+				_inline_block(self, body);
+			if (s->if_stmt.else_body)
+				_inline_block(self, s->if_stmt.else_body);
+			break;
+		case Stmt::KIND_FOR:
+			// the condition and post statement are evaluated in each iteration so we only inline in the body
+			_inline_enter_scope(self, s->scope);
+			_inline_block(self, s->for_stmt.body);
+			_inline_leave_scope(self, s->scope);
+			break;
+		case Stmt::KIND_ASSIGN:
+			if (s->assign_stmt.lhs.count == 1 && expr_has_side_effects(s->assign_stmt.lhs[0]) == false)
+				_inline_expr(self, s->assign_stmt.rhs[0], pre);
+			break;
+		case Stmt::KIND_EXPR:
+			// expression statements are only executed for their side effects so the called function
+			// itself is kept, but we can still inline its arguments
+			if (s->expr_stmt->kind == Expr::KIND_CALL)
+				for (auto arg: s->expr_stmt->call.args)
+					_inline_expr(self, arg, pre);
+			break;
+		case Stmt::KIND_BLOCK:
+			_inline_block(self, s);
+			break;
+		case Stmt::KIND_DECL:
+			if (s->decl_stmt->kind == Decl::KIND_VAR && s->decl_stmt->var_decl.names.count == 1)
+				for (auto value: s->decl_stmt->var_decl.values)
+					_inline_expr(self, value, pre);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static void
+	_inline_block(Inline& self, Stmt* s)
+	{
+		_inline_enter_scope(self, s->scope);
+		mn_defer{_inline_leave_scope(self, s->scope);};
+
+		auto stmts = mn::buf_with_allocator<Stmt*>(mn::memory::tmp());
+		auto pre = mn::buf_with_allocator<Stmt*>(mn::memory::tmp());
+		for (auto stmt: s->block_stmt)
+		{
+			mn::buf_clear(pre);
+			_inline_stmt(self, stmt, pre);
+			for (auto pre_stmt: pre)
+				mn::buf_push(stmts, pre_stmt);
+			mn::buf_push(stmts, stmt);
+		}
+
+		if (stmts.count != s->block_stmt.count)
+			s->block_stmt = mn::buf_memcpy_clone(stmts, s->block_stmt.allocator);
+	}
+
+	inline static void
+	_inline_func(Inline& self, Decl* d)
+	{
+		if (d == nullptr || d->func_decl.body == nullptr)
+			return;
+
+		if (mn::set_lookup(self.visited_funcs, d))
+			return;
+		mn::set_insert(self.visited_funcs, d);
+		mn::buf_push(self.funcs, d);
+
+		mn::set_insert(self.visiting_funcs, d);
+		mn_defer{mn::set_remove(self.visiting_funcs, d);};
+
+		_inline_enter_scope(self, d->scope);
+		mn_defer{_inline_leave_scope(self, d->scope);};
+
+		_inline_block(self, d->func_decl.body);
+	}
+
+	inline static void
+	_inline_collect_calls_in_expr(const Expr* e, mn::Set<Decl*>& called)
+	{
+		if (e == nullptr)
+			return;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			break;
+		case Expr::KIND_BINARY:
+			_inline_collect_calls_in_expr(e->binary.left, called);
+			_inline_collect_calls_in_expr(e->binary.right, called);
+			break;
+		case Expr::KIND_UNARY:
+			_inline_collect_calls_in_expr(e->unary.base, called);
+			break;
+		case Expr::KIND_CALL:
+			if (e->call.func)
+				mn::set_insert(called, e->call.func);
+			for (auto arg: e->call.args)
+				_inline_collect_calls_in_expr(arg, called);
+			break;
+		case Expr::KIND_CAST:
+			_inline_collect_calls_in_expr(e->cast.base, called);
+			break;
+		case Expr::KIND_DOT:
+			_inline_collect_calls_in_expr(e->dot.lhs, called);
+			break;
+		case Expr::KIND_INDEXED:
+			_inline_collect_calls_in_expr(e->indexed.base, called);
+			_inline_collect_calls_in_expr(e->indexed.index, called);
+			break;
+		case Expr::KIND_COMPLIT:
+			for (const auto& field: e->complit.fields)
+				_inline_collect_calls_in_expr(field.value, called);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static void
+	_inline_collect_calls_in_stmt(const Stmt* s, mn::Set<Decl*>& called)
+	{
+		if (s == nullptr)
+			return;
+
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+			break;
+		case Stmt::KIND_RETURN:
+			_inline_collect_calls_in_expr(s->return_stmt, called);
+			break;
+		case Stmt::KIND_IF:
+			for (auto cond: s->if_stmt.cond)
+				_inline_collect_calls_in_expr(cond, called);
+			for (auto body: s->if_stmt.body)
+				_inline_collect_calls_in_stmt(body, called);
+			_inline_collect_calls_in_stmt(s->if_stmt.else_body, called);
+			break;
+		case Stmt::KIND_FOR:
+			_inline_collect_calls_in_stmt(s->for_stmt.init, called);
+			_inline_collect_calls_in_expr(s->for_stmt.cond, called);
+			_inline_collect_calls_in_stmt(s->for_stmt.post, called);
+			_inline_collect_calls_in_stmt(s->for_stmt.body, called);
+			break;
+		case Stmt::KIND_ASSIGN:
+			for (size_t i = 0; i < s->assign_stmt.lhs.count; ++i)
+			{
+				_inline_collect_calls_in_expr(s->assign_stmt.lhs[i], called);
+				_inline_collect_calls_in_expr(s->assign_stmt.rhs[i], called);
+			}
+			break;
+		case Stmt::KIND_EXPR:
+			_inline_collect_calls_in_expr(s->expr_stmt, called);
+			break;
+		case Stmt::KIND_BLOCK:
+			for (auto stmt: s->block_stmt)
+				_inline_collect_calls_in_stmt(stmt, called);
+			break;
+		case Stmt::KIND_DECL:
+			if (s->decl_stmt->kind == Decl::KIND_VAR)
+				for (auto value: s->decl_stmt->var_decl.values)
+					_inline_collect_calls_in_expr(value, called);
+			else if (s->decl_stmt->kind == Decl::KIND_CONST)
+				for (auto value: s->decl_stmt->const_decl.values)
+					_inline_collect_calls_in_expr(value, called);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	// removes the functions which are no longer called after inlining from the generated symbols
+	inline static void
+	_inline_remove_uncalled_funcs(Inline& self, Entry_Point* entry)
+	{
+		auto called = mn::set_with_allocator<Decl*>(mn::memory::tmp());
+		for (auto d: self.funcs)
+			_inline_collect_calls_in_stmt(d->func_decl.body, called);
+
+		mn::buf_remove_if(entry->reachable_symbols, [&](Symbol* sym) {
+			if (sym == entry->symbol)
+				return false;
+
+			Decl* decl = nullptr;
+			if (sym->kind == Symbol::KIND_FUNC)
+				decl = sym->func_sym.decl;
+			else if (sym->kind == Symbol::KIND_FUNC_INSTANTIATION)
+				decl = sym->as_func_instantiation.decl;
+			else
+				return false;
+
+			if (mn::set_lookup(self.inlined_funcs, decl) == nullptr || mn::set_lookup(called, decl) != nullptr)
+				return false;
+
+			++self.stats.removed_funcs;
+			return true;
+		});
+	}
+
+	// API
+	Inline_Stats
+	inline_entry(Entry_Point* entry)
+	{
+		auto self = _inline_new();
+		unit_reachable_funcs_walk(entry, nullptr, [&](Decl* d) { _inline_func(self, d); });
+
+		_inline_remove_uncalled_funcs(self, entry);
+		return self.stats;
+	}
+
+	Inline_Stats
+	inline_package(Unit_Package* package)
+	{
+		auto self = _inline_new();
+		unit_reachable_funcs_walk(nullptr, package, [&](Decl* d) { _inline_func(self, d); });
+		return self.stats;
+	}
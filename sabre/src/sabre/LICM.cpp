@@ -0,0 +1,593 @@
+#include "sabre/LICM.h"
+#include "sabre/Unit.h"
+#include "sabre/AST.h"
+#include "sabre/Scope.h"
+#include "sabre/Type_Interner.h"
+
+#include <mn/Buf.h>
+#include <mn/Map.h>
+#include <mn/Memory.h>
+#include <mn/Defer.h>
+#include <mn/Assert.h>
+
+#include <string.h>
+
+namespace sabre
+{
+	// the for loop which we're hoisting expressions out of
+	struct LICM_Loop
+	{
+		Scope* scope;
+		// variables which are written inside the loop, nullptr is used when the written variable is unknown
+		mn::Set<Symbol*> writes;
+		size_t hoisted_exprs;
+	};
+
+	struct LICM
+	{
+		LICM_Stats stats;
+		mn::Buf<Scope*> scope_stack;
+		size_t tmp_id;
+	};
+
+	inline static LICM
+	_licm_new()
+	{
+		LICM self{};
+		self.scope_stack = mn::buf_with_allocator<Scope*>(mn::memory::tmp());
+		return self;
+	}
+
+	inline static void
+	_licm_enter_scope(LICM& self, Scope* scope)
+	{
+		if (scope)
+			mn::buf_push(self.scope_stack, scope);
+	}
+
+	inline static void
+	_licm_leave_scope(LICM& self, Scope* scope)
+	{
+		if (scope)
+			mn::buf_pop(self.scope_stack);
+	}
+
+	inline static Scope*
+	_licm_current_scope(LICM& self)
+	{
+		return mn::buf_top(self.scope_stack);
+	}
+
+	inline static void
+	_licm_collect_writes_in_expr(const Expr* e, mn::Set<Symbol*>& writes)
+	{
+		if (e == nullptr)
+			return;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			break;
+		case Expr::KIND_BINARY:
+			_licm_collect_writes_in_expr(e->binary.left, writes);
+			_licm_collect_writes_in_expr(e->binary.right, writes);
+			break;
+		case Expr::KIND_UNARY:
+			if (e->unary.op.kind == Tkn::KIND_INC || e->unary.op.kind == Tkn::KIND_DEC)
+				mn::set_insert(writes, expr_assigned_symbol(e->unary.base));
+			_licm_collect_writes_in_expr(e->unary.base, writes);
+			break;
+		case Expr::KIND_CALL:
+			for (auto arg: e->call.args)
+				_licm_collect_writes_in_expr(arg, writes);
+			break;
+		case Expr::KIND_CAST:
+			_licm_collect_writes_in_expr(e->cast.base, writes);
+			break;
+		case Expr::KIND_DOT:
+			_licm_collect_writes_in_expr(e->dot.lhs, writes);
+			break;
+		case Expr::KIND_INDEXED:
+			_licm_collect_writes_in_expr(e->indexed.base, writes);
+			_licm_collect_writes_in_expr(e->indexed.index, writes);
+			break;
+		case Expr::KIND_COMPLIT:
+			for (const auto& field: e->complit.fields)
+				_licm_collect_writes_in_expr(field.value, writes);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static void
+	_licm_collect_writes_in_stmt(const Stmt* s, mn::Set<Symbol*>& writes)
+	{
+		if (s == nullptr)
+			return;
+
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+			break;
+		case Stmt::KIND_RETURN:
+			_licm_collect_writes_in_expr(s->return_stmt, writes);
+			break;
+		case Stmt::KIND_IF:
+			for (auto cond: s->if_stmt.cond)
+				_licm_collect_writes_in_expr(cond, writes);
+			for (auto body: s->if_stmt.body)
+				_licm_collect_writes_in_stmt(body, writes);
+			_licm_collect_writes_in_stmt(s->if_stmt.else_body, writes);
+			break;
+		case Stmt::KIND_FOR:
+			_licm_collect_writes_in_stmt(s->for_stmt.init, writes);
+			_licm_collect_writes_in_expr(s->for_stmt.cond, writes);
+			_licm_collect_writes_in_stmt(s->for_stmt.post, writes);
+			_licm_collect_writes_in_stmt(s->for_stmt.body, writes);
+			break;
+		case Stmt::KIND_ASSIGN:
+			for (size_t i = 0; i < s->assign_stmt.lhs.count; ++i)
+			{
+				mn::set_insert(writes, expr_assigned_symbol(s->assign_stmt.lhs[i]));
+				_licm_collect_writes_in_expr(s->assign_stmt.lhs[i], writes);
+				_licm_collect_writes_in_expr(s->assign_stmt.rhs[i], writes);
+			}
+			break;
+		case Stmt::KIND_EXPR:
+			_licm_collect_writes_in_expr(s->expr_stmt, writes);
+			break;
+		case Stmt::KIND_BLOCK:
+			for (auto stmt: s->block_stmt)
+				_licm_collect_writes_in_stmt(stmt, writes);
+			break;
+		case Stmt::KIND_DECL:
+			if (s->decl_stmt->kind == Decl::KIND_VAR)
+				for (auto value: s->decl_stmt->var_decl.values)
+					_licm_collect_writes_in_expr(value, writes);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	// returns whether the given symbol is declared inside the given loop (including the loop init statement)
+	inline static bool
+	_licm_is_declared_inside(Symbol* sym, Scope* loop_scope)
+	{
+		for (auto it = sym->scope; it != nullptr; it = it->parent)
+			if (it == loop_scope)
+				return true;
+		return false;
+	}
+
+	inline static bool
+	_licm_symbol_is_invariant(const LICM_Loop& loop, Symbol* sym)
+	{
+		// literals
+		if (sym == nullptr)
+			return true;
+
+		switch (sym->kind)
+		{
+		case Symbol::KIND_ENUM:
+			return true;
+		case Symbol::KIND_CONST:
+			// constants don't change, but the ones declared inside the loop are not visible before it
+			return _licm_is_declared_inside(sym, loop.scope) == false;
+		case Symbol::KIND_VAR:
+			// uniforms are read only, except for read write buffers which might be written by other invocations
+			if (sym->var_sym.is_uniform)
+				return sym->type->kind != Type::KIND_RW_BUFFER;
+			// global variables might be written by the functions which the loop calls
+			if (sym->is_top_level)
+				return false;
+			if (_licm_is_declared_inside(sym, loop.scope))
+				return false;
+			return mn::set_lookup(loop.writes, sym) == nullptr;
+		default:
+			return false;
+		}
+	}
+
+	// returns whether the given expression is pure and produces the same value in all the loop iterations
+	inline static bool
+	_licm_expr_is_invariant(const LICM_Loop& loop, const Expr* e)
+	{
+		if (e == nullptr)
+			return true;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return _licm_symbol_is_invariant(loop, e->symbol);
+		case Expr::KIND_BINARY:
+			return _licm_expr_is_invariant(loop, e->binary.left) && _licm_expr_is_invariant(loop, e->binary.right);
+		case Expr::KIND_UNARY:
+			if (e->unary.op.kind == Tkn::KIND_INC || e->unary.op.kind == Tkn::KIND_DEC)
+				return false;
+			return _licm_expr_is_invariant(loop, e->unary.base);
+		case Expr::KIND_CALL:
+			if (decl_is_pure_builtin_func(e->call.func) == false)
+				return false;
+			for (auto arg: e->call.args)
+				if (_licm_expr_is_invariant(loop, arg) == false)
+					return false;
+			return true;
+		case Expr::KIND_CAST:
+			return _licm_expr_is_invariant(loop, e->cast.base);
+		case Expr::KIND_DOT:
+			if (e->dot.lhs == nullptr)
+				return false;
+			return _licm_expr_is_invariant(loop, e->dot.lhs);
+		case Expr::KIND_INDEXED:
+			return _licm_expr_is_invariant(loop, e->indexed.base) && _licm_expr_is_invariant(loop, e->indexed.index);
+		case Expr::KIND_COMPLIT:
+			return false;
+		default:
+			mn_unreachable();
+			return false;
+		}
+	}
+
+	inline static bool
+	_licm_type_is_integer(Type* t)
+	{
+		if (t->kind == Type::KIND_VEC)
+			t = t->vec.base;
+		return type_is_equal(t, type_int) || type_is_equal(t, type_uint);
+	}
+
+	// the loop might not run at all, so hoisted expressions are evaluated speculatively, we don't hoist
+	// expressions which are not safe to evaluate when the loop wouldn't have evaluated them, like integer
+	// division by zero, texture samples and derivatives which are undefined in non uniform control flow
+	inline static bool
+	_licm_expr_is_safe_to_speculate(const Expr* e)
+	{
+		if (e == nullptr)
+			return true;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return true;
+		case Expr::KIND_BINARY:
+			if ((e->binary.op.kind == Tkn::KIND_DIVIDE || e->binary.op.kind == Tkn::KIND_MODULUS) && _licm_type_is_integer(e->type))
+				return false;
+			return _licm_expr_is_safe_to_speculate(e->binary.left) && _licm_expr_is_safe_to_speculate(e->binary.right);
+		case Expr::KIND_UNARY:
+			return _licm_expr_is_safe_to_speculate(e->unary.base);
+		case Expr::KIND_CALL:
+			if (mn::map_lookup(e->call.func->tags.table, KEYWORD_SAMPLE_FUNC))
+				return false;
+			if (::strcmp(e->call.func->name.str, "ddx") == 0 || ::strcmp(e->call.func->name.str, "ddy") == 0)
+				return false;
+			for (auto arg: e->call.args)
+				if (_licm_expr_is_safe_to_speculate(arg) == false)
+					return false;
+			return true;
+		case Expr::KIND_CAST:
+			return _licm_expr_is_safe_to_speculate(e->cast.base);
+		case Expr::KIND_DOT:
+			return _licm_expr_is_safe_to_speculate(e->dot.lhs);
+		case Expr::KIND_INDEXED:
+			return _licm_expr_is_safe_to_speculate(e->indexed.base) && _licm_expr_is_safe_to_speculate(e->indexed.index);
+		case Expr::KIND_COMPLIT:
+			return false;
+		default:
+			mn_unreachable();
+			return false;
+		}
+	}
+
+	// returns whether the given statement might skip the rest of the loop iteration
+	inline static bool
+	_licm_stmt_may_jump(const Stmt* s)
+	{
+		if (s == nullptr)
+			return false;
+
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+		case Stmt::KIND_RETURN:
+			return true;
+		case Stmt::KIND_IF:
+			for (auto body: s->if_stmt.body)
+				if (_licm_stmt_may_jump(body))
+					return true;
+			return _licm_stmt_may_jump(s->if_stmt.else_body);
+		case Stmt::KIND_FOR:
+			return _licm_stmt_may_jump(s->for_stmt.body);
+		case Stmt::KIND_BLOCK:
+			for (auto stmt: s->block_stmt)
+				if (_licm_stmt_may_jump(stmt))
+					return true;
+			return false;
+		default:
+			return false;
+		}
+	}
+
+	// we only hoist computations, moving variable reads, field accesses, and constants out of the loop
+	// will not save anything
+	inline static bool
+	_licm_expr_is_worth_hoisting(const Expr* e)
+	{
+		if (e->kind != Expr::KIND_BINARY && e->kind != Expr::KIND_CALL)
+			return false;
+		return e->const_value.type == nullptr;
+	}
+
+	inline static const char*
+	_licm_tmp_name(LICM& self, Unit_Package* package, Scope* scope)
+	{
+		while (true)
+		{
+			auto name = unit_intern(package->parent_unit, mn::str_tmpf("_licm_{}", ++self.tmp_id).ptr);
+			if (scope_find(scope, name) == nullptr)
+				return name;
+		}
+	}
+
+	// moves the given expression into a temporary variable before the loop, and makes the expression read it
+	inline static void
+	_licm_hoist(LICM& self, LICM_Loop& loop, Expr* e, mn::Buf<Stmt*>& pre)
+	{
+		auto arena = e->arena;
+		auto package = e->loc.file->parent_package;
+		auto scope = _licm_current_scope(self);
+
+		Tkn name{};
+		name.kind = Tkn::KIND_ID;
+		name.str = _licm_tmp_name(self, package, scope);
+		name.loc = e->loc;
+
+		auto value = mn::alloc_zerod_from<Expr>(arena);
+		*value = *e;
+		value->in_parens = false;
+
+		auto names = mn::buf_with_allocator<Tkn>(arena);
+		mn::buf_push(names, name);
+		auto values = mn::buf_with_allocator<Expr*>(arena);
+		mn::buf_push(values, value);
+
+		auto decl = decl_var_new(arena, names, values, type_sign_new(arena));
+		decl->loc = e->loc;
+		decl->name = name;
+		decl->tags = tag_table_new(arena);
+		decl->type = e->type;
+
+		auto sym = symbol_var_new(package->symbols_arena, name, decl, decl->var_decl.type, value);
+		sym->type = e->type;
+		sym->state = STATE_RESOLVED;
+		scope_add(scope, sym);
+		sym->package = package;
+		sym->scope = scope;
+
+		e->kind = Expr::KIND_ATOM;
+		e->in_parens = false;
+		e->mode = ADDRESS_MODE_VARIABLE;
+		e->const_value = Expr_Value{};
+		e->symbol = sym;
+		e->atom.tkn = name;
+		e->atom.decl = decl;
+
+		auto stmt = stmt_decl_new(arena, decl);
+		stmt->loc = decl->loc;
+		mn::buf_push(pre, stmt);
+
+		++self.stats.hoisted_exprs;
+		++loop.hoisted_exprs;
+	}
+
+	inline static void
+	_licm_hoist_in_expr(LICM& self, LICM_Loop& loop, Expr* e, mn::Buf<Stmt*>& pre)
+	{
+		if (e == nullptr)
+			return;
+
+		if (_licm_expr_is_worth_hoisting(e) && _licm_expr_is_invariant(loop, e) && _licm_expr_is_safe_to_speculate(e))
+		{
+			_licm_hoist(self, loop, e, pre);
+			return;
+		}
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			break;
+		case Expr::KIND_BINARY:
+			_licm_hoist_in_expr(self, loop, e->binary.left, pre);
+			// the right hand side of logical operators is conditionally evaluated so we don't hoist from it
+			if (e->binary.op.kind != Tkn::KIND_LOGICAL_AND && e->binary.op.kind != Tkn::KIND_LOGICAL_OR)
+				_licm_hoist_in_expr(self, loop, e->binary.right, pre);
+			break;
+		case Expr::KIND_UNARY:
+			_licm_hoist_in_expr(self, loop, e->unary.base, pre);
+			break;
+		case Expr::KIND_CALL:
+			for (auto arg: e->call.args)
+				_licm_hoist_in_expr(self, loop, arg, pre);
+			break;
+		case Expr::KIND_CAST:
+			_licm_hoist_in_expr(self, loop, e->cast.base, pre);
+			break;
+		case Expr::KIND_DOT:
+			_licm_hoist_in_expr(self, loop, e->dot.lhs, pre);
+			break;
+		case Expr::KIND_INDEXED:
+			_licm_hoist_in_expr(self, loop, e->indexed.base, pre);
+			_licm_hoist_in_expr(self, loop, e->indexed.index, pre);
+			break;
+		case Expr::KIND_COMPLIT:
+			for (const auto& field: e->complit.fields)
+				_licm_hoist_in_expr(self, loop, field.value, pre);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static void
+	_licm_hoist_in_stmt(LICM& self, LICM_Loop& loop, Stmt* s, mn::Buf<Stmt*>& pre)
+	{
+		if (s == nullptr)
+			return;
+
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+			break;
+		case Stmt::KIND_RETURN:
+			_licm_hoist_in_expr(self, loop, s->return_stmt, pre);
+			break;
+		case Stmt::KIND_IF:
+			// only the first condition is evaluated in every iteration, the rest and the bodies are conditional
+			_licm_hoist_in_expr(self, loop, s->if_stmt.cond[0], pre);
+			break;
+		case Stmt::KIND_FOR:
+			// the nested loop post statement and body might not run, they're handled when we process the
+			// nested loop itself
+			_licm_hoist_in_stmt(self, loop, s->for_stmt.init, pre);
+			_licm_hoist_in_expr(self, loop, s->for_stmt.cond, pre);
+			break;
+		case Stmt::KIND_ASSIGN:
+			for (size_t i = 0; i < s->assign_stmt.lhs.count; ++i)
+			{
+				_licm_hoist_in_expr(self, loop, s->assign_stmt.lhs[i], pre);
+				_licm_hoist_in_expr(self, loop, s->assign_stmt.rhs[i], pre);
+			}
+			break;
+		case Stmt::KIND_EXPR:
+			_licm_hoist_in_expr(self, loop, s->expr_stmt, pre);
+			break;
+		case Stmt::KIND_BLOCK:
+			for (auto stmt: s->block_stmt)
+			{
+				_licm_hoist_in_stmt(self, loop, stmt, pre);
+				// the statements after a break, continue, return or discard don't run in every iteration
+				if (_licm_stmt_may_jump(stmt))
+					break;
+			}
+			break;
+		case Stmt::KIND_DECL:
+			if (s->decl_stmt->kind == Decl::KIND_VAR)
+				for (auto value: s->decl_stmt->var_decl.values)
+					_licm_hoist_in_expr(self, loop, value, pre);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static void
+	_licm_block(LICM& self, Stmt* s);
+
+	// hoists the invariant expressions which are evaluated in every iteration of the given loop into pre,
+	// then processes the nested loops which hoist into the loop body
+	inline static void
+	_licm_for(LICM& self, Stmt* s, mn::Buf<Stmt*>& pre)
+	{
+		if (s->scope)
+		{
+			LICM_Loop loop{};
+			loop.scope = s->scope;
+			loop.writes = mn::set_with_allocator<Symbol*>(mn::memory::tmp());
+			_licm_collect_writes_in_stmt(s, loop.writes);
+
+			if (mn::set_lookup(loop.writes, nullptr) == nullptr)
+			{
+				// the init statement is only evaluated once
+				_licm_hoist_in_expr(self, loop, s->for_stmt.cond, pre);
+				_licm_hoist_in_stmt(self, loop, s->for_stmt.post, pre);
+				_licm_hoist_in_stmt(self, loop, s->for_stmt.body, pre);
+			}
+
+			if (loop.hoisted_exprs > 0)
+				++self.stats.optimized_loops;
+		}
+
+		_licm_enter_scope(self, s->scope);
+		_licm_block(self, s->for_stmt.body);
+		_licm_leave_scope(self, s->scope);
+	}
+
+	inline static void
+	_licm_stmt(LICM& self, Stmt* s, mn::Buf<Stmt*>& pre)
+	{
+		switch (s->kind)
+		{
+		case Stmt::KIND_FOR:
+			_licm_for(self, s, pre);
+			break;
+		case Stmt::KIND_IF:
+			for (auto body: s->if_stmt.body)
+				_licm_block(self, body);
+			if (s->if_stmt.else_body)
+				_licm_block(self, s->if_stmt.else_body);
+			break;
+		case Stmt::KIND_BLOCK:
+			_licm_block(self, s);
+			break;
+		default:
+			break;
+		}
+	}
+
+	inline static void
+	_licm_block(LICM& self, Stmt* s)
+	{
+		_licm_enter_scope(self, s->scope);
+		mn_defer{_licm_leave_scope(self, s->scope);};
+
+		auto stmts = mn::buf_with_allocator<Stmt*>(mn::memory::tmp());
+		auto pre = mn::buf_with_allocator<Stmt*>(mn::memory::tmp());
+		for (auto stmt: s->block_stmt)
+		{
+			mn::buf_clear(pre);
+			_licm_stmt(self, stmt, pre);
+			for (auto pre_stmt: pre)
+				mn::buf_push(stmts, pre_stmt);
+			mn::buf_push(stmts, stmt);
+		}
+
+		if (stmts.count != s->block_stmt.count)
+			s->block_stmt = mn::buf_memcpy_clone(stmts, s->block_stmt.allocator);
+	}
+
+	inline static void
+	_licm_func(LICM& self, Decl* d)
+	{
+		_licm_enter_scope(self, d->scope);
+		_licm_block(self, d->func_decl.body);
+		_licm_leave_scope(self, d->scope);
+	}
+
+	// API
+	LICM_Stats
+	licm_entry(Entry_Point* entry)
+	{
+		auto self = _licm_new();
+		unit_reachable_funcs_walk(entry, nullptr, [&](Decl* d) { _licm_func(self, d); });
+		return self.stats;
+	}
+
+	LICM_Stats
+	licm_package(Unit_Package* package)
+	{
+		auto self = _licm_new();
+		unit_reachable_funcs_walk(nullptr, package, [&](Decl* d) { _licm_func(self, d); });
+		return self.stats;
+	}
+}
\ No newline at end of file
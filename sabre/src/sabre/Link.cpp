@@ -0,0 +1,589 @@
+#include "sabre/Link.h"
+#include "sabre/DCE.h"
+#include "sabre/Unit.h"
+#include "sabre/AST.h"
+#include "sabre/Scope.h"
+#include "sabre/Type_Interner.h"
+
+#include <mn/Buf.h>
+#include <mn/Map.h>
+#include <mn/Memory.h>
+#include <mn/Defer.h>
+#include <mn/Assert.h>
+
+namespace sabre
+{
+	struct Link
+	{
+		Link_Stats stats;
+		mn::Buf<Scope*> scope_stack;
+		// struct which the function we're currently processing writes (vertex) or reads (pixel)
+		Type* varyings_type;
+		// fields which are read from the local variables of the varyings struct
+		mn::Set<const char*> read_fields;
+		// local variables of the varyings struct which are used as a whole (copied, passed to functions, etc...)
+		// returning them or assigning to them doesn't count
+		mn::Set<Symbol*> escaped_vars;
+		// removed fields which are never read in the vertex entry, stores into them are dead
+		mn::Set<const char*> dead_fields;
+	};
+
+	inline static Link
+	_link_new()
+	{
+		Link self{};
+		self.scope_stack = mn::buf_with_allocator<Scope*>(mn::memory::tmp());
+		self.read_fields = mn::set_with_allocator<const char*>(mn::memory::tmp());
+		self.escaped_vars = mn::set_with_allocator<Symbol*>(mn::memory::tmp());
+		self.dead_fields = mn::set_with_allocator<const char*>(mn::memory::tmp());
+		return self;
+	}
+
+	inline static void
+	_link_enter_scope(Link& self, Scope* scope)
+	{
+		if (scope)
+			mn::buf_push(self.scope_stack, scope);
+	}
+
+	inline static void
+	_link_leave_scope(Link& self, Scope* scope)
+	{
+		if (scope)
+			mn::buf_pop(self.scope_stack);
+	}
+
+	inline static Scope*
+	_link_current_scope(Link& self)
+	{
+		return mn::buf_top(self.scope_stack);
+	}
+
+	inline static void
+	_link_err(Entry_Point* entry, Location loc, mn::Str msg)
+	{
+		Err err{};
+		err.loc = loc;
+		err.msg = msg;
+		unit_err(entry->symbol->package, err);
+	}
+
+	// pushes the fields of the given struct which take a location, system values (like @system_position) don't
+	inline static void
+	_link_varying_fields(Type* type, mn::Buf<const Struct_Field_Type*>& fields)
+	{
+		auto decl = symbol_decl(type->struct_type.symbol);
+		size_t field_index = 0;
+		for (const auto& decl_field: decl->struct_decl.fields)
+		{
+			bool is_builtin =
+				mn::map_lookup(decl_field.tags.table, KEYWORD_SV_POSITION) != nullptr ||
+				mn::map_lookup(decl_field.tags.table, KEYWORD_SV_DEPTH) != nullptr;
+
+			for (size_t i = 0; i < decl_field.names.count; ++i)
+			{
+				const auto& field = type->struct_type.fields[field_index++];
+				if (is_builtin == false)
+					mn::buf_push(fields, &field);
+			}
+		}
+	}
+
+	// checks that the vertex outputs match the pixel inputs, and returns the pixel input struct in pixel_type
+	// (which is nullptr if the pixel entry doesn't have inputs)
+	inline static bool
+	_link_check_interface(Entry_Point* vertex, Entry_Point* pixel, Type*& pixel_type)
+	{
+		auto vertex_decl = symbol_decl(vertex->symbol);
+		auto pixel_decl = symbol_decl(pixel->symbol);
+
+		if (vertex->mode != COMPILATION_MODE_VERTEX)
+		{
+			_link_err(vertex, vertex_decl->loc, mn::strf("'{}' is not a vertex entry point", vertex->symbol->name));
+			return false;
+		}
+
+		if (pixel->mode != COMPILATION_MODE_PIXEL)
+		{
+			_link_err(vertex, pixel_decl->loc, mn::strf("'{}' is not a pixel entry point", pixel->symbol->name));
+			return false;
+		}
+
+		auto vertex_type = vertex->symbol->type->as_func.sign.return_type;
+		if (vertex_type->kind != Type::KIND_STRUCT)
+		{
+			_link_err(vertex, vertex_decl->loc, mn::strf("vertex entry '{}' should return a struct to be linked with a pixel entry", vertex->symbol->name));
+			return false;
+		}
+
+		const auto& pixel_args = pixel->symbol->type->as_func.sign.args.types;
+		if (pixel_args.count > 1)
+		{
+			_link_err(vertex, pixel_decl->loc, mn::strf("pixel entry '{}' should have at most one input to be linked with a vertex entry", pixel->symbol->name));
+			return false;
+		}
+
+		pixel_type = nullptr;
+		if (pixel_args.count == 0)
+			return true;
+
+		pixel_type = pixel_args[0];
+		if (pixel_type == vertex_type)
+			return true;
+
+		auto vertex_fields = mn::buf_with_allocator<const Struct_Field_Type*>(mn::memory::tmp());
+		auto pixel_fields = mn::buf_with_allocator<const Struct_Field_Type*>(mn::memory::tmp());
+		_link_varying_fields(vertex_type, vertex_fields);
+		_link_varying_fields(pixel_type, pixel_fields);
+
+		// fields are matched by location so they should have the same order
+		if (vertex_fields.count != pixel_fields.count)
+		{
+			_link_err(vertex, pixel_decl->loc, mn::strf(
+				"vertex entry '{}' outputs {} varyings, but pixel entry '{}' reads {}",
+				vertex->symbol->name, vertex_fields.count, pixel->symbol->name, pixel_fields.count
+			));
+			return false;
+		}
+
+		bool result = true;
+		for (size_t i = 0; i < vertex_fields.count; ++i)
+		{
+			auto vertex_field = vertex_fields[i];
+			auto pixel_field = pixel_fields[i];
+			if (vertex_field->name.str != pixel_field->name.str || vertex_field->type != pixel_field->type)
+			{
+				_link_err(vertex, pixel_field->name.loc, mn::strf(
+					"pixel input '{}: {}' doesn't match vertex output '{}: {}'",
+					pixel_field->name.str, *pixel_field->type, vertex_field->name.str, *vertex_field->type
+				));
+				result = false;
+			}
+		}
+		return result;
+	}
+
+	inline static bool
+	_link_is_varyings_local(Link& self, Symbol* sym)
+	{
+		return (
+			sym != nullptr &&
+			sym->kind == Symbol::KIND_VAR &&
+			sym->is_top_level == false &&
+			sym->type == self.varyings_type
+		);
+	}
+
+	// returns the local variable and the field if the given expression is a field access like `x.field`
+	inline static bool
+	_link_field_access(Link& self, Expr* e, Symbol*& var, const char*& field)
+	{
+		if (e->kind != Expr::KIND_DOT || e->dot.lhs == nullptr || e->dot.lhs->kind != Expr::KIND_ATOM || e->dot.rhs->kind != Expr::KIND_ATOM)
+			return false;
+
+		if (_link_is_varyings_local(self, e->dot.lhs->symbol) == false)
+			return false;
+
+		var = e->dot.lhs->symbol;
+		field = e->dot.rhs->atom.tkn.str;
+		return true;
+	}
+
+	inline static void
+	_link_mark_reads_in_expr(Link& self, Expr* e)
+	{
+		if (e == nullptr)
+			return;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			if (_link_is_varyings_local(self, e->symbol))
+				mn::set_insert(self.escaped_vars, e->symbol);
+			break;
+		case Expr::KIND_BINARY:
+			_link_mark_reads_in_expr(self, e->binary.left);
+			_link_mark_reads_in_expr(self, e->binary.right);
+			break;
+		case Expr::KIND_UNARY:
+			_link_mark_reads_in_expr(self, e->unary.base);
+			break;
+		case Expr::KIND_CALL:
+			_link_mark_reads_in_expr(self, e->call.base);
+			for (auto arg: e->call.args)
+				_link_mark_reads_in_expr(self, arg);
+			break;
+		case Expr::KIND_CAST:
+			_link_mark_reads_in_expr(self, e->cast.base);
+			break;
+		case Expr::KIND_DOT:
+		{
+			Symbol* var = nullptr;
+			const char* field = nullptr;
+			if (_link_field_access(self, e, var, field))
+				mn::set_insert(self.read_fields, field);
+			else
+				_link_mark_reads_in_expr(self, e->dot.lhs);
+			break;
+		}
+		case Expr::KIND_INDEXED:
+			_link_mark_reads_in_expr(self, e->indexed.base);
+			_link_mark_reads_in_expr(self, e->indexed.index);
+			break;
+		case Expr::KIND_COMPLIT:
+			for (const auto& field: e->complit.fields)
+				_link_mark_reads_in_expr(self, field.value);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	// marks the reads in the left hand side of an assignment, the assigned variable or field itself is not read
+	inline static void
+	_link_mark_reads_in_lhs(Link& self, Expr* e)
+	{
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			break;
+		case Expr::KIND_DOT:
+		{
+			Symbol* var = nullptr;
+			const char* field = nullptr;
+			if (_link_field_access(self, e, var, field) == false && e->dot.lhs)
+				_link_mark_reads_in_lhs(self, e->dot.lhs);
+			break;
+		}
+		case Expr::KIND_INDEXED:
+			_link_mark_reads_in_lhs(self, e->indexed.base);
+			_link_mark_reads_in_expr(self, e->indexed.index);
+			break;
+		default:
+			_link_mark_reads_in_expr(self, e);
+			break;
+		}
+	}
+
+	inline static void
+	_link_mark_reads_in_stmt(Link& self, Stmt* s)
+	{
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+			break;
+		case Stmt::KIND_RETURN:
+			// returning a local variable writes it to the outputs, it's not a use of the variable as a whole
+			if (s->return_stmt && s->return_stmt->kind == Expr::KIND_ATOM && _link_is_varyings_local(self, s->return_stmt->symbol))
+				break;
+			_link_mark_reads_in_expr(self, s->return_stmt);
+			break;
+		case Stmt::KIND_IF:
+			for (auto cond: s->if_stmt.cond)
+				_link_mark_reads_in_expr(self, cond);
+			for (auto body: s->if_stmt.body)
+				_link_mark_reads_in_stmt(self, body);
+			if (s->if_stmt.else_body)
+				_link_mark_reads_in_stmt(self, s->if_stmt.else_body);
+			break;
+		case Stmt::KIND_FOR:
+			if (s->for_stmt.init)
+				_link_mark_reads_in_stmt(self, s->for_stmt.init);
+			_link_mark_reads_in_expr(self, s->for_stmt.cond);
+			if (s->for_stmt.post)
+				_link_mark_reads_in_stmt(self, s->for_stmt.post);
+			_link_mark_reads_in_stmt(self, s->for_stmt.body);
+			break;
+		case Stmt::KIND_ASSIGN:
+			for (size_t i = 0; i < s->assign_stmt.lhs.count; ++i)
+			{
+				// compound assignments (+=, *=, etc...) read the assigned value
+				if (s->assign_stmt.op.kind == Tkn::KIND_EQUAL)
+					_link_mark_reads_in_lhs(self, s->assign_stmt.lhs[i]);
+				else
+					_link_mark_reads_in_expr(self, s->assign_stmt.lhs[i]);
+				_link_mark_reads_in_expr(self, s->assign_stmt.rhs[i]);
+			}
+			break;
+		case Stmt::KIND_EXPR:
+			_link_mark_reads_in_expr(self, s->expr_stmt);
+			break;
+		case Stmt::KIND_BLOCK:
+			for (auto stmt: s->block_stmt)
+				_link_mark_reads_in_stmt(self, stmt);
+			break;
+		case Stmt::KIND_DECL:
+			if (s->decl_stmt->kind == Decl::KIND_VAR)
+			{
+				for (auto value: s->decl_stmt->var_decl.values)
+					_link_mark_reads_in_expr(self, value);
+			}
+			else if (s->decl_stmt->kind == Decl::KIND_CONST)
+			{
+				for (auto value: s->decl_stmt->const_decl.values)
+					_link_mark_reads_in_expr(self, value);
+			}
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+	}
+
+	inline static bool
+	_link_is_dead_field(Link& self, const char* field)
+	{
+		return mn::set_lookup(self.dead_fields, field) != nullptr;
+	}
+
+	// returns whether the given assignment target stores into a dead field, `x.field`, `x.field.y`, and
+	// `x.field[i]` all store into the field of x
+	inline static bool
+	_link_is_dead_store(Link& self, Expr* e)
+	{
+		while (true)
+		{
+			Symbol* var = nullptr;
+			const char* field = nullptr;
+			if (_link_field_access(self, e, var, field))
+				return mn::set_lookup(self.escaped_vars, var) == nullptr && _link_is_dead_field(self, field);
+
+			if (e->kind == Expr::KIND_DOT && e->dot.lhs)
+				e = e->dot.lhs;
+			else if (e->kind == Expr::KIND_INDEXED)
+				e = e->indexed.base;
+			else
+				return false;
+		}
+	}
+
+	// removes the values of the dead fields from a compound literal of the varyings struct
+	inline static void
+	_link_strip_complit(Link& self, Expr* e)
+	{
+		if (e == nullptr || e->kind != Expr::KIND_COMPLIT || e->type != self.varyings_type)
+			return;
+
+		auto& fields = e->complit.fields;
+		for (size_t i = 0; i < fields.count; ++i)
+		{
+			// nested selectors (like `uv.x = 1.0`) are left as is
+			if (fields[i].selector_name && fields[i].selector_name->kind != Expr::KIND_ATOM)
+				continue;
+
+			auto field = self.varyings_type->struct_type.fields[fields[i].selector_index].name.str;
+			if (_link_is_dead_field(self, field) == false || expr_has_side_effects(fields[i].value))
+				continue;
+
+			mn::buf_remove_ordered(fields, i);
+			++self.stats.removed_stores;
+			--i;
+		}
+
+		// the removed fields get their default values in codegen
+		mn::map_clear(e->complit.referenced_fields);
+		for (size_t i = 0; i < fields.count; ++i)
+			mn::map_insert(e->complit.referenced_fields, fields[i].selector_index, i);
+	}
+
+	// returns whether the given expression is a local variable of the varyings struct which doesn't escape
+	inline static bool
+	_link_is_output_var(Link& self, Expr* e)
+	{
+		return (
+			e->kind == Expr::KIND_ATOM &&
+			_link_is_varyings_local(self, e->symbol) &&
+			mn::set_lookup(self.escaped_vars, e->symbol) == nullptr
+		);
+	}
+
+	inline static bool
+	_link_strip_stmt(Link& self, Stmt* s);
+
+	inline static void
+	_link_strip_block(Link& self, Stmt* s)
+	{
+		_link_enter_scope(self, s->scope);
+		mn_defer{_link_leave_scope(self, s->scope);};
+
+		mn::buf_remove_if(s->block_stmt, [&self](Stmt* stmt) { return _link_strip_stmt(self, stmt); });
+	}
+
+	inline static bool
+	_link_strip_assign_stmt(Link& self, Stmt* s)
+	{
+		if (s->assign_stmt.op.kind != Tkn::KIND_EQUAL)
+			return false;
+
+		auto& lhs = s->assign_stmt.lhs;
+		auto& rhs = s->assign_stmt.rhs;
+		for (size_t i = 0; i < lhs.count; ++i)
+		{
+			if (_link_is_output_var(self, lhs[i]))
+			{
+				_link_strip_complit(self, rhs[i]);
+				continue;
+			}
+
+			if (_link_is_dead_store(self, lhs[i]) == false)
+				continue;
+
+			if (expr_has_side_effects(lhs[i]) || expr_has_side_effects(rhs[i]))
+				continue;
+
+			mn::buf_remove_ordered(lhs, i);
+			mn::buf_remove_ordered(rhs, i);
+			++self.stats.removed_stores;
+			--i;
+		}
+		return lhs.count == 0;
+	}
+
+	inline static void
+	_link_strip_decl_stmt(Link& self, Stmt* s)
+	{
+		auto d = s->decl_stmt;
+		if (d->kind != Decl::KIND_VAR)
+			return;
+
+		auto scope = _link_current_scope(self);
+		for (size_t i = 0; i < d->var_decl.values.count; ++i)
+		{
+			auto sym = scope_find(scope, d->var_decl.names[i].str);
+			if (_link_is_varyings_local(self, sym) && mn::set_lookup(self.escaped_vars, sym) == nullptr)
+				_link_strip_complit(self, d->var_decl.values[i]);
+		}
+	}
+
+	// removes the stores into the dead fields inside the given statement, returns true if the statement itself is dead
+	inline static bool
+	_link_strip_stmt(Link& self, Stmt* s)
+	{
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+		case Stmt::KIND_DISCARD:
+		case Stmt::KIND_EXPR:
+			return false;
+		case Stmt::KIND_RETURN:
+			_link_strip_complit(self, s->return_stmt);
+			return false;
+		case Stmt::KIND_IF:
+			for (auto body: s->if_stmt.body)
+				_link_strip_block(self, body);
+			if (s->if_stmt.else_body)
+				_link_strip_block(self, s->if_stmt.else_body);
+			return false;
+		case Stmt::KIND_FOR:
+			_link_enter_scope(self, s->scope);
+			if (s->for_stmt.init && _link_strip_stmt(self, s->for_stmt.init))
+				s->for_stmt.init = nullptr;
+			if (s->for_stmt.post && _link_strip_stmt(self, s->for_stmt.post))
+				s->for_stmt.post = nullptr;
+			_link_strip_block(self, s->for_stmt.body);
+			_link_leave_scope(self, s->scope);
+			return false;
+		case Stmt::KIND_ASSIGN:
+			return _link_strip_assign_stmt(self, s);
+		case Stmt::KIND_BLOCK:
+			_link_strip_block(self, s);
+			return false;
+		case Stmt::KIND_DECL:
+			_link_strip_decl_stmt(self, s);
+			return false;
+		default:
+			mn_unreachable();
+			return false;
+		}
+	}
+
+	// collects the fields of the varyings struct which the pixel entry reads
+	inline static void
+	_link_pixel_reads(Link& self, Entry_Point* pixel, Type* pixel_type, mn::Set<const char*>& reads)
+	{
+		auto decl = symbol_decl(pixel->symbol);
+		self.varyings_type = pixel_type;
+		mn::set_clear(self.read_fields);
+		mn::set_clear(self.escaped_vars);
+		_link_mark_reads_in_stmt(self, decl->func_decl.body);
+
+		bool input_escaped = false;
+		for (const auto& arg: decl->func_decl.args)
+			for (auto name: arg.names)
+				if (mn::set_lookup(self.escaped_vars, scope_find(decl->scope, name.str)))
+					input_escaped = true;
+
+		// the whole input is used (passed to a function, copied, etc...) so we consider all its fields read
+		if (input_escaped)
+		{
+			for (const auto& field: pixel_type->struct_type.fields)
+				mn::set_insert(reads, field.name.str);
+		}
+		else
+		{
+			for (auto field: self.read_fields)
+				mn::set_insert(reads, field);
+		}
+	}
+
+	// API
+	Link_Stats
+	link_pipeline(Entry_Point* vertex, Entry_Point* pixel)
+	{
+		auto self = _link_new();
+
+		Type* pixel_type = nullptr;
+		if (_link_check_interface(vertex, pixel, pixel_type) == false)
+			return self.stats;
+
+		auto pixel_reads = mn::set_with_allocator<const char*>(mn::memory::tmp());
+		if (pixel_type)
+			_link_pixel_reads(self, pixel, pixel_type, pixel_reads);
+
+		auto vertex_type = vertex->symbol->type->as_func.sign.return_type;
+		auto vertex_fields = mn::buf_with_allocator<const Struct_Field_Type*>(mn::memory::tmp());
+		_link_varying_fields(vertex_type, vertex_fields);
+		for (auto field: vertex_fields)
+		{
+			if (mn::set_lookup(pixel_reads, field->name.str))
+				continue;
+
+			mn::set_insert(vertex->removed_varyings, field->name.str);
+			mn::set_insert(pixel->removed_varyings, field->name.str);
+			++self.stats.removed_varyings;
+		}
+
+		if (self.stats.removed_varyings == 0)
+			return self.stats;
+
+		// now we remove the stores into the removed outputs in the vertex entry, unless the entry reads them itself
+		auto decl = symbol_decl(vertex->symbol);
+		self.varyings_type = vertex_type;
+		mn::set_clear(self.read_fields);
+		mn::set_clear(self.escaped_vars);
+		_link_mark_reads_in_stmt(self, decl->func_decl.body);
+
+		for (auto field: vertex->removed_varyings)
+			if (mn::set_lookup(self.read_fields, field) == nullptr)
+				mn::set_insert(self.dead_fields, field);
+
+		if (self.dead_fields.count == 0)
+			return self.stats;
+
+		_link_enter_scope(self, decl->scope);
+		_link_strip_block(self, decl->func_decl.body);
+		_link_leave_scope(self, decl->scope);
+
+		// the code which computed the removed outputs is dead now
+		if (self.stats.removed_stores > 0)
+		{
+			auto dce_stats = dce_entry(vertex);
+			self.stats.removed_stmts = dce_stats.removed_stmts + dce_stats.removed_vars;
+		}
+		return self.stats;
+	}
+}
\ No newline at end of file
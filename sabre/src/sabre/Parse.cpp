@@ -781,9 +781,18 @@ namespace sabre
 	inline static Decl*
 	_parser_parse_decl_func(Parser& self);
 
+	inline static Tag_Table
+	_parser_parse_tags(Parser& self);
+
 	inline static Stmt*
 	_parser_parse_stmt_internal(Parser& self, bool accept_semicolon)
 	{
+		// statement tags are used as control flow hints on for and if statements
+		bool has_tags = _parser_look_kind(self, Tkn::KIND_AT);
+		Tag_Table tags{};
+		if (has_tags)
+			tags = _parser_parse_tags(self);
+
 		auto tkn = _parser_look(self);
 		Stmt* res = nullptr;
 		bool expect_semicolon = true;
@@ -859,6 +868,21 @@ namespace sabre
 			res = _parser_parse_stmt_simple(self);
 		}
 
+		if (has_tags && res != nullptr)
+		{
+			if (res->kind == Stmt::KIND_FOR || res->kind == Stmt::KIND_IF)
+			{
+				res->tags = tags;
+			}
+			else
+			{
+				Err err{};
+				err.loc = tkn.loc;
+				err.msg = mn::strf("tags are only allowed on for and if statements");
+				unit_err(self.unit, err);
+			}
+		}
+
 		// there should be a semicolon here if we don't find it we skip to it
 		if (accept_semicolon && expect_semicolon)
 		{
@@ -950,9 +974,6 @@ namespace sabre
 		return res;
 	}
 
-	inline static Tag_Table
-	_parser_parse_tags(Parser& self);
-
 	inline static Arg
 	_parser_parse_arg(Parser& self)
 	{
@@ -1219,6 +1240,12 @@ namespace sabre
 		return decl_if_new(self.unit->ast_arena, cond, body, else_body);
 	}
 
+	inline static bool
+	_parser_tag_key_is_flag(const char* key)
+	{
+		return key == KEYWORD_PACKED;
+	}
+
 	inline static Tag_Table
 	_parser_parse_tags(Parser& self)
 	{
@@ -1235,18 +1262,30 @@ namespace sabre
 				while (_parser_look_kind(self, Tkn::KIND_CLOSE_CURLY) == false)
 				{
 					auto key = _parser_eat_must(self, Tkn::KIND_ID);
-					_parser_eat_must(self, Tkn::KIND_EQUAL);
-					auto value = _parser_eat(self);
-					if (value.kind != Tkn::KIND_LITERAL_INTEGER &&
-						value.kind != Tkn::KIND_LITERAL_STRING)
+					// only flag keys (like @uniform{packed}) can omit their value, their value is an empty token
+					Tkn value{};
+					bool has_value = _parser_eat_kind(self, Tkn::KIND_EQUAL);
+					if (has_value)
+					{
+						value = _parser_eat(self);
+						if (value.kind != Tkn::KIND_LITERAL_INTEGER &&
+							value.kind != Tkn::KIND_LITERAL_STRING)
+						{
+							Err err{};
+							err.loc = value.loc;
+							err.msg = mn::strf("invalid tag value, allowed values are integers and strings");
+							unit_err(self.unit, err);
+						}
+					}
+					else if (key && _parser_tag_key_is_flag(key.str) == false)
 					{
 						Err err{};
-						err.loc = value.loc;
-						err.msg = mn::strf("invalid tag value, allowed values are integers and strings");
+						err.loc = key.loc;
+						err.msg = mn::strf("tag key '{}' requires a value", key.str);
 						unit_err(self.unit, err);
 					}
 
-					if (key && value)
+					if (key && (value || has_value == false))
 					{
 						if (auto it = mn::map_lookup(tag.args, key.str))
 						{
@@ -47,6 +47,9 @@ namespace sabre
 		case COMPILATION_MODE_GEOMETRY:
 			_generate_entry_shader_io(entry);
 			break;
+		case COMPILATION_MODE_COMPUTE:
+			// compute shaders only read system values so they have no input layout
+			break;
 		case COMPILATION_MODE_LIBRARY:
 			// library mode is not allowed here
 		default:
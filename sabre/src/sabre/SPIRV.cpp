@@ -231,7 +231,7 @@ namespace sabre
 
 		// enter function scope
 		if (d->func_decl.body != nullptr)
-			_spirv_enter_scope(self, unit_scope_find(self.unit->parent_unit, d));
+			_spirv_enter_scope(self, d->scope);
 		mn_defer{if (d->func_decl.body) _spirv_leave_scope(self);};
 
 		// add function arguments to value table
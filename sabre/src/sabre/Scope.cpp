@@ -1,8 +1,75 @@
 #include "sabre/Scope.h"
 #include "sabre/Type_Interner.h"
+#include "sabre/Unit.h"
 
 namespace sabre
 {
+	inline static const char*
+	_symbol_generate_package_name(Symbol* sym)
+	{
+		// symbols which are not added to any scope use their names as is
+		if (sym->package == nullptr || sym->scope == nullptr)
+			return sym->name;
+
+		auto unit = sym->package->parent_unit;
+		auto scope = sym->scope;
+
+		// we don't prepend scope for local variables
+		bool prepend_scope = true;
+		if (sym->kind == Symbol::KIND_VAR && sym->is_top_level == false)
+			prepend_scope = false;
+
+		auto res = mn::str_tmp();
+
+		if (prepend_scope)
+		{
+			// we want to generate the name in reverse order of the scopes hierarchy
+			auto prefix_list = mn::buf_with_allocator<const char*>(mn::memory::tmp());
+			for (auto it = scope; it != nullptr; it = it->parent)
+			{
+				auto scope_name = mn::str_lit(it->name);
+				if (scope_name.count == 0)
+					continue;
+				mn::buf_push(prefix_list, scope_name.ptr);
+			}
+
+			for (size_t i = 0; i < prefix_list.count; ++i)
+			{
+				auto prefix_name = prefix_list[prefix_list.count - i - 1];
+				res = mn::strf(res, "{}_", prefix_name);
+			}
+			res = mn::strf(res, "{}", sym->name);
+		}
+		else
+		{
+			res = mn::strf(res, "{}", sym->name);
+		}
+
+		auto interned_res = unit_intern(unit, res.ptr);
+
+		bool collided = false;
+		// try to search the already generated names for this new name and if found
+		// we'll try to make a new name for us, names are generated on first use in codegen
+		// so colliding names get their suffixes in the order they're emitted
+		for (auto it = scope; it != nullptr; it = it->parent)
+		{
+			if (auto name_it = mn::map_lookup(it->generated_names, interned_res))
+			{
+				res = mn::strf(res, "_{}", name_it->value + 1);
+				interned_res = unit_intern(unit, res.ptr);
+				++name_it->value;
+				collided = true;
+				break;
+			}
+		}
+
+		if (collided == false)
+		{
+			mn::map_insert(scope->generated_names, interned_res, (size_t)1);
+		}
+		return interned_res;
+	}
+
 	// API
 	Symbol*
 	symbol_const_new(mn::Allocator arena, Tkn name, Decl* decl, Type_Sign sign, Expr* value)
@@ -157,7 +224,6 @@ namespace sabre
 		self->state = STATE_RESOLVED;
 		self->type = type;
 		self->name = template_symbol->name;
-		self->package_name = template_symbol->package_name;
 		self->is_top_level = template_symbol->is_top_level;
 		self->dependencies = mn::set_with_allocator<Symbol*>(arena);
 		self->as_struct_instantiation.template_symbol = template_symbol;
@@ -172,7 +238,6 @@ namespace sabre
 		self->state = STATE_RESOLVED;
 		self->type = type;
 		self->name = template_symbol->name;
-		self->package_name = template_symbol->package_name;
 		self->is_top_level = template_symbol->is_top_level;
 		self->dependencies = mn::set_with_allocator<Symbol*>(arena);
 		self->as_func_instantiation.template_symbol = template_symbol;
@@ -183,10 +248,36 @@ namespace sabre
 		return self;
 	}
 
+	const char*
+	symbol_package_name(Symbol* self)
+	{
+		if (self->package_name != nullptr)
+			return self->package_name;
+
+		switch (self->kind)
+		{
+		// instantiations share the name of their template symbol
+		case Symbol::KIND_STRUCT_INSTANTIATION:
+			self->package_name = symbol_package_name(self->as_struct_instantiation.template_symbol);
+			break;
+		case Symbol::KIND_FUNC_INSTANTIATION:
+			self->package_name = symbol_package_name(self->as_func_instantiation.template_symbol);
+			break;
+		default:
+			self->package_name = _symbol_generate_package_name(self);
+			break;
+		}
+		return self->package_name;
+	}
+
 	Scope*
-	scope_new(Scope* parent, const char* name, Type* expected_type, Scope::FLAG flags)
+	scope_new(mn::Allocator arena, Scope* parent, const char* name, Type* expected_type, Scope::FLAG flags)
 	{
-		auto self = mn::alloc_zerod<Scope>();
+		auto self = mn::alloc_zerod_from<Scope>(arena);
+		self->arena = arena;
+		self->overflow_symbols = mn::buf_with_allocator<Symbol*>(arena);
+		self->symbol_table = mn::map_with_allocator<const char*, Symbol*>(arena);
+		self->generated_names = mn::map_with_allocator<const char*, size_t>(arena);
 		self->parent = parent;
 		self->name = name;
 		self->expected_type = expected_type;
@@ -199,10 +290,10 @@ namespace sabre
 	{
 		if (self)
 		{
-			mn::buf_free(self->symbols);
+			mn::buf_free(self->overflow_symbols);
 			mn::map_free(self->symbol_table);
 			mn::map_free(self->generated_names);
-			mn::free(self);
+			mn::free_from(self->arena, self);
 		}
 	}
 }
\ No newline at end of file
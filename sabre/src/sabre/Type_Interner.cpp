@@ -58,6 +58,8 @@ namespace sabre
 	static Type _type_float { Type::KIND_FLOAT, 4, 4 };
 	static Type _type_lit_float { Type::KIND_FLOAT, 4, 4 };
 	static Type _type_double { Type::KIND_DOUBLE, 8, 8 };
+	// half is a relaxed precision float, it's stored as a 32-bit float in memory
+	static Type _type_half { Type::KIND_HALF, 4, 4 };
 	static Type _type_vec2 = _vec_builtin(type_float, 2, 8, 8);
 	static Type _type_vec3 = _vec_builtin(type_float, 3, 12, 16);
 	static Type _type_vec4 = _vec_builtin(type_float, 4, 16, 16);
@@ -73,9 +75,15 @@ namespace sabre
 	static Type _type_dvec2 = _vec_builtin(type_double, 2, 16, 16);
 	static Type _type_dvec3 = _vec_builtin(type_double, 3, 24, 32);
 	static Type _type_dvec4 = _vec_builtin(type_double, 4, 32, 32);
+	static Type _type_hvec2 = _vec_builtin(type_half, 2, 8, 8);
+	static Type _type_hvec3 = _vec_builtin(type_half, 3, 12, 16);
+	static Type _type_hvec4 = _vec_builtin(type_half, 4, 16, 16);
 	static Type _type_mat2 = _mat_builtin(type_float, 2, 32, 16);
 	static Type _type_mat3 = _mat_builtin(type_float, 3, 48, 16);
 	static Type _type_mat4 = _mat_builtin(type_float, 4, 64, 16);
+	static Type _type_hmat2 = _mat_builtin(type_half, 2, 32, 16);
+	static Type _type_hmat3 = _mat_builtin(type_half, 3, 48, 16);
+	static Type _type_hmat4 = _mat_builtin(type_half, 4, 64, 16);
 	static Type _type_texture1d = _texture_builtin(TEXTURE_TYPE_1D);
 	static Type _type_texture2d = _texture_builtin(TEXTURE_TYPE_2D);
 	static Type _type_texture3d = _texture_builtin(TEXTURE_TYPE_3D);
@@ -87,6 +95,10 @@ namespace sabre
 	static Type _type_line_stream = _stream_type(Type::KIND_LINE_STREAM, &_type_line_stream_type_arg);
 	static Type _type_point_stream_type_arg {Type::KIND_TYPENAME, 0, 0};
 	static Type _type_point_stream = _stream_type(Type::KIND_POINT_STREAM, &_type_point_stream_type_arg);
+	static Type _type_buffer_type_arg {Type::KIND_TYPENAME, 0, 0};
+	static Type _type_buffer = _stream_type(Type::KIND_BUFFER, &_type_buffer_type_arg);
+	static Type _type_rw_buffer_type_arg {Type::KIND_TYPENAME, 0, 0};
+	static Type _type_rw_buffer = _stream_type(Type::KIND_RW_BUFFER, &_type_rw_buffer_type_arg);
 
 	inline static void
 	_calc_struct_size(Type* type)
@@ -107,6 +119,15 @@ namespace sabre
 		// type->unaligned_size = _round_up(type->size, type_vec4->size);
 	}
 
+	// number of padding bytes needed to place a field of the given type at the given offset
+	inline static size_t
+	_field_padding(size_t offset, Type* type)
+	{
+		if (type->alignment == 0)
+			return 0;
+		return _round_up(offset, type->alignment) - offset;
+	}
+
 	inline static Template_Instantiation_Sign
 	_generate_template_instantiation_sign(Type* base_type, const mn::Buf<Type*>& args)
 	{
@@ -136,6 +157,7 @@ namespace sabre
 	Type* type_uint = &_type_uint;
 	Type* type_float = &_type_float;
 	Type* type_double = &_type_double;
+	Type* type_half = &_type_half;
 	Type* type_vec2 = &_type_vec2;
 	Type* type_vec3 = &_type_vec3;
 	Type* type_vec4 = &_type_vec4;
@@ -151,9 +173,15 @@ namespace sabre
 	Type* type_dvec2 = &_type_dvec2;
 	Type* type_dvec3 = &_type_dvec3;
 	Type* type_dvec4 = &_type_dvec4;
+	Type* type_hvec2 = &_type_hvec2;
+	Type* type_hvec3 = &_type_hvec3;
+	Type* type_hvec4 = &_type_hvec4;
 	Type* type_mat2 = &_type_mat2;
 	Type* type_mat3 = &_type_mat3;
 	Type* type_mat4 = &_type_mat4;
+	Type* type_hmat2 = &_type_hmat2;
+	Type* type_hmat3 = &_type_hmat3;
+	Type* type_hmat4 = &_type_hmat4;
 	Type* type_texture1d = &_type_texture1d;
 	Type* type_texture2d = &_type_texture2d;
 	Type* type_texture3d = &_type_texture3d;
@@ -162,6 +190,8 @@ namespace sabre
 	Type* type_triangle_stream = &_type_triangle_stream;
 	Type* type_line_stream = &_type_line_stream;
 	Type* type_point_stream = &_type_point_stream;
+	Type* type_buffer = &_type_buffer;
+	Type* type_rw_buffer = &_type_rw_buffer;
 
 	Type_Interner*
 	type_interner_new()
@@ -272,6 +302,8 @@ namespace sabre
 		case Type::KIND_TRIANGLE_STREAM:
 		case Type::KIND_LINE_STREAM:
 		case Type::KIND_POINT_STREAM:
+		case Type::KIND_BUFFER:
+		case Type::KIND_RW_BUFFER:
 		{
 			auto new_type = mn::alloc_zerod_from<Type>(self->arena);
 			new_type->kind = base_type->kind;
@@ -551,4 +583,154 @@ namespace sabre
 		mn::buf_free(sign.args);
 		return nullptr;
 	}
+
+	mn::Buf<Struct_Field_Type>
+	type_interner_packed_uniform_fields(Type_Interner* self, Type* type)
+	{
+		mn_assert(type->kind == Type::KIND_STRUCT);
+
+		auto fields = mn::buf_memcpy_clone(type->struct_type.fields, self->arena);
+		size_t offset = 0;
+		for (size_t i = 0; i < fields.count; ++i)
+		{
+			// we pick the field which needs the least padding at the current offset, ties go to the larger field
+			// so that the smaller ones are left to fill the holes, then to the declaration order
+			auto best = i;
+			auto best_padding = _field_padding(offset, fields[i].type);
+			for (size_t j = i + 1; j < fields.count; ++j)
+			{
+				auto padding = _field_padding(offset, fields[j].type);
+				if (padding < best_padding ||
+					(padding == best_padding && fields[j].type->unaligned_size > fields[best].type->unaligned_size))
+				{
+					best = j;
+					best_padding = padding;
+				}
+			}
+
+			// move the picked field into place while keeping the order of the rest of the fields
+			auto field = fields[best];
+			for (auto j = best; j > i; --j)
+				fields[j] = fields[j - 1];
+
+			field.offset = offset + best_padding;
+			offset = field.offset + field.type->unaligned_size;
+			// std140 starts the member which follows a struct or an array at the next vec4 boundary while HLSL
+			// packs it into the remaining space, so we skip that space to keep both backends on the same offsets
+			if (field.type->kind == Type::KIND_STRUCT || field.type->kind == Type::KIND_ARRAY)
+				offset = _round_up(offset, type_vec4->alignment);
+			fields[i] = field;
+		}
+		return fields;
+	}
+
+	size_t
+	type_std430_alignment(Type* type)
+	{
+		switch (type->kind)
+		{
+		case Type::KIND_BOOL:
+			// bools are stored as 32 bit values in buffers
+			return 4;
+		case Type::KIND_ENUM:
+			return type_int->alignment;
+		case Type::KIND_MAT:
+			// matrices are stored as arrays of column vectors
+			return type->mat.width == 2 ? type->mat.base->alignment * 2 : type->mat.base->alignment * 4;
+		case Type::KIND_ARRAY:
+			return type_std430_alignment(type->array.base);
+		case Type::KIND_STRUCT:
+		{
+			size_t res = 1;
+			for (const auto& field: type->struct_type.fields)
+			{
+				auto field_alignment = type_std430_alignment(field.type);
+				if (field_alignment > res)
+					res = field_alignment;
+			}
+			return res;
+		}
+		default:
+			return type->alignment;
+		}
+	}
+
+	size_t
+	type_std430_size(Type* type)
+	{
+		switch (type->kind)
+		{
+		case Type::KIND_BOOL:
+			return 4;
+		case Type::KIND_ENUM:
+			return type_int->unaligned_size;
+		case Type::KIND_MAT:
+			return type->mat.width * type_std430_alignment(type);
+		case Type::KIND_ARRAY:
+			if (type->array.count < 0)
+				return 0;
+			return type_std430_stride(type->array.base) * type->array.count;
+		case Type::KIND_STRUCT:
+		{
+			size_t offset = 0;
+			for (const auto& field: type->struct_type.fields)
+				offset = _round_up(offset, type_std430_alignment(field.type)) + type_std430_size(field.type);
+			return _round_up(offset, type_std430_alignment(type));
+		}
+		default:
+			return type->unaligned_size;
+		}
+	}
+
+	size_t
+	type_std430_stride(Type* type)
+	{
+		return _round_up(type_std430_size(type), type_std430_alignment(type));
+	}
+
+	bool
+	type_std430_is_tightly_packed(Type* type)
+	{
+		switch (type->kind)
+		{
+		case Type::KIND_MAT:
+			// the columns of 3x3 matrices are padded to the size of a vec4
+			return type_std430_size(type) == type->mat.width * type->mat.width * type->mat.base->unaligned_size;
+		case Type::KIND_ARRAY:
+			return (
+				type_std430_is_tightly_packed(type->array.base) &&
+				type_std430_stride(type->array.base) == type_std430_size(type->array.base)
+			);
+		case Type::KIND_STRUCT:
+		{
+			size_t offset = 0;
+			for (const auto& field: type->struct_type.fields)
+			{
+				if (_round_up(offset, type_std430_alignment(field.type)) != offset)
+					return false;
+				if (type_std430_is_tightly_packed(field.type) == false)
+					return false;
+				offset += type_std430_size(field.type);
+			}
+			return _round_up(offset, type_std430_alignment(type)) == offset;
+		}
+		default:
+			return true;
+		}
+	}
+
+	mn::Buf<Struct_Field_Type>
+	type_interner_std430_fields(Type_Interner* self, Type* type)
+	{
+		mn_assert(type->kind == Type::KIND_STRUCT);
+
+		auto fields = mn::buf_memcpy_clone(type->struct_type.fields, self->arena);
+		size_t offset = 0;
+		for (auto& field: fields)
+		{
+			field.offset = _round_up(offset, type_std430_alignment(field.type));
+			offset = field.offset + type_std430_size(field.type);
+		}
+		return fields;
+	}
 }
\ No newline at end of file
@@ -8,6 +8,15 @@
 #include "sabre/SPIRV.h"
 #include "sabre/IR_Text.h"
 #include "sabre/Type_Interner.h"
+#include "sabre/Inline.h"
+#include "sabre/Unroll.h"
+#include "sabre/Fast_Math.h"
+#include "sabre/DCE.h"
+#include "sabre/LICM.h"
+#include "sabre/CSE.h"
+#include "sabre/If_Conversion.h"
+#include "sabre/Link.h"
+#include "sabre/Binding.h"
 
 #include <mn/Path.h>
 #include <mn/IO.h>
@@ -48,6 +57,11 @@ namespace sabre
 		case Type::KIND_ARRAY:
 			_push_type(types, t->array.base);
 			break;
+		case Type::KIND_BUFFER:
+		case Type::KIND_RW_BUFFER:
+			// buffers are reported in their own section, only their elements are listed in the types
+			_push_type(types, type_buffer_element(t));
+			return;
 		default:
 			break;
 		}
@@ -81,6 +95,10 @@ namespace sabre
 		{
 			return mn::str_lit("double");
 		}
+		else if (t == type_half)
+		{
+			return mn::str_lit("half");
+		}
 		else if (t == type_vec2)
 		{
 			return mn::str_lit("vec2");
@@ -141,6 +159,18 @@ namespace sabre
 		{
 			return mn::str_lit("dvec4");
 		}
+		else if (t == type_hvec2)
+		{
+			return mn::str_lit("hvec2");
+		}
+		else if (t == type_hvec3)
+		{
+			return mn::str_lit("hvec3");
+		}
+		else if (t == type_hvec4)
+		{
+			return mn::str_lit("hvec4");
+		}
 		else if (t == type_mat2)
 		{
 			return mn::str_lit("mat2");
@@ -153,6 +183,18 @@ namespace sabre
 		{
 			return mn::str_lit("mat4");
 		}
+		else if (t == type_hmat2)
+		{
+			return mn::str_lit("hmat2");
+		}
+		else if (t == type_hmat3)
+		{
+			return mn::str_lit("hmat3");
+		}
+		else if (t == type_hmat4)
+		{
+			return mn::str_lit("hmat4");
+		}
 		else if (t->kind == Type::KIND_FUNC)
 		{
 			auto name = mn::str_tmp();
@@ -234,6 +276,14 @@ namespace sabre
 			else
 				return mn::str_lit(t->enum_type.symbol->name);
 		}
+		else if (type_is_buffer(t))
+		{
+			auto element = _type_to_reflect_json(type_buffer_element(t), is_raw);
+			if (t->kind == Type::KIND_BUFFER)
+				return mn::str_tmpf("Buffer<{}>", element);
+			else
+				return mn::str_tmpf("RWBuffer<{}>", element);
+		}
 		else
 		{
 			mn_unreachable();
@@ -252,6 +302,7 @@ namespace sabre
 			t == type_float ||
 			t == type_lit_float ||
 			t == type_double ||
+			t == type_half ||
 			t == type_vec2 ||
 			t == type_vec3 ||
 			t == type_vec4 ||
@@ -267,9 +318,15 @@ namespace sabre
 			t == type_dvec2 ||
 			t == type_dvec3 ||
 			t == type_dvec4 ||
+			t == type_hvec2 ||
+			t == type_hvec3 ||
+			t == type_hvec4 ||
 			t == type_mat2 ||
 			t == type_mat3 ||
 			t == type_mat4 ||
+			t == type_hmat2 ||
+			t == type_hmat3 ||
+			t == type_hmat4 ||
 			t->kind == Type::KIND_TEXTURE)
 		{
 			return mn::str_lit("builtin");
@@ -322,6 +379,10 @@ namespace sabre
 					case Tkn::KIND_LITERAL_STRING:
 						value = mn::json::value_string_new(arg_value.value.str);
 						break;
+					case Tkn::KIND_NONE:
+						// flag keys
+						value = mn::json::value_bool_new(true);
+						break;
 					default:
 						mn_unreachable();
 						break;
@@ -334,6 +395,45 @@ namespace sabre
 		return json_tags;
 	}
 
+	// number of bytes which are occupied by the values of the given type, it doesn't count the padding
+	// inside nested structs and between array elements
+	inline static size_t
+	_type_used_size(Type* type)
+	{
+		switch (type->kind)
+		{
+		case Type::KIND_STRUCT:
+		{
+			size_t res = 0;
+			for (const auto& field: type->struct_type.fields)
+				res += _type_used_size(field.type);
+			return res;
+		}
+		case Type::KIND_ARRAY:
+			if (type->array.count < 0)
+				return 0;
+			return _type_used_size(type->array.base) * type->array.count;
+		default:
+			return type->unaligned_size;
+		}
+	}
+
+	// number of bytes in the uniform block which are not occupied by its fields, uniform blocks are
+	// allocated in vec4 units so the padding at the end of the block is counted as well
+	inline static size_t
+	_uniform_padding(Symbol* sym)
+	{
+		auto type = sym->type;
+		size_t used_size = _type_used_size(type);
+		if (type->kind == Type::KIND_STRUCT)
+		{
+			used_size = 0;
+			for (const auto& field: sym->var_sym.uniform_fields)
+				used_size += _type_used_size(field.type);
+		}
+		return _round_up(sym->var_sym.uniform_size, type_vec4->alignment) - used_size;
+	}
+
 	inline static void
 	_entry_point_sym_sort(Entry_Point* entry, Symbol* sym, mn::Set<Symbol*>& visited, mn::Set<Symbol*>& visiting)
 	{
@@ -356,6 +456,162 @@ namespace sabre
 		}
 	}
 
+	struct Reachable_Funcs_Walker
+	{
+		void (*fn)(void* user_data, Decl* d);
+		void* user_data;
+		// functions and packages which we have already visited
+		mn::Set<Decl*> visited_funcs;
+		mn::Set<Unit_Package*> visited_packages;
+	};
+
+	inline static void
+	_reachable_funcs_walk_func(Reachable_Funcs_Walker& self, Decl* d)
+	{
+		if (d == nullptr || d->func_decl.body == nullptr)
+			return;
+
+		if (mn::set_lookup(self.visited_funcs, d))
+			return;
+		mn::set_insert(self.visited_funcs, d);
+
+		self.fn(self.user_data, d);
+	}
+
+	inline static void
+	_reachable_funcs_walk_symbol(Reachable_Funcs_Walker& self, Symbol* sym)
+	{
+		switch (sym->kind)
+		{
+		case Symbol::KIND_FUNC:
+			// templated functions are processed through their instantiations
+			if (sym->func_sym.decl->template_args.count == 0)
+				_reachable_funcs_walk_func(self, sym->func_sym.decl);
+			break;
+		case Symbol::KIND_FUNC_OVERLOAD_SET:
+			for (auto decl: sym->func_overload_set_sym.used_decls)
+				_reachable_funcs_walk_func(self, decl);
+			break;
+		case Symbol::KIND_FUNC_INSTANTIATION:
+			_reachable_funcs_walk_func(self, sym->as_func_instantiation.decl);
+			break;
+		default:
+			break;
+		}
+	}
+
+	inline static void
+	_reachable_funcs_walk_package(Reachable_Funcs_Walker& self, Unit_Package* package)
+	{
+		if (mn::set_lookup(self.visited_packages, package))
+			return;
+		mn::set_insert(self.visited_packages, package);
+
+		for (auto sym: package->reachable_symbols)
+		{
+			if (sym->kind == Symbol::KIND_PACKAGE)
+				_reachable_funcs_walk_package(self, sym->package_sym.package);
+			else
+				_reachable_funcs_walk_symbol(self, sym);
+		}
+	}
+
+	#if SABRE_LOG_METRICS
+	inline static void
+	_unit_log_pass_stats(const Inline_Stats& stats, std::chrono::duration<double, std::milli> time)
+	{
+		mn::log_info("Inliner inlined {} calls, removed {} functions, time {}", stats.inlined_calls, stats.removed_funcs, time);
+	}
+
+	inline static void
+	_unit_log_pass_stats(const Unroll_Stats& stats, std::chrono::duration<double, std::milli> time)
+	{
+		mn::log_info("Unroller unrolled {} loops into {} iterations, time {}", stats.unrolled_loops, stats.unrolled_iterations, time);
+	}
+
+	inline static void
+	_unit_log_pass_stats(const Fast_Math_Stats& stats, std::chrono::duration<double, std::milli> time)
+	{
+		mn::log_info("Fast math rewrote {} expressions, time {}", stats.rewritten_exprs, time);
+	}
+
+	inline static void
+	_unit_log_pass_stats(const DCE_Stats& stats, std::chrono::duration<double, std::milli> time)
+	{
+		mn::log_info("DCE removed {} statements, {} variables, {} branches, time {}", stats.removed_stmts, stats.removed_vars, stats.removed_branches, time);
+	}
+
+	inline static void
+	_unit_log_pass_stats(const LICM_Stats& stats, std::chrono::duration<double, std::milli> time)
+	{
+		mn::log_info("LICM hoisted {} expressions out of {} loops, time {}", stats.hoisted_exprs, stats.optimized_loops, time);
+	}
+
+	inline static void
+	_unit_log_pass_stats(const CSE_Stats& stats, std::chrono::duration<double, std::milli> time)
+	{
+		mn::log_info("CSE hoisted {} expressions, reused {} expressions, {} texture samples, time {}", stats.hoisted_exprs, stats.reused_exprs, stats.reused_samples, time);
+	}
+
+	inline static void
+	_unit_log_pass_stats(const If_Conversion_Stats& stats, std::chrono::duration<double, std::milli> time)
+	{
+		mn::log_info("If conversion converted {} branches to selects, time {}", stats.converted_ifs, time);
+	}
+	#endif
+
+	// runs the given optimization pass if it's enabled on the given entry, or on the root package in library mode
+	template<typename TStats>
+	inline static void
+	_unit_run_pass(Unit* self, Entry_Point* entry, bool enabled, TStats (*entry_pass)(Entry_Point*), TStats (*package_pass)(Unit_Package*))
+	{
+		if (enabled == false)
+			return;
+
+		auto start = _capture_timepoint();
+		auto stats = entry ? entry_pass(entry) : package_pass(self->root_package);
+		auto end = _capture_timepoint();
+
+		#if SABRE_LOG_METRICS
+		_unit_log_pass_stats(stats, end - start);
+		#endif
+	}
+
+	// runs the enabled optimization passes on the given entry, or on the root package in library mode
+	inline static void
+	_unit_optimize(Unit* self, Entry_Point* entry)
+	{
+		if (entry && entry->is_optimized)
+			return;
+
+		_unit_run_pass(self, entry, self->options.inline_functions, inline_entry, inline_package);
+		_unit_run_pass(self, entry, self->options.unroll_loops, unroll_entry, unroll_package);
+		_unit_run_pass(self, entry, self->options.fast_math, fast_math_entry, fast_math_package);
+		_unit_run_pass(self, entry, self->options.eliminate_dead_code, dce_entry, dce_package);
+		_unit_run_pass(self, entry, self->options.hoist_loop_invariants, licm_entry, licm_package);
+		_unit_run_pass(self, entry, self->options.eliminate_common_subexpressions, cse_entry, cse_package);
+		_unit_run_pass(self, entry, self->options.convert_branches_to_selects, if_conversion_entry, if_conversion_package);
+
+		if (entry)
+			entry->is_optimized = true;
+	}
+
+	// solves the binding layout of the given entries, it replaces the previously solved layout
+	inline static bool
+	_unit_solve_bindings(Unit* self, const mn::Buf<Entry_Point*>& entries, const mn::Buf<Symbol*>& unreachable)
+	{
+		auto start = _capture_timepoint();
+		binding_layout_free(self->binding_layout);
+		self->binding_layout = binding_layout_solve(self, entries, unreachable);
+		auto end = _capture_timepoint();
+
+		#if SABRE_LOG_METRICS
+		mn::log_info("Binding layout has {} resources, time {}", self->binding_layout.slots.count, end - start);
+		#endif
+
+		return unit_has_errors(self) == false;
+	}
+
 
 	// API
 	Unit_File*
@@ -389,7 +645,6 @@ namespace sabre
 		mn::buf_free(self->lines);
 		mn::allocator_free(self->ast_arena);
 		mn::buf_free(self->decls);
-		scope_free(self->file_scope);
 		mn::free(self);
 	}
 
@@ -514,12 +769,35 @@ namespace sabre
 		_entry_point_sym_sort(entry, entry->symbol, visited, visiting);
 	}
 
+	void
+	unit_reachable_funcs_walk(Entry_Point* entry, Unit_Package* package, void (*fn)(void* user_data, Decl* d), void* user_data)
+	{
+		Reachable_Funcs_Walker self{};
+		self.fn = fn;
+		self.user_data = user_data;
+		self.visited_funcs = mn::set_with_allocator<Decl*>(mn::memory::tmp());
+		self.visited_packages = mn::set_with_allocator<Unit_Package*>(mn::memory::tmp());
+
+		if (entry)
+		{
+			entry_point_calc_reachable_list(entry);
+			for (auto sym: entry->reachable_symbols)
+				_reachable_funcs_walk_symbol(self, sym);
+			_reachable_funcs_walk_symbol(self, entry->symbol);
+		}
+		else
+		{
+			_reachable_funcs_walk_package(self, package);
+		}
+	}
+
 	Unit_Package*
 	unit_package_new()
 	{
 		auto self = mn::alloc_zerod<Unit_Package>();
 		self->stage = COMPILATION_STAGE_SCAN;
 		self->symbols_arena = mn::allocator_arena_new();
+		self->scopes_arena = mn::allocator_arena_new();
 		return self;
 	}
 
@@ -532,6 +810,11 @@ namespace sabre
 			self->absolute_path,
 			self->symbols_arena->used_mem, self->symbols_arena->total_mem
 		);
+		mn::log_info(
+			"Package '{}': Scopes {}/{}, (used/reserved)bytes",
+			self->absolute_path,
+			self->scopes_arena->used_mem, self->scopes_arena->total_mem
+		);
 		#endif
 
 		mn::str_free(self->absolute_path);
@@ -541,7 +824,8 @@ namespace sabre
 		destruct(self->entry_points);
 		mn::buf_free(self->reachable_symbols);
 		mn::allocator_free(self->symbols_arena);
-		scope_free(self->global_scope);
+		// global scope and all the other scopes are allocated from the scopes arena
+		mn::allocator_free(self->scopes_arena);
 		mn::buf_free(self->imported_packages);
 		mn::free(self);
 	}
@@ -635,10 +919,10 @@ namespace sabre
 			{
 				self->stage = COMPILATION_STAGE_CHECK;
 				self->name = package_name;
-				self->global_scope = scope_new(nullptr, self->name.str, nullptr, Scope::FLAG_NONE);
+				self->global_scope = scope_new(self->scopes_arena, nullptr, self->name.str, nullptr, Scope::FLAG_NONE);
 
 				for (auto file: self->files)
-					file->file_scope = scope_new(self->global_scope, "", nullptr, Scope::FLAG_NONE);
+					file->file_scope = scope_new(self->scopes_arena, self->global_scope, "", nullptr, Scope::FLAG_NONE);
 			}
 
 			auto end = _capture_timepoint();
@@ -756,6 +1040,27 @@ namespace sabre
 		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_POINT));
 		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_LINE));
 		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_TRIANGLE));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_UNROLL));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_LOOP));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_BRANCH));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_FLATTEN));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_COUNT));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_INLINE));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_NOINLINE));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_PACKED));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_FREQUENCY));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_PUSH_CONSTANT));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_COMPUTE));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_X));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_Y));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_Z));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_SHARED));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_SV_DISPATCH_THREAD_ID));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_SV_GROUP_ID));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_SV_GROUP_THREAD_ID));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_SV_GROUP_INDEX));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_SUBGROUP));
+		mn::set_insert(self->str_interner.strings, mn::str_lit(KEYWORD_GLSL_EXTENSION));
 
 		unit_add_package(self, self->root_package);
 
@@ -774,12 +1079,9 @@ namespace sabre
 
 		mn::str_intern_free(self->str_interner);
 		type_interner_free(self->type_interner);
-		destruct(self->scope_table);
 		destruct(self->packages);
 		mn::map_free(self->absolute_path_to_package);
-		mn::map_free(self->reachable_uniforms);
-		mn::map_free(self->reachable_textures);
-		mn::map_free(self->reachable_samplers);
+		binding_layout_free(self->binding_layout);
 		mn::buf_free(self->reflected_symbols);
 		destruct(self->library_collections);
 		mn::buf_free(self->symbol_stack);
@@ -846,6 +1148,14 @@ namespace sabre
 			if (unit_package_check(package) == false)
 				has_errors = true;
 		}
+
+		// all the entries of the file share one binding layout so the stages agree on the bindings
+		auto entries = mn::buf_with_allocator<Entry_Point*>(mn::memory::tmp());
+		for (auto package: self->packages)
+			for (auto entry: package->entry_points)
+				mn::buf_push(entries, entry);
+		if (_unit_solve_bindings(self, entries, self->all_uniforms) == false)
+			has_errors = true;
 		auto end = _capture_timepoint();
 		#if SABRE_LOG_METRICS
 		mn::log_info("Total checking time {}", end - start);
@@ -863,6 +1173,45 @@ namespace sabre
 		return true;
 	}
 
+	bool
+	unit_link_pipeline(Unit* self, Entry_Point* vertex, Entry_Point* pixel)
+	{
+		Entry_Point* entries[] = {vertex, pixel};
+		for (auto entry: entries)
+		{
+			auto typer = typer_new(entry->symbol->package);
+			typer_check_entry(typer, entry);
+			typer_free(typer);
+		}
+
+		if (unit_has_errors(self))
+			return false;
+
+		// narrow the binding layout down to the resources of this pipeline so it stays dense
+		auto entries = mn::buf_with_allocator<Entry_Point*>(mn::memory::tmp());
+		mn::buf_push(entries, vertex);
+		mn::buf_push(entries, pixel);
+		auto unreachable = mn::buf_with_allocator<Symbol*>(mn::memory::tmp());
+		if (_unit_solve_bindings(self, entries, unreachable) == false)
+			return false;
+
+		_unit_optimize(self, vertex);
+		_unit_optimize(self, pixel);
+
+		auto start = _capture_timepoint();
+		auto stats = link_pipeline(vertex, pixel);
+		auto end = _capture_timepoint();
+
+		#if SABRE_LOG_METRICS
+		mn::log_info(
+			"Linker removed {} varyings, {} stores, {} statements, time {}",
+			stats.removed_varyings, stats.removed_stores, stats.removed_stmts, end - start
+		);
+		#endif
+
+		return unit_has_errors(self) == false;
+	}
+
 	mn::Str
 	unit_reflection_info_as_json(Unit* self, Entry_Point* entry, mn::Allocator allocator)
 	{
@@ -884,6 +1233,14 @@ namespace sabre
 				_push_type(types, attribute_type);
 			}
 			mn::json::value_object_insert(json_entry, "input_layout", json_layout);
+
+			if (entry->mode == COMPILATION_MODE_COMPUTE)
+			{
+				auto json_workgroup_size = mn::json::value_array_new();
+				for (auto size: entry->workgroup_size)
+					mn::json::value_array_push(json_workgroup_size, mn::json::value_number_new(size));
+				mn::json::value_object_insert(json_entry, "workgroup_size", json_workgroup_size);
+			}
 		}
 
 		auto json_uniforms = mn::json::value_array_new();
@@ -903,9 +1260,29 @@ namespace sabre
 				mn::json::value_object_insert(json_uniform, "name", uniform_name);
 			}
 			mn::json::value_object_insert(json_uniform, "binding", mn::json::value_number_new(binding));
+			mn::json::value_object_insert(json_uniform, "set", mn::json::value_number_new(symbol->var_sym.uniform_set));
 			mn::json::value_object_insert(json_uniform, "type", mn::json::value_string_new(_type_to_reflect_json(symbol->type, false)));
 			mn::json::value_object_insert(json_uniform, "tags", _decl_tags_to_json(symbol_decl(symbol)));
-			mn::json::value_object_insert(json_uniform, "size", mn::json::value_number_new(symbol->type->unaligned_size));
+			mn::json::value_object_insert(json_uniform, "size", mn::json::value_number_new(symbol->var_sym.uniform_size));
+			mn::json::value_object_insert(json_uniform, "padding", mn::json::value_number_new(_uniform_padding(symbol)));
+
+			// packed uniforms don't follow the layout of their struct type so we report their fields here
+			if (auto uniform_tag_it = mn::map_lookup(symbol_decl(symbol)->tags.table, KEYWORD_UNIFORM))
+			{
+				if (mn::map_lookup(uniform_tag_it->value.args, KEYWORD_PACKED))
+				{
+					auto json_fields = mn::json::value_array_new();
+					for (const auto& field: symbol->var_sym.uniform_fields)
+					{
+						auto json_field = mn::json::value_object_new();
+						mn::json::value_object_insert(json_field, "name", mn::json::value_string_new(field.name.str));
+						mn::json::value_object_insert(json_field, "type", mn::json::value_string_new(_type_to_reflect_json(field.type, false)));
+						mn::json::value_object_insert(json_field, "offset", mn::json::value_number_new(field.offset));
+						mn::json::value_array_push(json_fields, json_field);
+					}
+					mn::json::value_object_insert(json_uniform, "fields", json_fields);
+				}
+			}
 
 			mn::json::value_array_push(json_uniforms, json_uniform);
 
@@ -929,6 +1306,7 @@ namespace sabre
 				mn::json::value_object_insert(json_texture, "name", uniform_name);
 			}
 			mn::json::value_object_insert(json_texture, "binding", mn::json::value_number_new(binding));
+			mn::json::value_object_insert(json_texture, "set", mn::json::value_number_new(symbol->var_sym.uniform_set));
 			mn::json::value_object_insert(json_texture, "type", mn::json::value_string_new(_type_to_reflect_json(symbol->type, false)));
 			mn::json::value_object_insert(json_texture, "tags", _decl_tags_to_json(symbol_decl(symbol)));
 			mn::json::value_array_push(json_textures, json_texture);
@@ -936,6 +1314,168 @@ namespace sabre
 			_push_type(types, symbol->type);
 		}
 
+		auto json_buffers = mn::json::value_array_new();
+		for (auto symbol: entry->buffers)
+		{
+			mn_assert(symbol->kind == Symbol::KIND_VAR);
+			auto binding = symbol->var_sym.uniform_binding;
+			auto element_type = type_buffer_element(symbol->type);
+
+			auto json_buffer = mn::json::value_object_new();
+			if (symbol->package == self->root_package)
+			{
+				mn::json::value_object_insert(json_buffer, "name", mn::json::value_string_new(symbol->name));
+			}
+			else
+			{
+				auto uniform_name = mn::json::value_string_new(mn::str_tmpf("{}.{}", symbol->package->name.str, symbol->name));
+				mn::json::value_object_insert(json_buffer, "name", uniform_name);
+			}
+			mn::json::value_object_insert(json_buffer, "binding", mn::json::value_number_new(binding));
+			mn::json::value_object_insert(json_buffer, "set", mn::json::value_number_new(symbol->var_sym.uniform_set));
+			mn::json::value_object_insert(json_buffer, "type", mn::json::value_string_new(_type_to_reflect_json(symbol->type, false)));
+			mn::json::value_object_insert(json_buffer, "tags", _decl_tags_to_json(symbol_decl(symbol)));
+			mn::json::value_object_insert(json_buffer, "access", mn::json::value_string_new(symbol->type->kind == Type::KIND_BUFFER ? "read" : "read_write"));
+			mn::json::value_object_insert(json_buffer, "element_type", mn::json::value_string_new(_type_to_reflect_json(element_type, false)));
+			mn::json::value_object_insert(json_buffer, "stride", mn::json::value_number_new(type_std430_stride(element_type)));
+
+			// buffers use the std430 layout, so the offsets of struct elements differ from the ones in the types
+			if (element_type->kind == Type::KIND_STRUCT)
+			{
+				auto json_fields = mn::json::value_array_new();
+				for (const auto& field: type_interner_std430_fields(self->type_interner, element_type))
+				{
+					auto json_field = mn::json::value_object_new();
+					mn::json::value_object_insert(json_field, "name", mn::json::value_string_new(field.name.str));
+					mn::json::value_object_insert(json_field, "type", mn::json::value_string_new(_type_to_reflect_json(field.type, false)));
+					mn::json::value_object_insert(json_field, "offset", mn::json::value_number_new(field.offset));
+					mn::json::value_array_push(json_fields, json_field);
+				}
+				mn::json::value_object_insert(json_buffer, "fields", json_fields);
+			}
+
+			mn::json::value_array_push(json_buffers, json_buffer);
+
+			_push_type(types, symbol->type);
+		}
+
+		auto json_push_constants = mn::json::value_array_new();
+		if (auto symbol = entry->push_constant)
+		{
+			auto json_push_constant = mn::json::value_object_new();
+			if (symbol->package == self->root_package)
+			{
+				mn::json::value_object_insert(json_push_constant, "name", mn::json::value_string_new(symbol->name));
+			}
+			else
+			{
+				auto uniform_name = mn::json::value_string_new(mn::str_tmpf("{}.{}", symbol->package->name.str, symbol->name));
+				mn::json::value_object_insert(json_push_constant, "name", uniform_name);
+			}
+			mn::json::value_object_insert(json_push_constant, "type", mn::json::value_string_new(_type_to_reflect_json(symbol->type, false)));
+			mn::json::value_object_insert(json_push_constant, "tags", _decl_tags_to_json(symbol_decl(symbol)));
+			mn::json::value_object_insert(json_push_constant, "size", mn::json::value_number_new(symbol->var_sym.uniform_size));
+
+			auto json_fields = mn::json::value_array_new();
+			for (const auto& field: symbol->var_sym.uniform_fields)
+			{
+				auto json_field = mn::json::value_object_new();
+				mn::json::value_object_insert(json_field, "name", mn::json::value_string_new(field.name.str));
+				mn::json::value_object_insert(json_field, "type", mn::json::value_string_new(_type_to_reflect_json(field.type, false)));
+				mn::json::value_object_insert(json_field, "offset", mn::json::value_number_new(field.offset));
+				mn::json::value_array_push(json_fields, json_field);
+			}
+			mn::json::value_object_insert(json_push_constant, "fields", json_fields);
+
+			// in HLSL push constants are root constants, the engine needs their register and 32 bit values count
+			// to build the root signature
+			auto json_root_constant = mn::json::value_object_new();
+			mn::json::value_object_insert(json_root_constant, "register", mn::json::value_number_new(0));
+			mn::json::value_object_insert(json_root_constant, "space", mn::json::value_number_new(PUSH_CONSTANT_SPACE));
+			mn::json::value_object_insert(json_root_constant, "num_32bit_values", mn::json::value_number_new((symbol->var_sym.uniform_size + 3) / 4));
+			mn::json::value_object_insert(json_push_constant, "root_constant", json_root_constant);
+
+			mn::json::value_array_push(json_push_constants, json_push_constant);
+
+			_push_type(types, symbol->type);
+		}
+
+		// the binding layout shared by all the stages grouped by update frequency, so one descriptor set layout can
+		// be built for each frequency of the pipeline
+		mn::json::Value json_resources[BINDING_FREQUENCY_COUNT]{};
+		size_t resources_count[BINDING_FREQUENCY_COUNT]{};
+		for (size_t i = 0; i < BINDING_FREQUENCY_COUNT; ++i)
+			json_resources[i] = mn::json::value_array_new();
+
+		for (const auto& slot: self->binding_layout.slots)
+		{
+			auto symbol = slot.symbol;
+
+			auto json_binding = mn::json::value_object_new();
+			switch (slot.kind)
+			{
+			case Binding_Slot::KIND_UNIFORM:
+				mn::json::value_object_insert(json_binding, "kind", mn::json::value_string_new("uniform"));
+				break;
+			case Binding_Slot::KIND_TEXTURE:
+				mn::json::value_object_insert(json_binding, "kind", mn::json::value_string_new("texture"));
+				break;
+			case Binding_Slot::KIND_SAMPLER:
+				mn::json::value_object_insert(json_binding, "kind", mn::json::value_string_new("sampler"));
+				break;
+			case Binding_Slot::KIND_BUFFER:
+				mn::json::value_object_insert(json_binding, "kind", mn::json::value_string_new("buffer"));
+				break;
+			case Binding_Slot::KIND_RW_BUFFER:
+				mn::json::value_object_insert(json_binding, "kind", mn::json::value_string_new("rw_buffer"));
+				break;
+			default:
+				mn_unreachable();
+				break;
+			}
+
+			if (symbol->package == self->root_package)
+			{
+				mn::json::value_object_insert(json_binding, "name", mn::json::value_string_new(symbol->name));
+			}
+			else
+			{
+				auto uniform_name = mn::json::value_string_new(mn::str_tmpf("{}.{}", symbol->package->name.str, symbol->name));
+				mn::json::value_object_insert(json_binding, "name", uniform_name);
+			}
+			mn::json::value_object_insert(json_binding, "binding", mn::json::value_number_new(slot.binding));
+
+			auto json_stages = mn::json::value_array_new();
+			if (slot.stages & (1 << COMPILATION_MODE_VERTEX))
+				mn::json::value_array_push(json_stages, mn::json::value_string_new("vertex"));
+			if (slot.stages & (1 << COMPILATION_MODE_PIXEL))
+				mn::json::value_array_push(json_stages, mn::json::value_string_new("pixel"));
+			if (slot.stages & (1 << COMPILATION_MODE_GEOMETRY))
+				mn::json::value_array_push(json_stages, mn::json::value_string_new("geometry"));
+			if (slot.stages & (1 << COMPILATION_MODE_COMPUTE))
+				mn::json::value_array_push(json_stages, mn::json::value_string_new("compute"));
+			mn::json::value_object_insert(json_binding, "stages", json_stages);
+
+			mn::json::value_array_push(json_resources[slot.frequency], json_binding);
+			++resources_count[slot.frequency];
+		}
+
+		auto json_bindings = mn::json::value_array_new();
+		for (size_t i = 0; i < BINDING_FREQUENCY_COUNT; ++i)
+		{
+			if (resources_count[i] == 0)
+			{
+				mn::json::value_free(json_resources[i]);
+				continue;
+			}
+
+			auto json_group = mn::json::value_object_new();
+			mn::json::value_object_insert(json_group, "frequency", mn::json::value_string_new(binding_frequency_name(BINDING_FREQUENCY(i))));
+			mn::json::value_object_insert(json_group, "set", mn::json::value_number_new(i));
+			mn::json::value_object_insert(json_group, "resources", json_resources[i]);
+			mn::json::value_array_push(json_bindings, json_group);
+		}
+
 		auto json_types = mn::json::value_array_new();
 		for (auto type: types)
 		{
@@ -994,6 +1534,9 @@ namespace sabre
 		mn::json::value_object_insert(json_result, "entry", json_entry);
 		mn::json::value_object_insert(json_result, "uniforms", json_uniforms);
 		mn::json::value_object_insert(json_result, "textures", json_textures);
+		mn::json::value_object_insert(json_result, "buffers", json_buffers);
+		mn::json::value_object_insert(json_result, "push_constants", json_push_constants);
+		mn::json::value_object_insert(json_result, "bindings", json_bindings);
 		mn::json::value_object_insert(json_result, "types", json_types);
 
 		for (auto s: self->reflected_symbols)
@@ -1031,6 +1574,8 @@ namespace sabre
 		if (unit_has_errors(self))
 			return mn::Err {"unit has errors"};
 
+		_unit_optimize(self, entry);
+
 		auto start = _capture_timepoint();
 		auto stream = mn::memory_stream_new(allocator);
 		mn_defer{mn::memory_stream_free(stream);};
@@ -1064,6 +1609,8 @@ namespace sabre
 		if (unit_has_errors(self))
 			return mn::Err {"unit has errors"};
 
+		_unit_optimize(self, entry);
+
 		auto start = _capture_timepoint();
 		auto stream = mn::memory_stream_new(allocator);
 		mn_defer{mn::memory_stream_free(stream);};
@@ -1134,16 +1681,6 @@ namespace sabre
 		return mn::memory_stream_str(out);
 	}
 
-	Scope*
-	unit_create_scope_for(Unit* self, void* ptr, Scope* parent, const char* name, Type* expected_type, Scope::FLAG flags)
-	{
-		if (auto it = mn::map_lookup(self->scope_table, ptr))
-			return it->value;
-		auto new_scope = scope_new(parent, name, expected_type, flags);
-		mn::map_insert(self->scope_table, ptr, new_scope);
-		return new_scope;
-	}
-
 	mn::Result<Unit_Package*>
 	unit_resolve_package(Unit* self, const mn::Str& absolute_path)
 	{
@@ -0,0 +1,618 @@
+#include "sabre/Unroll.h"
+#include "sabre/Unit.h"
+#include "sabre/AST.h"
+#include "sabre/Scope.h"
+#include "sabre/Type_Interner.h"
+
+#include <mn/Buf.h>
+#include <mn/Map.h>
+#include <mn/Memory.h>
+#include <mn/Assert.h>
+
+namespace sabre
+{
+	// loops which iterate more than this are not unrolled
+	constexpr size_t UNROLL_MAX_TRIP_COUNT = 16;
+	// loops tagged with @unroll are unrolled up to this trip count regardless of the size of their body
+	constexpr size_t UNROLL_FORCED_MAX_TRIP_COUNT = 64;
+	// maximum number of statements which unrolling a single loop can generate (trip count * body statements)
+	constexpr size_t UNROLL_MAX_STMTS = 64;
+
+	struct Unroll
+	{
+		Unroll_Stats stats;
+	};
+
+	// the for loop which we're unrolling
+	struct Unroll_Loop
+	{
+		Symbol* induction_var;
+		// values of the induction variable in each iteration
+		mn::Buf<int64_t> values;
+	};
+
+	inline static Unroll
+	_unroll_new()
+	{
+		Unroll self{};
+		return self;
+	}
+
+	inline static bool
+	_unroll_is_induction_var(const Expr* e, Symbol* induction_var)
+	{
+		return e->kind == Expr::KIND_ATOM && e->symbol == induction_var;
+	}
+
+	inline static bool
+	_unroll_const_int(const Expr* e, int64_t& res)
+	{
+		if (e == nullptr || e->const_value.type == nullptr || type_is_equal(e->type, type_int) == false)
+			return false;
+		res = expr_value_as_int(e->const_value);
+		return true;
+	}
+
+	inline static bool
+	_unroll_loop_cond(Tkn::KIND op, int64_t value, int64_t bound)
+	{
+		switch (op)
+		{
+		case Tkn::KIND_LESS:
+			return value < bound;
+		case Tkn::KIND_LESS_EQUAL:
+			return value <= bound;
+		case Tkn::KIND_GREATER:
+			return value > bound;
+		case Tkn::KIND_GREATER_EQUAL:
+			return value >= bound;
+		case Tkn::KIND_NOT_EQUAL:
+			return value != bound;
+		default:
+			return false;
+		}
+	}
+
+	// calculates the values of the induction variable in each iteration of the given loop, it fails if the loop is
+	// not in the form (var i = a; i < b; i += c) with constant a, b, and c or if it iterates more than max_trip_count
+	inline static bool
+	_unroll_loop_values(Stmt* s, size_t max_trip_count, Unroll_Loop& loop)
+	{
+		auto init = s->for_stmt.init;
+		auto cond = s->for_stmt.cond;
+		auto post = s->for_stmt.post;
+		if (init == nullptr || cond == nullptr || post == nullptr || s->scope == nullptr)
+			return false;
+
+		if (init->kind != Stmt::KIND_DECL || init->decl_stmt->kind != Decl::KIND_VAR)
+			return false;
+
+		const auto& var_decl = init->decl_stmt->var_decl;
+		int64_t start = 0;
+		if (var_decl.names.count != 1 || var_decl.values.count != 1 || _unroll_const_int(var_decl.values[0], start) == false)
+			return false;
+
+		auto induction_var = scope_shallow_find(s->scope, var_decl.names[0].str);
+		if (induction_var == nullptr || induction_var->kind != Symbol::KIND_VAR || induction_var->type != type_int)
+			return false;
+
+		int64_t bound = 0;
+		if (cond->kind != Expr::KIND_BINARY ||
+			_unroll_is_induction_var(cond->binary.left, induction_var) == false ||
+			_unroll_const_int(cond->binary.right, bound) == false)
+		{
+			return false;
+		}
+
+		int64_t step = 0;
+		if (post->kind == Stmt::KIND_ASSIGN)
+		{
+			if (post->assign_stmt.lhs.count != 1 || _unroll_is_induction_var(post->assign_stmt.lhs[0], induction_var) == false)
+				return false;
+
+			if (_unroll_const_int(post->assign_stmt.rhs[0], step) == false)
+				return false;
+
+			if (post->assign_stmt.op.kind == Tkn::KIND_MINUS_EQUAL)
+				step = -step;
+			else if (post->assign_stmt.op.kind != Tkn::KIND_PLUS_EQUAL)
+				return false;
+		}
+		else if (post->kind == Stmt::KIND_EXPR && post->expr_stmt->kind == Expr::KIND_UNARY)
+		{
+			auto e = post->expr_stmt;
+			if (_unroll_is_induction_var(e->unary.base, induction_var) == false)
+				return false;
+
+			if (e->unary.op.kind == Tkn::KIND_INC)
+				step = 1;
+			else if (e->unary.op.kind == Tkn::KIND_DEC)
+				step = -1;
+			else
+				return false;
+		}
+		else
+		{
+			return false;
+		}
+
+		if (step == 0)
+			return false;
+
+		loop.induction_var = induction_var;
+		loop.values = mn::buf_with_allocator<int64_t>(mn::memory::tmp());
+		for (auto value = start; _unroll_loop_cond(cond->binary.op.kind, value, bound); value += step)
+		{
+			if (loop.values.count == max_trip_count)
+				return false;
+			mn::buf_push(loop.values, value);
+		}
+		return true;
+	}
+
+	// returns whether the given expression might write into the induction variable
+	inline static bool
+	_unroll_expr_writes(const Expr* e, Symbol* induction_var)
+	{
+		if (e == nullptr)
+			return false;
+
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			return false;
+		case Expr::KIND_BINARY:
+			return _unroll_expr_writes(e->binary.left, induction_var) || _unroll_expr_writes(e->binary.right, induction_var);
+		case Expr::KIND_UNARY:
+			if (e->unary.op.kind == Tkn::KIND_INC || e->unary.op.kind == Tkn::KIND_DEC)
+			{
+				auto sym = expr_assigned_symbol(e->unary.base);
+				if (sym == nullptr || sym == induction_var)
+					return true;
+			}
+			return _unroll_expr_writes(e->unary.base, induction_var);
+		case Expr::KIND_CALL:
+			for (auto arg: e->call.args)
+				if (_unroll_expr_writes(arg, induction_var))
+					return true;
+			return false;
+		case Expr::KIND_CAST:
+			return _unroll_expr_writes(e->cast.base, induction_var);
+		case Expr::KIND_DOT:
+			return _unroll_expr_writes(e->dot.lhs, induction_var);
+		case Expr::KIND_INDEXED:
+			return _unroll_expr_writes(e->indexed.base, induction_var) || _unroll_expr_writes(e->indexed.index, induction_var);
+		case Expr::KIND_COMPLIT:
+			for (const auto& field: e->complit.fields)
+				if (_unroll_expr_writes(field.value, induction_var))
+					return true;
+			return false;
+		default:
+			mn_unreachable();
+			return true;
+		}
+	}
+
+	// checks whether the given statement of the loop body can be copied into the unrolled iterations, and counts
+	// the statements inside it
+	inline static bool
+	_unroll_stmt_can_clone(const Stmt* s, Symbol* induction_var, size_t& stmts_count)
+	{
+		if (s == nullptr)
+			return true;
+
+		++stmts_count;
+		switch (s->kind)
+		{
+		case Stmt::KIND_BREAK:
+		case Stmt::KIND_CONTINUE:
+			// the copies of the body are not inside a loop anymore
+			return false;
+		case Stmt::KIND_FOR:
+			// inner loops are unrolled first, the ones which are left can't be unrolled
+			return false;
+		case Stmt::KIND_DISCARD:
+			return true;
+		case Stmt::KIND_RETURN:
+			return _unroll_expr_writes(s->return_stmt, induction_var) == false;
+		case Stmt::KIND_IF:
+			for (auto cond: s->if_stmt.cond)
+				if (_unroll_expr_writes(cond, induction_var))
+					return false;
+			for (auto body: s->if_stmt.body)
+				if (_unroll_stmt_can_clone(body, induction_var, stmts_count) == false)
+					return false;
+			return _unroll_stmt_can_clone(s->if_stmt.else_body, induction_var, stmts_count);
+		case Stmt::KIND_ASSIGN:
+			for (size_t i = 0; i < s->assign_stmt.lhs.count; ++i)
+			{
+				auto sym = expr_assigned_symbol(s->assign_stmt.lhs[i]);
+				if (sym == nullptr || sym == induction_var)
+					return false;
+				if (_unroll_expr_writes(s->assign_stmt.lhs[i], induction_var) ||
+					_unroll_expr_writes(s->assign_stmt.rhs[i], induction_var))
+				{
+					return false;
+				}
+			}
+			return true;
+		case Stmt::KIND_EXPR:
+			return _unroll_expr_writes(s->expr_stmt, induction_var) == false;
+		case Stmt::KIND_BLOCK:
+			for (auto stmt: s->block_stmt)
+				if (_unroll_stmt_can_clone(stmt, induction_var, stmts_count) == false)
+					return false;
+			return true;
+		case Stmt::KIND_DECL:
+			// local constants and functions are not copied
+			if (s->decl_stmt->kind != Decl::KIND_VAR)
+				return false;
+			for (auto value: s->decl_stmt->var_decl.values)
+				if (_unroll_expr_writes(value, induction_var))
+					return false;
+			return true;
+		default:
+			mn_unreachable();
+			return false;
+		}
+	}
+
+	// folds the value of the copied expression if all of its operands became constants
+	inline static void
+	_unroll_fold(Expr* e)
+	{
+		if (e->const_value.type != nullptr)
+			return;
+
+		if (type_is_numeric_scalar(e->type) == false && type_is_equal(e->type, type_bool) == false)
+			return;
+
+		Expr_Value value{};
+		if (e->kind == Expr::KIND_BINARY)
+		{
+			auto left = e->binary.left->const_value;
+			auto right = e->binary.right->const_value;
+			if (left.type == nullptr || right.type == nullptr)
+				return;
+
+			// we leave the division by zero to the backend compiler
+			if ((e->binary.op.kind == Tkn::KIND_DIVIDE || e->binary.op.kind == Tkn::KIND_MODULUS) &&
+				expr_value_as_double(right) == 0)
+			{
+				return;
+			}
+
+			value = expr_value_binary_op(left, e->binary.op.kind, right);
+		}
+		else if (e->kind == Expr::KIND_UNARY)
+		{
+			auto base = e->unary.base->const_value;
+			if (base.type == nullptr || e->unary.op.kind == Tkn::KIND_INC || e->unary.op.kind == Tkn::KIND_DEC)
+				return;
+
+			value = expr_value_unary_op(base, e->unary.op.kind);
+		}
+
+		if (value.type == nullptr)
+			return;
+
+		e->const_value = value;
+		e->mode = ADDRESS_MODE_CONST;
+	}
+
+	// clones the given checked expression and replaces the induction variable and the local variables of
+	// the loop body using the given replacements map
+	inline static Expr*
+	_unroll_clone_expr(const Expr* e, const mn::Map<Symbol*, Expr*>& replacements)
+	{
+		if (e == nullptr)
+			return nullptr;
+
+		if (e->kind == Expr::KIND_ATOM && e->symbol)
+		{
+			if (auto it = mn::map_lookup(replacements, e->symbol))
+			{
+				auto res = mn::alloc_zerod_from<Expr>(e->arena);
+				*res = *it->value;
+				res->loc = e->loc;
+				return res;
+			}
+		}
+
+		auto self = mn::alloc_zerod_from<Expr>(e->arena);
+		*self = *e;
+		switch (e->kind)
+		{
+		case Expr::KIND_ATOM:
+			break;
+		case Expr::KIND_BINARY:
+			self->binary.left = _unroll_clone_expr(e->binary.left, replacements);
+			self->binary.right = _unroll_clone_expr(e->binary.right, replacements);
+			_unroll_fold(self);
+			break;
+		case Expr::KIND_UNARY:
+			self->unary.base = _unroll_clone_expr(e->unary.base, replacements);
+			_unroll_fold(self);
+			break;
+		case Expr::KIND_CALL:
+			self->call.args = mn::buf_with_allocator<Expr*>(e->arena);
+			for (auto arg: e->call.args)
+				mn::buf_push(self->call.args, _unroll_clone_expr(arg, replacements));
+			break;
+		case Expr::KIND_CAST:
+			self->cast.base = _unroll_clone_expr(e->cast.base, replacements);
+			break;
+		case Expr::KIND_DOT:
+			self->dot.lhs = _unroll_clone_expr(e->dot.lhs, replacements);
+			break;
+		case Expr::KIND_INDEXED:
+			self->indexed.base = _unroll_clone_expr(e->indexed.base, replacements);
+			self->indexed.index = _unroll_clone_expr(e->indexed.index, replacements);
+			break;
+		case Expr::KIND_COMPLIT:
+			self->complit.fields = mn::buf_with_allocator<Complit_Field>(e->arena);
+			for (const auto& field: e->complit.fields)
+			{
+				auto new_field = field;
+				new_field.value = _unroll_clone_expr(field.value, replacements);
+				mn::buf_push(self->complit.fields, new_field);
+			}
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+		return self;
+	}
+
+	// creates the literal which replaces the induction variable in a single iteration
+	inline static Expr*
+	_unroll_literal_new(mn::Allocator arena, Symbol* induction_var, int64_t value, Location loc)
+	{
+		Tkn tkn{};
+		tkn.kind = Tkn::KIND_LITERAL_INTEGER;
+		tkn.str = unit_intern(induction_var->package->parent_unit, mn::str_tmpf("{}", value).ptr);
+		tkn.loc = loc;
+
+		auto self = expr_atom_new(arena, tkn);
+		self->loc = loc;
+		self->type = induction_var->type;
+		self->mode = ADDRESS_MODE_CONST;
+		self->const_value = expr_value_int(value);
+		// negative values shouldn't merge with the operators around them (- -1 for example)
+		self->in_parens = value < 0;
+		return self;
+	}
+
+	// clones the given local variable declaration into the new scope, the variables get new symbols which
+	// replace the old ones in the rest of the copied body
+	inline static Decl*
+	_unroll_clone_var_decl(mn::Allocator arena, const Decl* d, Scope* old_scope, Scope* new_scope, mn::Map<Symbol*, Expr*>& replacements)
+	{
+		auto values = mn::buf_with_allocator<Expr*>(arena);
+		for (auto value: d->var_decl.values)
+			mn::buf_push(values, _unroll_clone_expr(value, replacements));
+
+		auto self = decl_var_new(arena, d->var_decl.names, values, d->var_decl.type);
+		self->loc = d->loc;
+		self->name = d->name;
+		self->tags = d->tags;
+		self->type = d->type;
+
+		for (size_t i = 0; i < d->var_decl.names.count; ++i)
+		{
+			auto name = d->var_decl.names[i];
+			auto old_sym = scope_shallow_find(old_scope, name.str);
+			mn_assert(old_sym != nullptr);
+
+			Expr* value = nullptr;
+			if (i < values.count)
+				value = values[i];
+
+			auto sym = symbol_var_new(old_sym->package->symbols_arena, name, self, self->var_decl.type, value);
+			sym->type = old_sym->type;
+			sym->state = STATE_RESOLVED;
+			scope_add(new_scope, sym);
+			sym->package = old_sym->package;
+			sym->scope = new_scope;
+
+			auto atom = expr_atom_new(arena, name);
+			atom->loc = name.loc;
+			atom->type = sym->type;
+			atom->mode = ADDRESS_MODE_VARIABLE;
+			atom->symbol = sym;
+			atom->atom.decl = self;
+			mn::map_insert(replacements, old_sym, atom);
+		}
+		return self;
+	}
+
+	// clones the given statement of the loop body, old_scope is the scope which the statement was checked in,
+	// and new_scope is the scope of the copy
+	inline static Stmt*
+	_unroll_clone_stmt(const Stmt* s, Scope* old_scope, Scope* new_scope, mn::Map<Symbol*, Expr*>& replacements)
+	{
+		if (s == nullptr)
+			return nullptr;
+
+		auto arena = s->arena;
+		auto self = mn::alloc_zerod_from<Stmt>(arena);
+		*self = *s;
+		self->scope = nullptr;
+		switch (s->kind)
+		{
+		case Stmt::KIND_DISCARD:
+			break;
+		case Stmt::KIND_RETURN:
+			self->return_stmt = _unroll_clone_expr(s->return_stmt, replacements);
+			break;
+		case Stmt::KIND_IF:
+			self->if_stmt.cond = mn::buf_with_allocator<Expr*>(arena);
+			for (auto cond: s->if_stmt.cond)
+				mn::buf_push(self->if_stmt.cond, _unroll_clone_expr(cond, replacements));
+			self->if_stmt.body = mn::buf_with_allocator<Stmt*>(arena);
+			for (auto body: s->if_stmt.body)
+				mn::buf_push(self->if_stmt.body, _unroll_clone_stmt(body, old_scope, new_scope, replacements));
+			self->if_stmt.else_body = _unroll_clone_stmt(s->if_stmt.else_body, old_scope, new_scope, replacements);
+			break;
+		case Stmt::KIND_ASSIGN:
+			self->assign_stmt.lhs = mn::buf_with_allocator<Expr*>(arena);
+			self->assign_stmt.rhs = mn::buf_with_allocator<Expr*>(arena);
+			for (size_t i = 0; i < s->assign_stmt.lhs.count; ++i)
+			{
+				mn::buf_push(self->assign_stmt.lhs, _unroll_clone_expr(s->assign_stmt.lhs[i], replacements));
+				mn::buf_push(self->assign_stmt.rhs, _unroll_clone_expr(s->assign_stmt.rhs[i], replacements));
+			}
+			break;
+		case Stmt::KIND_EXPR:
+			self->expr_stmt = _unroll_clone_expr(s->expr_stmt, replacements);
+			break;
+		case Stmt::KIND_BLOCK:
+		{
+			auto block_old_scope = old_scope;
+			auto block_new_scope = new_scope;
+			if (s->scope)
+			{
+				block_old_scope = s->scope;
+				block_new_scope = scope_new(s->scope->arena, new_scope, s->scope->name, s->scope->expected_type, s->scope->flags);
+				self->scope = block_new_scope;
+			}
+
+			self->block_stmt = mn::buf_with_allocator<Stmt*>(arena);
+			for (auto stmt: s->block_stmt)
+				mn::buf_push(self->block_stmt, _unroll_clone_stmt(stmt, block_old_scope, block_new_scope, replacements));
+			break;
+		}
+		case Stmt::KIND_DECL:
+			self->decl_stmt = _unroll_clone_var_decl(arena, s->decl_stmt, old_scope, new_scope, replacements);
+			break;
+		default:
+			mn_unreachable();
+			break;
+		}
+		return self;
+	}
+
+	// generates a block for each iteration of the given loop into copies, returns false if the loop can't be unrolled
+	inline static bool
+	_unroll_for(Unroll& self, Stmt* s, mn::Buf<Stmt*>& copies)
+	{
+		// @loop asks for a real loop
+		if (mn::map_lookup(s->tags.table, KEYWORD_LOOP))
+			return false;
+
+		bool is_forced = mn::map_lookup(s->tags.table, KEYWORD_UNROLL) != nullptr;
+
+		Unroll_Loop loop{};
+		if (_unroll_loop_values(s, is_forced ? UNROLL_FORCED_MAX_TRIP_COUNT : UNROLL_MAX_TRIP_COUNT, loop) == false)
+			return false;
+
+		size_t body_stmts_count = 0;
+		for (auto stmt: s->for_stmt.body->block_stmt)
+			if (_unroll_stmt_can_clone(stmt, loop.induction_var, body_stmts_count) == false)
+				return false;
+
+		if (is_forced == false && body_stmts_count * loop.values.count > UNROLL_MAX_STMTS)
+			return false;
+
+		auto arena = s->arena;
+		auto replacements = mn::map_with_allocator<Symbol*, Expr*>(mn::memory::tmp());
+		for (auto value: loop.values)
+		{
+			mn::map_clear(replacements);
+			mn::map_insert(replacements, loop.induction_var, _unroll_literal_new(arena, loop.induction_var, value, s->loc));
+
+			// the copies are siblings of the loop, so they don't see its induction variable
+			auto scope = scope_new(s->scope->arena, s->scope->parent, "block", nullptr, Scope::FLAG_NONE);
+			auto stmts = mn::buf_with_allocator<Stmt*>(arena);
+			for (auto stmt: s->for_stmt.body->block_stmt)
+				mn::buf_push(stmts, _unroll_clone_stmt(stmt, s->scope, scope, replacements));
+
+			auto copy = stmt_block_new(arena, stmts);
+			copy->loc = s->for_stmt.body->loc;
+			copy->scope = scope;
+			copy->tags = tag_table_new(arena);
+			mn::buf_push(copies, copy);
+		}
+
+		++self.stats.unrolled_loops;
+		self.stats.unrolled_iterations += loop.values.count;
+		return true;
+	}
+
+	inline static void
+	_unroll_block(Unroll& self, Stmt* s);
+
+	inline static void
+	_unroll_stmt(Unroll& self, Stmt* s)
+	{
+		switch (s->kind)
+		{
+		case Stmt::KIND_FOR:
+			_unroll_block(self, s->for_stmt.body);
+			break;
+		case Stmt::KIND_IF:
+			for (auto body: s->if_stmt.body)
+				_unroll_block(self, body);
+			if (s->if_stmt.else_body)
+				_unroll_block(self, s->if_stmt.else_body);
+			break;
+		case Stmt::KIND_BLOCK:
+			_unroll_block(self, s);
+			break;
+		default:
+			break;
+		}
+	}
+
+	inline static void
+	_unroll_block(Unroll& self, Stmt* s)
+	{
+		auto stmts = mn::buf_with_allocator<Stmt*>(mn::memory::tmp());
+		auto copies = mn::buf_with_allocator<Stmt*>(mn::memory::tmp());
+		bool changed = false;
+		for (auto stmt: s->block_stmt)
+		{
+			// inner loops are unrolled first
+			_unroll_stmt(self, stmt);
+
+			mn::buf_clear(copies);
+			if (stmt->kind == Stmt::KIND_FOR && _unroll_for(self, stmt, copies))
+			{
+				for (auto copy: copies)
+					mn::buf_push(stmts, copy);
+				changed = true;
+			}
+			else
+			{
+				mn::buf_push(stmts, stmt);
+			}
+		}
+
+		if (changed)
+			s->block_stmt = mn::buf_memcpy_clone(stmts, s->block_stmt.allocator);
+	}
+
+	inline static void
+	_unroll_func(Unroll& self, Decl* d)
+	{
+		_unroll_block(self, d->func_decl.body);
+	}
+
+	// API
+	Unroll_Stats
+	unroll_entry(Entry_Point* entry)
+	{
+		auto self = _unroll_new();
+		unit_reachable_funcs_walk(entry, nullptr, [&](Decl* d) { _unroll_func(self, d); });
+		return self.stats;
+	}
+
+	Unroll_Stats
+	unroll_package(Unit_Package* package)
+	{
+		auto self = _unroll_new();
+		unit_reachable_funcs_walk(nullptr, package, [&](Decl* d) { _unroll_func(self, d); });
+		return self.stats;
+	}
+}
\ No newline at end of file
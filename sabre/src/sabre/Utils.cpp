@@ -27,6 +27,63 @@ namespace sabre
 		}
 	}
 
+	// loads, parses, checks, and links the given vertex and pixel entries, then generates the code of both of them
+	inline static mn::Result<mn::Str, mn::Err>
+	_pipeline_gen_from_file(
+		const mn::Str& filepath,
+		const mn::Str& fake_path,
+		const mn::Str& vertex_entry,
+		const mn::Str& pixel_entry,
+		const mn::Map<mn::Str, mn::Str>& library_collections,
+		const Unit_Options& options,
+		mn::Result<mn::Str> (*gen)(Unit*, Entry_Point*, mn::Allocator)
+	)
+	{
+		if (mn::path_is_file(filepath) == false)
+			return mn::Err{ "file '{}' not found", filepath };
+
+		auto unit = unit_from_file(filepath, vertex_entry);
+		mn_defer{unit_free(unit);};
+
+		unit->options = options;
+
+		for (const auto& [name, path]: library_collections)
+			if (auto err = unit_add_library_collection(unit, name, path))
+				return err;
+
+		_unit_change_paths(unit, fake_path);
+
+		if (unit_scan(unit) == false)
+			return unit_dump_errors(unit);
+
+		if (unit_parse(unit) == false)
+			return unit_dump_errors(unit);
+
+		if (unit_check(unit) == false)
+			return unit_dump_errors(unit);
+
+		auto vertex = unit_package_entry_find(unit->root_package, vertex_entry);
+		if (vertex == nullptr)
+			return mn::Err{ "vertex entry '{}' not found", vertex_entry };
+
+		auto pixel = unit_package_entry_find(unit->root_package, pixel_entry);
+		if (pixel == nullptr)
+			return mn::Err{ "pixel entry '{}' not found", pixel_entry };
+
+		if (unit_link_pipeline(unit, vertex, pixel) == false)
+			return unit_dump_errors(unit);
+
+		auto [vertex_code, vertex_err] = gen(unit, vertex, mn::memory::tmp());
+		if (vertex_err)
+			return unit_dump_errors(unit);
+
+		auto [pixel_code, pixel_err] = gen(unit, pixel, mn::memory::tmp());
+		if (pixel_err)
+			return unit_dump_errors(unit);
+
+		return mn::strf("// vertex entry '{}'\n{}\n\n// pixel entry '{}'\n{}", vertex_entry, vertex_code, pixel_entry, pixel_code);
+	}
+
 	// API
 	mn::Result<mn::Str, mn::Err>
 	scan_file(const mn::Str& filepath, const mn::Str&)
@@ -165,7 +222,7 @@ namespace sabre
 	}
 
 	mn::Result<mn::Str, mn::Err>
-	glsl_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& entry, const mn::Map<mn::Str, mn::Str>& library_collections)
+	glsl_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& entry, const mn::Map<mn::Str, mn::Str>& library_collections, const Unit_Options& options)
 	{
 		if (mn::path_is_file(filepath) == false)
 			return mn::Err{ "file '{}' not found", filepath };
@@ -173,6 +230,8 @@ namespace sabre
 		auto unit = unit_from_file(filepath, entry);
 		mn_defer{unit_free(unit);};
 
+		unit->options = options;
+
 		for (const auto& [name, path]: library_collections)
 			if (auto err = unit_add_library_collection(unit, name, path))
 				return err;
@@ -196,7 +255,7 @@ namespace sabre
 	}
 
 	mn::Result<mn::Str, mn::Err>
-	hlsl_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& entry, const mn::Map<mn::Str, mn::Str>& library_collections)
+	hlsl_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& entry, const mn::Map<mn::Str, mn::Str>& library_collections, const Unit_Options& options)
 	{
 		if (mn::path_is_file(filepath) == false)
 			return mn::Err{ "file '{}' not found", filepath };
@@ -204,6 +263,8 @@ namespace sabre
 		auto unit = unit_from_file(filepath, entry);
 		mn_defer{unit_free(unit);};
 
+		unit->options = options;
+
 		for (const auto& [name, path]: library_collections)
 			if (auto err = unit_add_library_collection(unit, name, path))
 				return err;
@@ -226,6 +287,18 @@ namespace sabre
 			return res;
 	}
 
+	mn::Result<mn::Str, mn::Err>
+	glsl_pipeline_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& vertex_entry, const mn::Str& pixel_entry, const mn::Map<mn::Str, mn::Str>& library_collections, const Unit_Options& options)
+	{
+		return _pipeline_gen_from_file(filepath, fake_path, vertex_entry, pixel_entry, library_collections, options, unit_glsl);
+	}
+
+	mn::Result<mn::Str, mn::Err>
+	hlsl_pipeline_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& vertex_entry, const mn::Str& pixel_entry, const mn::Map<mn::Str, mn::Str>& library_collections, const Unit_Options& options)
+	{
+		return _pipeline_gen_from_file(filepath, fake_path, vertex_entry, pixel_entry, library_collections, options, unit_hlsl);
+	}
+
 	mn::Result<mn::Str, mn::Err>
 	spirv_gen_from_file(const mn::Str& filepath, const mn::Str& fake_path, const mn::Str& entry, const mn::Map<mn::Str, mn::Str>& library_collections)
 	{
@@ -0,0 +1,120 @@
+#include "sabre/Varying.h"
+#include "sabre/Type_Interner.h"
+#include "sabre/Scope.h"
+#include "sabre/Unit.h"
+
+#include <mn/Memory.h>
+#include <mn/Assert.h>
+
+namespace sabre
+{
+	// vec4 slots have 4 components
+	constexpr size_t VARYING_SLOT_WIDTH = 4;
+
+	// returns the number of components of the given type if it can be packed, 0 otherwise
+	inline static size_t
+	_varying_packed_width(Type* type)
+	{
+		if (type == type_float)
+			return 1;
+		if (type->kind == Type::KIND_VEC && type->vec.base == type_float)
+			return type->vec.width;
+		return 0;
+	}
+
+	// API
+	Varying_Layout
+	varying_layout_new(Type* type, bool pack, const mn::Set<const char*>& removed_fields)
+	{
+		mn_assert(type->kind == Type::KIND_STRUCT);
+
+		Varying_Layout self{};
+		self.fields = mn::buf_new<Varying_Field>();
+
+		// system value tags live on the struct declaration fields
+		auto decl = symbol_decl(type->struct_type.symbol);
+		for (const auto& decl_field: decl->struct_decl.fields)
+		{
+			bool is_builtin =
+				mn::map_lookup(decl_field.tags.table, KEYWORD_SV_POSITION) != nullptr ||
+				mn::map_lookup(decl_field.tags.table, KEYWORD_SV_DEPTH) != nullptr;
+
+			for (size_t i = 0; i < decl_field.names.count; ++i)
+			{
+				const auto& type_field = type->struct_type.fields[self.fields.count];
+
+				Varying_Field field{};
+				if (is_builtin)
+				{
+					field.kind = Varying_Field::KIND_BUILTIN;
+				}
+				else if (mn::set_lookup(removed_fields, type_field.name.str) != nullptr)
+				{
+					field.kind = Varying_Field::KIND_REMOVED;
+				}
+				else if (auto width = _varying_packed_width(type_field.type); pack && width > 0)
+				{
+					field.kind = Varying_Field::KIND_PACKED;
+					field.width = width;
+				}
+				else
+				{
+					field.kind = Varying_Field::KIND_UNPACKED;
+				}
+				mn::buf_push(self.fields, field);
+			}
+		}
+
+		// place the packed fields from the widest to the narrowest, fields of the same width keep their order
+		auto slots_used = mn::buf_with_allocator<size_t>(mn::memory::tmp());
+		for (auto width = VARYING_SLOT_WIDTH; width > 0; --width)
+		{
+			for (auto& field: self.fields)
+			{
+				if (field.kind != Varying_Field::KIND_PACKED || field.width != width)
+					continue;
+
+				size_t slot = 0;
+				while (slot < slots_used.count && slots_used[slot] + width > VARYING_SLOT_WIDTH)
+					++slot;
+				if (slot == slots_used.count)
+					mn::buf_push(slots_used, size_t(0));
+
+				field.location = slot;
+				field.component = slots_used[slot];
+				slots_used[slot] += width;
+			}
+		}
+		self.slots_count = slots_used.count;
+
+		// the unpacked fields take the locations after the slots
+		auto location = self.slots_count;
+		for (auto& field: self.fields)
+			if (field.kind == Varying_Field::KIND_UNPACKED)
+				field.location = location++;
+
+		return self;
+	}
+
+	void
+	varying_layout_free(Varying_Layout& self)
+	{
+		mn::buf_free(self.fields);
+	}
+
+	const char*
+	varying_field_swizzle(const Varying_Field& field)
+	{
+		mn_assert(field.kind == Varying_Field::KIND_PACKED);
+		mn_assert(field.component + field.width <= VARYING_SLOT_WIDTH);
+
+		// indexed by the first component then the width
+		static const char* SWIZZLES[VARYING_SLOT_WIDTH][VARYING_SLOT_WIDTH] = {
+			{"x", "xy", "xyz", "xyzw"},
+			{"y", "yz", "yzw", nullptr},
+			{"z", "zw", nullptr, nullptr},
+			{"w", nullptr, nullptr, nullptr},
+		};
+		return SWIZZLES[field.component][field.width - 1];
+	}
+}
\ No newline at end of file
@@ -20,7 +20,18 @@ COMMANDS:
 
 OPTIONS:
   -entry: specifies the entry point function of the given program
-  -collection: specifies a library collection in this format <collection name>:<collection path>)""";
+  -pixel-entry: links the entry point (which should be a vertex entry) with the given pixel entry point in glsl-gen/hlsl-gen, the vertex outputs which the pixel entry doesn't read are removed and code is generated for both entries
+  -collection: specifies a library collection in this format <collection name>:<collection path>
+  -fold-constants: emits the folded value of constant expressions in the generated GLSL/HLSL code
+  -inline-functions: replaces calls to small functions and functions tagged with @inline with their bodies in the generated GLSL/HLSL code
+  -unroll-loops: fully unrolls for loops with a small constant trip count in the generated GLSL/HLSL code
+  -fast-math: rewrites expensive math patterns (pow, division by constants, length, etc...) into cheaper ones in the generated GLSL/HLSL code
+  -eliminate-dead-code: removes dead statements, unused local variables, and constant false branches from the generated GLSL/HLSL code
+  -hoist-loop-invariants: moves the loop invariant computations out of for loops in the generated GLSL/HLSL code
+  -eliminate-common-subexpressions: computes repeated builtin calls and texture samples once and reuses the result in the generated GLSL/HLSL code
+  -convert-branches-to-selects: emits small if/else statements which assign a single local variable as conditional assignments in the generated GLSL/HLSL code
+  -pack-varyings: packs the float fields passed from the vertex stage to the pixel stage into shared vec4 interpolator slots, it must be used for both stages
+  -enable-subgroups: allows the subgroup (wave) operations of std, the target should support GL_KHR_shader_subgroup in GLSL and shader model 6.0 in HLSL)""";
 
 inline static void
 print_help()
@@ -32,8 +43,10 @@ struct Args
 {
 	mn::Str cmd;
 	mn::Str entry;
+	mn::Str pixel_entry;
 	mn::Buf<mn::Str> input;
 	mn::Map<mn::Str, mn::Str> collections;
+	sabre::Unit_Options options;
 };
 
 inline static void
@@ -41,6 +54,7 @@ args_free(Args& self)
 {
 	mn::str_free(self.cmd);
 	mn::str_free(self.entry);
+	mn::str_free(self.pixel_entry);
 	destruct(self.input);
 	destruct(self.collections);
 }
@@ -60,6 +74,51 @@ args_parse(Args& self, int argc, char** argv)
 			self.entry = mn::str_lit(argv[i + 1]);
 			++i;
 		}
+		else if (str == "-pixel-entry" && i + 1 < argc)
+		{
+			self.pixel_entry = mn::str_lit(argv[i + 1]);
+			++i;
+		}
+		else if (str == "-fold-constants")
+		{
+			self.options.fold_constants = true;
+		}
+		else if (str == "-inline-functions")
+		{
+			self.options.inline_functions = true;
+		}
+		else if (str == "-unroll-loops")
+		{
+			self.options.unroll_loops = true;
+		}
+		else if (str == "-fast-math")
+		{
+			self.options.fast_math = true;
+		}
+		else if (str == "-eliminate-dead-code")
+		{
+			self.options.eliminate_dead_code = true;
+		}
+		else if (str == "-hoist-loop-invariants")
+		{
+			self.options.hoist_loop_invariants = true;
+		}
+		else if (str == "-eliminate-common-subexpressions")
+		{
+			self.options.eliminate_common_subexpressions = true;
+		}
+		else if (str == "-convert-branches-to-selects")
+		{
+			self.options.convert_branches_to_selects = true;
+		}
+		else if (str == "-pack-varyings")
+		{
+			self.options.pack_varyings = true;
+		}
+		else if (str == "-enable-subgroups")
+		{
+			self.options.enable_subgroups = true;
+		}
 		else if (str == "-collection" && i + 1 < argc)
 		{
 			auto collection_arg = mn::str_lit(argv[i + 1]);
@@ -243,7 +302,9 @@ int main(int argc, char** argv)
 		}
 		auto path = args.input[0];
 
-		auto [answer, err] = sabre::glsl_gen_from_file(path, mn::str_lit(""), args.entry, args.collections);
+		auto [answer, err] = args.pixel_entry.count > 0 ?
+			sabre::glsl_pipeline_gen_from_file(path, mn::str_lit(""), args.entry, args.pixel_entry, args.collections, args.options) :
+			sabre::glsl_gen_from_file(path, mn::str_lit(""), args.entry, args.collections, args.options);
 		if (err)
 		{
 			mn::printerr("{}\n", err);
@@ -263,7 +324,9 @@ int main(int argc, char** argv)
 		}
 		auto path = args.input[0];
 
-		auto [answer, err] = sabre::hlsl_gen_from_file(path, mn::str_lit(""), args.entry, args.collections);
+		auto [answer, err] = args.pixel_entry.count > 0 ?
+			sabre::hlsl_pipeline_gen_from_file(path, mn::str_lit(""), args.entry, args.pixel_entry, args.collections, args.options) :
+			sabre::hlsl_gen_from_file(path, mn::str_lit(""), args.entry, args.collections, args.options);
 		if (err)
 		{
 			mn::printerr("{}\n", err);
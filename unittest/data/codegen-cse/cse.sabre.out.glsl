@@ -0,0 +1,10 @@
+float main_shade(vec3 n, vec3 l) {
+	vec3 _cse_1 = normalize(l);
+	float _cse_2 = dot(normalize(n), _cse_1);
+	float diffuse = max(_cse_2, 0.0);
+	float facing = _cse_2;
+	vec3 h = _cse_1 + n;
+	h = normalize(h);
+	float spec = dot(normalize(h), n);
+	return diffuse + facing + spec;
+}
\ No newline at end of file
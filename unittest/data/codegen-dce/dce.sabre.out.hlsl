@@ -0,0 +1,18 @@
+float main_shade(float x, float y) {
+	float res = x;
+	if (res > 1.0) {
+		res += y;
+	}
+	{
+		res *= 2.0;
+	}
+	{ // for scope
+		for (int i = 0; i < 4; i += 1) {
+			if (i == 2) {
+				break;
+			}
+			res += 1.0;
+		}
+	} // for scope
+	return res;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+float main_shade(mat4 model, mat4 view, vec4 p, vec3 v, float x) {
+	vec4 world = view * (model * p);
+	float a = x * x;
+	float b = x * 0.25;
+	float c = x * inversesqrt(dot(v, v));
+	return a + b + c + world.x;
+}
\ No newline at end of file
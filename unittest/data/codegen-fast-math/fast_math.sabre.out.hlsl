@@ -0,0 +1,7 @@
+float main_shade(column_major float4x4 model, column_major float4x4 view, float4 p, float3 v, float x) {
+	float4 world = mul(view, (mul(model, p)));
+	float a = x * x;
+	float b = x * 0.25;
+	float c = x * rsqrt(dot(v, v));
+	return a + b + c + world.x;
+}
\ No newline at end of file
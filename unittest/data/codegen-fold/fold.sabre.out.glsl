@@ -0,0 +1,29 @@
+#define main_Color int
+#define main_Color_Red 1
+#define main_Color_Green 2
+#define main_Color_Blue 4
+const int main_dims = 4;
+const float main_scale = 0.5;
+int main_size() {
+	return 16;
+}
+main_Color main_mask() {
+	return 3;
+}
+float main_half(float x) {
+	return x * 0.5;
+}
+uint main_count() {
+	return 3u;
+}
+bool main_is_big() {
+	return true;
+}
+void main_main() {
+	const vec2 _tmp_1 = vec2(1.5, 2);
+	const vec2 main_main_offset = _tmp_1;
+	vec2 p = vec2(1.5, 2.0);
+	const int _tmp_2[3] = int[3](1, 2, 3);
+	const int main_main_numbers[3] = _tmp_2;
+	int n = 8;
+}
\ No newline at end of file
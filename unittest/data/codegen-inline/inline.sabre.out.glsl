@@ -0,0 +1,17 @@
+vec3 main_mix3(vec3 a, vec3 b, float t) {
+	vec3 d = b - a;
+	return a + d * t;
+}
+vec3 main_scale(vec3 v, float s) {
+	return v * s;
+}
+float main_add_float(float a, float b) {
+	return a + b;
+}
+vec3 main_shade(float x, float y, vec3 a, vec3 b) {
+	float s = (x + (y * 2.0));
+	vec3 _inline_2_d = b - a;
+	vec3 _inline_2 = a + _inline_2_d * s;
+	vec3 c = _inline_2;
+	return main_scale(c, (s + 1.0));
+}
\ No newline at end of file
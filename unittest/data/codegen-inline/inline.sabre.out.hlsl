@@ -0,0 +1,17 @@
+float3 main_mix3(float3 a, float3 b, float t) {
+	float3 d = b - a;
+	return a + d * t;
+}
+float3 main_scale(float3 v, float s) {
+	return v * s;
+}
+float main_add_float(float a, float b) {
+	return a + b;
+}
+float3 main_shade(float x, float y, float3 a, float3 b) {
+	float s = (x + (y * 2.0));
+	float3 _inline_2_d = b - a;
+	float3 _inline_2 = a + _inline_2_d * s;
+	float3 c = _inline_2;
+	return main_scale(c, (s + 1.0));
+}
\ No newline at end of file
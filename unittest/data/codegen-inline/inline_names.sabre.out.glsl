@@ -0,0 +1,11 @@
+vec3 main_mix3(vec3 a, vec3 b, float t) {
+	vec3 d = b - a;
+	return a + d * t;
+}
+vec3 main_shade(vec3 a, vec3 b, float t) {
+	vec3 _inline_1_d = a;
+	vec3 _inline_1_d_1 = b - _inline_1_d;
+	vec3 _inline_1 = _inline_1_d + _inline_1_d_1 * t;
+	vec3 c = _inline_1;
+	return c;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+float3 main_mix3(float3 a, float3 b, float t) {
+	float3 d = b - a;
+	return a + d * t;
+}
+float3 main_shade(float3 a, float3 b, float t) {
+	float3 _inline_1_d = a;
+	float3 _inline_1_d_1 = b - _inline_1_d;
+	float3 _inline_1 = _inline_1_d + _inline_1_d_1 * t;
+	float3 c = _inline_1;
+	return c;
+}
\ No newline at end of file
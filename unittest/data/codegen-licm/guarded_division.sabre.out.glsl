@@ -0,0 +1,16 @@
+int main_guarded(int a, int b, int count) {
+	int res = 0;
+	bool _licm_1 = b != 0;
+	bool _licm_2 = b > 1;
+	int _licm_3 = a * 2;
+	for (int i = 0; i < count; ++i) {
+		if (_licm_1) {
+			res += a / b;
+		}
+		if (_licm_2 && a % b == 0) {
+			res += a * 3;
+		}
+		res += _licm_3;
+	}
+	return res;
+}
\ No newline at end of file
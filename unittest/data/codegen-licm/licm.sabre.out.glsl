@@ -0,0 +1,12 @@
+float main_shade(vec3 n, vec3 view_dir, int count) {
+	float res = 0.0;
+	float scale = 1.0;
+	int _licm_1 = count * 2;
+	vec3 _licm_2 = normalize(view_dir);
+	for (int i = 0; i < _licm_1; i += 1) {
+		vec3 v = _licm_2;
+		res += dot(n, v) * scale;
+		scale *= 0.5;
+	}
+	return res;
+}
\ No newline at end of file
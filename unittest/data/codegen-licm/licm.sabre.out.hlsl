@@ -0,0 +1,14 @@
+float main_shade(float3 n, float3 view_dir, int count) {
+	float res = 0.0;
+	float scale = 1.0;
+	int _licm_1 = count * 2;
+	float3 _licm_2 = normalize(view_dir);
+	{ // for scope
+		for (int i = 0; i < _licm_1; i += 1) {
+			float3 v = _licm_2;
+			res += dot(n, v) * scale;
+			scale *= 0.5;
+		}
+	} // for scope
+	return res;
+}
\ No newline at end of file
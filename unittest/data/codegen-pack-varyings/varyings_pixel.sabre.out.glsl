@@ -0,0 +1,31 @@
+#version 450
+layout(location = 0) in vec4 ps_input_varying0;
+layout(location = 1) in vec4 ps_input_varying1;
+
+layout(location = 0) out vec4 _entry_point_output_color;
+
+struct main_PS_Input {
+	vec4 position;
+	vec3 normal;
+	vec2 uv;
+	float fog;
+};
+struct main_PS_Output {
+	vec4 color;
+};
+main_PS_Output main_main(main_PS_Input ps_input) {
+	vec4 _tmp_1 = vec4(ps_input.normal * ps_input.fog, ps_input.uv.x);
+	main_PS_Output _tmp_2 = main_PS_Output(_tmp_1);
+	return _tmp_2;
+}
+
+void main() {
+	main_PS_Input ps_input;
+	ps_input.position = gl_FragCoord;
+	ps_input.normal = ps_input_varying0.xyz;
+	ps_input.uv = ps_input_varying1.xy;
+	ps_input.fog = ps_input_varying0.w;
+	
+	main_PS_Output _tmp_3 = main_main(ps_input);
+	_entry_point_output_color = _tmp_3.color;
+}
@@ -0,0 +1,30 @@
+struct main_PS_Input {
+	float4 position;
+	float3 normal;
+	float2 uv;
+	float fog;
+};
+struct main_PS_Output {
+	float4 color: SV_TARGET0;
+};
+main_PS_Output main_main(main_PS_Input ps_input) {
+	float4 _tmp_1 = float4(ps_input.normal * ps_input.fog, ps_input.uv.x);
+	main_PS_Output _tmp_2 = {_tmp_1};
+	return _tmp_2;
+}
+
+struct main_PS_Input_packed {
+	float4 position: SV_POSITION;
+	float4 varying0: TEXCOORD0;
+	float4 varying1: TEXCOORD1;
+};
+
+main_PS_Output main(main_PS_Input_packed ps_input)
+{
+	main_PS_Input _tmp_3;
+	_tmp_3.position = ps_input.position;
+	_tmp_3.normal = ps_input.varying0.xyz;
+	_tmp_3.uv = ps_input.varying1.xy;
+	_tmp_3.fog = ps_input.varying0.w;
+	return main_main(_tmp_3);
+}
@@ -0,0 +1,37 @@
+#version 450
+layout(location = 0) in vec3 vs_input_position;
+layout(location = 1) in vec3 vs_input_normal;
+layout(location = 2) in vec2 vs_input_uv;
+
+layout(location = 0) out vec4 _entry_point_output_varying0;
+layout(location = 1) out vec4 _entry_point_output_varying1;
+
+struct main_VS_Input {
+	vec3 position;
+	vec3 normal;
+	vec2 uv;
+};
+struct main_PS_Input {
+	vec4 position;
+	vec3 normal;
+	vec2 uv;
+	float fog;
+};
+main_PS_Input main_main(main_VS_Input vs_input) {
+	vec4 _tmp_1 = vec4(vs_input.position, 1.0);
+	main_PS_Input _tmp_2 = main_PS_Input(_tmp_1, vs_input.normal, vs_input.uv, vs_input.position.z);
+	return _tmp_2;
+}
+
+void main() {
+	main_VS_Input vs_input;
+	vs_input.position = vs_input_position;
+	vs_input.normal = vs_input_normal;
+	vs_input.uv = vs_input_uv;
+	
+	main_PS_Input _tmp_3 = main_main(vs_input);
+	gl_Position = _tmp_3.position;
+	_entry_point_output_varying0.xyz = _tmp_3.normal;
+	_entry_point_output_varying1.xy = _tmp_3.uv;
+	_entry_point_output_varying0.w = _tmp_3.fog;
+}
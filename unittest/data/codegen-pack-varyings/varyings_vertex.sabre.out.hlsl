@@ -0,0 +1,33 @@
+struct main_VS_Input {
+	float3 position: TEXCOORD0;
+	float3 normal: TEXCOORD1;
+	float2 uv: TEXCOORD2;
+};
+struct main_PS_Input {
+	float4 position;
+	float3 normal;
+	float2 uv;
+	float fog;
+};
+main_PS_Input main_main(main_VS_Input vs_input) {
+	float4 _tmp_1 = float4(vs_input.position, 1.0);
+	main_PS_Input _tmp_2 = {_tmp_1, vs_input.normal, vs_input.uv, vs_input.position.z};
+	return _tmp_2;
+}
+
+struct main_PS_Input_packed {
+	float4 position: SV_POSITION;
+	float4 varying0: TEXCOORD0;
+	float4 varying1: TEXCOORD1;
+};
+
+main_PS_Input_packed main(main_VS_Input vs_input)
+{
+	main_PS_Input _tmp_3 = main_main(vs_input);
+	main_PS_Input_packed _tmp_4 = (main_PS_Input_packed)0;
+	_tmp_4.position = _tmp_3.position;
+	_tmp_4.varying0.xyz = _tmp_3.normal;
+	_tmp_4.varying1.xy = _tmp_3.uv;
+	_tmp_4.varying0.w = _tmp_3.fog;
+	return _tmp_4;
+}
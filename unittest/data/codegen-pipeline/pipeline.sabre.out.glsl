@@ -0,0 +1,72 @@
+// vertex entry 'vs_main'
+#version 450
+layout(location = 0) in vec4 vs_input_position;
+layout(location = 1) in vec3 vs_input_normal;
+layout(location = 2) in vec2 vs_input_uv;
+
+layout(location = 0) out vec3 _entry_point_output_normal;
+layout(location = 1) out vec2 _entry_point_output_uv;
+
+struct main_VS_Input {
+	vec4 position;
+	vec3 normal;
+	vec2 uv;
+};
+struct main_PS_Input {
+	vec4 position;
+	vec3 normal;
+	vec2 uv;
+	float fog;
+};
+main_PS_Input main_vs_main(main_VS_Input vs_input) {
+	main_PS_Input o;
+	o.position = vs_input.position;
+	o.normal = vs_input.normal;
+	o.uv = vs_input.uv;
+	return o;
+}
+
+void main() {
+	main_VS_Input vs_input;
+	vs_input.position = vs_input_position;
+	vs_input.normal = vs_input_normal;
+	vs_input.uv = vs_input_uv;
+	
+	main_PS_Input _tmp_1 = main_vs_main(vs_input);
+	gl_Position = _tmp_1.position;
+	_entry_point_output_normal = _tmp_1.normal;
+	_entry_point_output_uv = _tmp_1.uv;
+}
+
+// pixel entry 'ps_main'
+#version 450
+layout(location = 0) in vec3 ps_input_normal;
+layout(location = 1) in vec2 ps_input_uv;
+
+layout(location = 0) out vec4 _entry_point_output_color;
+
+struct main_PS_Input {
+	vec4 position;
+	vec3 normal;
+	vec2 uv;
+	float fog;
+};
+struct main_PS_Output {
+	vec4 color;
+};
+main_PS_Output main_ps_main(main_PS_Input ps_input) {
+	main_PS_Output o;
+	o.color.rgb = ps_input.normal;
+	o.color.a = ps_input.uv.x;
+	return o;
+}
+
+void main() {
+	main_PS_Input ps_input;
+	ps_input.position = gl_FragCoord;
+	ps_input.normal = ps_input_normal;
+	ps_input.uv = ps_input_uv;
+	
+	main_PS_Output _tmp_1 = main_ps_main(ps_input);
+	_entry_point_output_color = _tmp_1.color;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+// vertex entry 'vs_main'
+struct main_VS_Input {
+	float4 position: TEXCOORD0;
+	float3 normal: TEXCOORD1;
+	float2 uv: TEXCOORD2;
+};
+struct main_PS_Input {
+	float4 position;
+	float3 normal;
+	float2 uv;
+	float fog;
+};
+main_PS_Input main_vs_main(main_VS_Input vs_input) {
+	main_PS_Input o;
+	o.position = vs_input.position;
+	o.normal = vs_input.normal;
+	o.uv = vs_input.uv;
+	return o;
+}
+
+struct main_PS_Input_linked {
+	float4 position: SV_POSITION;
+	float3 normal: TEXCOORD0;
+	float2 uv: TEXCOORD1;
+};
+
+main_PS_Input_linked main(main_VS_Input vs_input)
+{
+	main_PS_Input _tmp_1 = main_vs_main(vs_input);
+	main_PS_Input_linked _tmp_2 = (main_PS_Input_linked)0;
+	_tmp_2.position = _tmp_1.position;
+	_tmp_2.normal = _tmp_1.normal;
+	_tmp_2.uv = _tmp_1.uv;
+	return _tmp_2;
+}
+
+// pixel entry 'ps_main'
+struct main_PS_Input {
+	float4 position;
+	float3 normal;
+	float2 uv;
+	float fog;
+};
+struct main_PS_Output {
+	float4 color: SV_TARGET0;
+};
+main_PS_Output main_ps_main(main_PS_Input ps_input) {
+	main_PS_Output o;
+	o.color.rgb = ps_input.normal;
+	o.color.a = ps_input.uv.x;
+	return o;
+}
+
+struct main_PS_Input_linked {
+	float4 position: SV_POSITION;
+	float3 normal: TEXCOORD0;
+	float2 uv: TEXCOORD1;
+};
+
+main_PS_Output main(main_PS_Input_linked ps_input)
+{
+	main_PS_Input _tmp_1 = (main_PS_Input)0;
+	_tmp_1.position = ps_input.position;
+	_tmp_1.normal = ps_input.normal;
+	_tmp_1.uv = ps_input.uv;
+	return main_ps_main(_tmp_1);
+}
\ No newline at end of file
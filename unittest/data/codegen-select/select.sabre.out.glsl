@@ -0,0 +1,24 @@
+float main_shade(vec3 n, vec3 l, float x, bool backface) {
+	float res = 0.0;
+	res = x > 0.5 ? x * 2.0 : x;
+	float s = 1.0;
+	s = backface ? -1.0 : s;
+	float d = 0.0;
+	[[dont_flatten]]
+	if (x > 0.25) {
+		d = dot(n, l);
+	} else {
+		d = 0.0;
+	}
+	return res * s + d;
+}
+struct main_Point {
+	vec2 p;
+};
+main_Point main_pick(main_Point a, main_Point b, float x) {
+	main_Point res = a;
+	if (x > 0.5) {
+		res = b;
+	}
+	return res;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#version 450
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+struct main_CS_Input {
+	uvec3 id;
+	uint index;
+};
+layout(binding = 0, std430) buffer main_values_block {
+	float main_values[];
+};
+shared float main_tile[64];
+void main_main(main_CS_Input cs_input) {
+	float value = main_values[cs_input.id.x];
+	main_tile[cs_input.index] = value;
+	barrier();
+	main_values[cs_input.id.x] = main_tile[cs_input.index] + main_tile[0];
+}
+
+void main() {
+	main_CS_Input cs_input;
+	cs_input.id = gl_GlobalInvocationID;
+	cs_input.index = gl_LocalInvocationIndex;
+	
+	main_main(cs_input);
+}
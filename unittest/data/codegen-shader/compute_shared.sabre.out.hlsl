@@ -0,0 +1,18 @@
+struct main_CS_Input {
+	uint3 id: SV_DispatchThreadID;
+	uint index: SV_GroupIndex;
+};
+RWStructuredBuffer<float> main_values: register(u0);
+groupshared float main_tile[64];
+void main_main(main_CS_Input cs_input) {
+	float value = main_values[cs_input.id.x];
+	main_tile[cs_input.index] = value;
+	GroupMemoryBarrierWithGroupSync();
+	main_values[cs_input.id.x] = main_tile[cs_input.index] + main_tile[0];
+}
+
+[numthreads(64, 1, 1)]
+void main(main_CS_Input cs_input)
+{
+	main_main(cs_input);
+}
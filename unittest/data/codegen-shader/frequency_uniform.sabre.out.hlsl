@@ -0,0 +1,28 @@
+struct main_VS_Input {
+	float3 position: TEXCOORD0;
+};
+struct main_PS_Input {
+	float4 position: SV_POSITION;
+};
+struct main_Camera {
+	column_major float4x4 viewproj;
+};
+cbuffer main_camera: register(b0) {
+	column_major float4x4 main_camera_viewproj: packoffset(c0);
+};
+struct main_Object {
+	column_major float4x4 model;
+};
+cbuffer main_object: register(b0, space2) {
+	column_major float4x4 main_object_model: packoffset(c0);
+};
+main_PS_Input main_main(main_VS_Input vs_input) {
+	float4 _tmp_1 = float4(vs_input.position, 1.0);
+	main_PS_Input _tmp_2 = {mul(mul(main_camera_viewproj, main_object_model), _tmp_1)};
+	return _tmp_2;
+}
+
+main_PS_Input main(main_VS_Input vs_input)
+{
+	return main_main(vs_input);
+}
@@ -0,0 +1,42 @@
+#version 450
+layout(location = 0) in vec3 vs_input_position;
+
+struct main_VS_Input {
+	vec3 position;
+};
+struct main_PS_Input {
+	vec4 position;
+};
+struct main_Material {
+	float roughness;
+	vec3 albedo;
+	float metallic;
+	vec3 emissive;
+	vec2 uv_scale;
+	vec4 tint;
+	float opacity;
+	vec2 uv_offset;
+};
+layout(binding = 1, std140) uniform main_material {
+	vec4 main_material_tint;
+	vec3 main_material_albedo;
+	float main_material_roughness;
+	vec3 main_material_emissive;
+	float main_material_metallic;
+	vec2 main_material_uv_scale;
+	vec2 main_material_uv_offset;
+	float main_material_opacity;
+};
+main_PS_Input main_main(main_VS_Input vs_input) {
+	vec4 _tmp_1 = vec4(vs_input.position * main_material_albedo, main_material_opacity);
+	main_PS_Input _tmp_2 = main_PS_Input(_tmp_1);
+	return _tmp_2;
+}
+
+void main() {
+	main_VS_Input vs_input;
+	vs_input.position = vs_input_position;
+	
+	main_PS_Input _tmp_3 = main_main(vs_input);
+	gl_Position = _tmp_3.position;
+}
@@ -0,0 +1,36 @@
+struct main_VS_Input {
+	float3 position: TEXCOORD0;
+};
+struct main_PS_Input {
+	float4 position: SV_POSITION;
+};
+struct main_Material {
+	float roughness;
+	float3 albedo;
+	float metallic;
+	float3 emissive;
+	float2 uv_scale;
+	float4 tint;
+	float opacity;
+	float2 uv_offset;
+};
+cbuffer main_material: register(b1) {
+	float4 main_material_tint: packoffset(c0);
+	float3 main_material_albedo: packoffset(c1);
+	float main_material_roughness: packoffset(c1.w);
+	float3 main_material_emissive: packoffset(c2);
+	float main_material_metallic: packoffset(c2.w);
+	float2 main_material_uv_scale: packoffset(c3);
+	float2 main_material_uv_offset: packoffset(c3.z);
+	float main_material_opacity: packoffset(c4);
+};
+main_PS_Input main_main(main_VS_Input vs_input) {
+	float4 _tmp_1 = float4(vs_input.position * main_material_albedo, main_material_opacity);
+	main_PS_Input _tmp_2 = {_tmp_1};
+	return _tmp_2;
+}
+
+main_PS_Input main(main_VS_Input vs_input)
+{
+	return main_main(vs_input);
+}
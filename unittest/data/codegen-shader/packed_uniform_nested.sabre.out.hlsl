@@ -0,0 +1,28 @@
+struct main_VS_Input {
+	float3 position: TEXCOORD0;
+};
+struct main_PS_Input {
+	float4 position: SV_POSITION;
+};
+struct main_Dir_Light {
+	float3 dir;
+	float3 color;
+};
+struct main_Material {
+	main_Dir_Light sun;
+	float exposure;
+};
+cbuffer main_material: register(b1) {
+	main_Dir_Light main_material_sun: packoffset(c0);
+	float main_material_exposure: packoffset(c2);
+};
+main_PS_Input main_main(main_VS_Input vs_input) {
+	float4 _tmp_1 = float4(vs_input.position * main_material_sun.dir, main_material_exposure);
+	main_PS_Input _tmp_2 = {_tmp_1};
+	return _tmp_2;
+}
+
+main_PS_Input main(main_VS_Input vs_input)
+{
+	return main_main(vs_input);
+}
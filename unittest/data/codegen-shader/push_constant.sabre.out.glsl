@@ -0,0 +1,30 @@
+#version 450
+layout(location = 0) in vec3 vs_input_position;
+
+struct main_VS_Input {
+	vec3 position;
+};
+struct main_PS_Input {
+	vec4 position;
+};
+struct main_Draw_Data {
+	mat4 model;
+	vec4 tint;
+};
+layout(push_constant, std140) uniform main_draw_data {
+	mat4 main_draw_data_model;
+	vec4 main_draw_data_tint;
+};
+main_PS_Input main_main(main_VS_Input vs_input) {
+	vec4 _tmp_1 = vec4(vs_input.position, main_draw_data_tint.w);
+	main_PS_Input _tmp_2 = main_PS_Input(main_draw_data_model * _tmp_1);
+	return _tmp_2;
+}
+
+void main() {
+	main_VS_Input vs_input;
+	vs_input.position = vs_input_position;
+	
+	main_PS_Input _tmp_3 = main_main(vs_input);
+	gl_Position = _tmp_3.position;
+}
@@ -0,0 +1,24 @@
+struct main_VS_Input {
+	float3 position: TEXCOORD0;
+};
+struct main_PS_Input {
+	float4 position: SV_POSITION;
+};
+struct main_Draw_Data {
+	column_major float4x4 model;
+	float4 tint;
+};
+cbuffer main_draw_data: register(b0, space3) {
+	column_major float4x4 main_draw_data_model: packoffset(c0);
+	float4 main_draw_data_tint: packoffset(c4);
+};
+main_PS_Input main_main(main_VS_Input vs_input) {
+	float4 _tmp_1 = float4(vs_input.position, main_draw_data_tint.w);
+	main_PS_Input _tmp_2 = {mul(main_draw_data_model, _tmp_1)};
+	return _tmp_2;
+}
+
+main_PS_Input main(main_VS_Input vs_input)
+{
+	return main_main(vs_input);
+}
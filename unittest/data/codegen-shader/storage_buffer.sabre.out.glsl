@@ -0,0 +1,34 @@
+#version 450
+layout(location = 0) in vec3 vs_input_position;
+
+struct main_VS_Input {
+	vec3 position;
+};
+struct main_PS_Input {
+	vec4 position;
+};
+struct main_Instance {
+	mat4 model;
+	vec4 color;
+};
+layout(binding = 0, std430) readonly buffer main_instances_block {
+	main_Instance main_instances[];
+};
+layout(binding = 1, std430) buffer main_visibility_block {
+	float main_visibility[];
+};
+main_PS_Input main_main(main_VS_Input vs_input) {
+	main_Instance item = main_instances[0];
+	main_visibility[0] = item.color.a;
+	vec4 _tmp_1 = vec4(vs_input.position, 1.0);
+	main_PS_Input _tmp_2 = main_PS_Input(item.model * _tmp_1);
+	return _tmp_2;
+}
+
+void main() {
+	main_VS_Input vs_input;
+	vs_input.position = vs_input_position;
+	
+	main_PS_Input _tmp_3 = main_main(vs_input);
+	gl_Position = _tmp_3.position;
+}
@@ -0,0 +1,24 @@
+struct main_VS_Input {
+	float3 position: TEXCOORD0;
+};
+struct main_PS_Input {
+	float4 position: SV_POSITION;
+};
+struct main_Instance {
+	column_major float4x4 model;
+	float4 color;
+};
+StructuredBuffer<main_Instance> main_instances: register(t0);
+RWStructuredBuffer<float> main_visibility: register(u1);
+main_PS_Input main_main(main_VS_Input vs_input) {
+	main_Instance item = main_instances[0];
+	main_visibility[0] = item.color.a;
+	float4 _tmp_3 = float4(vs_input.position, 1.0);
+	main_PS_Input _tmp_4 = {mul(item.model, _tmp_3)};
+	return _tmp_4;
+}
+
+main_PS_Input main(main_VS_Input vs_input)
+{
+	return main_main(vs_input);
+}
@@ -0,0 +1,26 @@
+#version 450
+#extension GL_EXT_control_flow_attributes : enable
+#extension GL_KHR_shader_subgroup_arithmetic : enable
+layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+struct main_CS_Input {
+	uvec3 id;
+};
+layout(binding = 0, std430) buffer main_values_block {
+	float main_values[];
+};
+void main_main(main_CS_Input cs_input) {
+	float total = 0.0;
+	[[dont_unroll]]
+	for (int i = 0; i < 4; ++i) {
+		total += main_values[cs_input.id.x];
+	}
+	main_values[cs_input.id.x] = subgroupAdd(total);
+}
+
+void main() {
+	main_CS_Input cs_input;
+	cs_input.id = gl_GlobalInvocationID;
+	
+	main_main(cs_input);
+}
@@ -0,0 +1,20 @@
+struct main_CS_Input {
+	uint3 id: SV_DispatchThreadID;
+};
+RWStructuredBuffer<float> main_values: register(u0);
+void main_main(main_CS_Input cs_input) {
+	float total = 0.0;
+	{ // for scope
+		[loop]
+		for (int i = 0; i < 4; ++i) {
+			total += main_values[cs_input.id.x];
+		}
+	} // for scope
+	main_values[cs_input.id.x] = WaveActiveSum(total);
+}
+
+[numthreads(64, 1, 1)]
+void main(main_CS_Input cs_input)
+{
+	main_main(cs_input);
+}
@@ -0,0 +1,10 @@
+float main_reduce(float weight) {
+	float total = subgroupAdd(weight);
+	if (subgroupElect()) {
+		return total;
+	}
+	return 0.0;
+}
+uvec4 main_visible_mask(bool visible) {
+	return subgroupBallot(visible);
+}
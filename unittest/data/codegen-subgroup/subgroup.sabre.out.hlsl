@@ -0,0 +1,10 @@
+float main_reduce(float weight) {
+	float total = WaveActiveSum(weight);
+	if (WaveIsFirstLane()) {
+		return total;
+	}
+	return 0.0;
+}
+uint4 main_visible_mask(bool visible) {
+	return WaveActiveBallot(visible);
+}
@@ -0,0 +1,21 @@
+float main_blur(float taps[3], float weights[3], int n) {
+	float res = 0.0;
+	{
+		float w = weights[0];
+		res += taps[2] * w;
+	}
+	{
+		float w = weights[1];
+		res += taps[1] * w;
+	}
+	{
+		float w = weights[2];
+		res += taps[0] * w;
+	}
+	{ // for scope
+		for (int i = 0; i < n; i += 1) {
+			res *= 0.5;
+		}
+	} // for scope
+	return res;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+int main_hints(int n) {
+	int res = 0;
+	[[unroll]]
+	for (int i = 0; i < 4; ++i) {
+		res += i;
+	}
+	[[dont_unroll]]
+	for (int i = 0; i < n; ++i) {
+		[[dont_flatten]]
+		if (i > 2) {
+			res += i;
+		}
+	}
+	[[flatten]]
+	if (res > 10) {
+		res = 10;
+	}
+	return res;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+int main_hints(int n) {
+	int res = 0;
+	{ // for scope
+		[unroll(4)]
+		for (int i = 0; i < 4; ++i) {
+			res += i;
+		}
+	} // for scope
+	{ // for scope
+		[loop]
+		for (int i = 0; i < n; ++i) {
+			[branch]
+			if (i > 2) {
+				res += i;
+			}
+		}
+	} // for scope
+	[flatten]
+	if (res > 10) {
+		res = 10;
+	}
+	return res;
+}
\ No newline at end of file
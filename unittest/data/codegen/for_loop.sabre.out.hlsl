@@ -0,0 +1,29 @@
+int main_loops(int n) {
+	int res = 0;
+	{ // for scope
+		for (int i = 0; i < n; i += 2) {
+			res += i;
+		}
+	} // for scope
+	while (res < 100) {
+		res *= 2;
+	}
+	int j = 0;
+	{ // for scope
+		// for init statement
+		int i = 0;
+		while (i < n) {
+			// for body
+			if (i == 1) {
+				i = i + 1;
+				j = j + 2;
+				continue;
+			}
+			res += j;
+			// for post statement
+			i = i + 1;
+			j = j + 2;
+		}
+	} // for scope
+	return res;
+}
\ No newline at end of file
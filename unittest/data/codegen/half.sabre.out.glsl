@@ -0,0 +1,10 @@
+mediump float main_shade(mediump vec3 n, mediump vec3 l, mediump float k) {
+	mediump float d = dot(normalize(n), l) * 0.5 + 0.5;
+	return mix(k, d, 0.25);
+}
+vec3 main_tint(vec3 color, mediump mat3 m, mediump float k) {
+	mediump vec3 h = vec3(color);
+	mediump vec3 c = m * h;
+	mediump vec3 r = c * k;
+	return vec3(r);
+}
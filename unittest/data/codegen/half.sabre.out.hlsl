@@ -0,0 +1,10 @@
+min16float main_shade(min16float3 n, min16float3 l, min16float k) {
+	min16float d = dot(normalize(n), l) * 0.5 + 0.5;
+	return lerp(k, d, 0.25);
+}
+float3 main_tint(float3 color, column_major min16float3x3 m, min16float k) {
+	min16float3 h = min16float3(color);
+	min16float3 c = mul(m, h);
+	min16float3 r = c * k;
+	return float3(r);
+}
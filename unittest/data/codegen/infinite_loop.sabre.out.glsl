@@ -1,15 +1,7 @@
 void main_foo() {
-	{ // for scope
-		// for init statement
-		int i = 0;
-		while (i < 10) {
-			// for body
-			if (i == 0) {
-				++i;
-				continue;
-			}
-			// for post statement
-			++i;
+	for (int i = 0; i < 10; ++i) {
+		if (i == 0) {
+			continue;
 		}
-	} // for scope
+	}
 }
@@ -0,0 +1,10 @@
+int main_sum_twice(int n) {
+	int res = 0;
+	for (int i = 0; i < n; i += 1) {
+		res += i;
+	}
+	for (int i = 0; i < n; i += 1) {
+		res += i * 2;
+	}
+	return res;
+}
\ No newline at end of file
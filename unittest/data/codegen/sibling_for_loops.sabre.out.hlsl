@@ -0,0 +1,14 @@
+int main_sum_twice(int n) {
+	int res = 0;
+	{ // for scope
+		for (int i = 0; i < n; i += 1) {
+			res += i;
+		}
+	} // for scope
+	{ // for scope
+		for (int i = 0; i < n; i += 1) {
+			res += i * 2;
+		}
+	} // for scope
+	return res;
+}
\ No newline at end of file
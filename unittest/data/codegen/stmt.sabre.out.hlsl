@@ -9,12 +9,8 @@ int main_sum_to_n(bool x) {
 	int n = main_convert_bool_to_int(x);
 	int res = 0;
 	{ // for scope
-		// for init statement
-		int i = 0;
-		while (i < n) {
-			// for body
+		for (int i = 0; i < n; ++i) {
 			if (i % 2 == 0) {
-				++i;
 				continue;
 			} else if (i % 3 == 0) {
 				break;
@@ -22,8 +18,6 @@ int main_sum_to_n(bool x) {
 				discard;
 			}
 			res += i;
-			// for post statement
-			++i;
 		}
 	} // for scope
 	return res;
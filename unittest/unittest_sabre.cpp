@@ -376,6 +376,243 @@ TEST_CASE("[sabre]: hlsl-shader")
 	}
 }
 
+enum GOLDEN_BACKEND
+{
+	GOLDEN_BACKEND_GLSL,
+	GOLDEN_BACKEND_HLSL,
+};
+
+inline static mn::Result<mn::Str, mn::Err>
+golden_gen(const mn::Str& filepath, const mn::Str& fake_path, const char* entry, const char* pixel_entry, const sabre::Unit_Options& options, GOLDEN_BACKEND backend)
+{
+	if (pixel_entry)
+	{
+		if (backend == GOLDEN_BACKEND_GLSL)
+			return sabre::glsl_pipeline_gen_from_file(filepath, fake_path, mn::str_lit(entry), mn::str_lit(pixel_entry), {}, options);
+		else
+			return sabre::hlsl_pipeline_gen_from_file(filepath, fake_path, mn::str_lit(entry), mn::str_lit(pixel_entry), {}, options);
+	}
+
+	if (backend == GOLDEN_BACKEND_GLSL)
+		return sabre::glsl_gen_from_file(filepath, fake_path, mn::str_lit(entry), {}, options);
+	else
+		return sabre::hlsl_gen_from_file(filepath, fake_path, mn::str_lit(entry), {}, options);
+}
+
+// runs every file in the given codegen data directory through the given backend and compares the result
+// against its `.out.glsl`/`.out.hlsl` golden file, entry is empty for library mode, when pixel_entry is given
+// entry is the vertex entry and both of them are linked and generated as a pipeline
+inline static void
+golden_dir_test(const char* dir, const char* entry, const sabre::Unit_Options& options, GOLDEN_BACKEND backend, const char* pixel_entry = nullptr)
+{
+	mn_defer{mn::memory::tmp()->clear_all();};
+
+	const char* ext = backend == GOLDEN_BACKEND_GLSL ? "glsl" : "hlsl";
+	auto base_dir = mn::path_join(mn::str_tmp(), DATA_DIR, dir);
+	auto files = mn::path_entries(base_dir, mn::memory::tmp());
+	for (auto f: files)
+	{
+		if (f.kind != mn::Path_Entry::KIND_FILE || f.name == "." || f.name == "..")
+			continue;
+
+		if (mn::str_find_last(f.name, ".out", f.name.count) != SIZE_MAX)
+			continue;
+
+		auto filepath = mn::path_join(mn::str_tmp(), base_dir, f.name);
+
+		if (mn::path_is_file(mn::str_tmpf("{}.out.{}", filepath, ext)) == false)
+		{
+			mn::log_warning("missing {} output for '{}'", ext, filepath);
+			continue;
+		}
+
+		mn::log_info("testing file: {}...", filepath);
+		auto out_data = backend == GOLDEN_BACKEND_GLSL ? load_out_glsl_data(filepath) : load_out_hlsl_data(filepath);
+		mn::str_replace(out_data, "\r\n", "\n");
+		mn::str_trim(out_data);
+
+		auto [answer, err] = golden_gen(filepath, f.name, entry, pixel_entry, options, backend);
+		CHECK(err == false);
+		mn_defer{mn::str_free(answer);};
+		mn::str_replace(answer, "\r\n", "\n");
+		mn::str_trim(answer);
+
+		auto match = answer == out_data;
+		CHECK(match == true);
+		if (match == false)
+		{
+			mn::print("expected:\n{}\n", out_data);
+			mn::print("answer:\n{}\n", answer);
+		}
+	}
+}
+
+TEST_CASE("[sabre]: glsl-fold")
+{
+	sabre::Unit_Options options{};
+	options.fold_constants = true;
+	golden_dir_test("codegen-fold", "", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-fold")
+{
+	sabre::Unit_Options options{};
+	options.fold_constants = true;
+	golden_dir_test("codegen-fold", "", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-inline")
+{
+	sabre::Unit_Options options{};
+	options.inline_functions = true;
+	golden_dir_test("codegen-inline", "", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-inline")
+{
+	sabre::Unit_Options options{};
+	options.inline_functions = true;
+	golden_dir_test("codegen-inline", "", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-unroll")
+{
+	sabre::Unit_Options options{};
+	options.fold_constants = true;
+	options.unroll_loops = true;
+	golden_dir_test("codegen-unroll", "", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-unroll")
+{
+	sabre::Unit_Options options{};
+	options.fold_constants = true;
+	options.unroll_loops = true;
+	golden_dir_test("codegen-unroll", "", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-fast-math")
+{
+	sabre::Unit_Options options{};
+	options.fast_math = true;
+	golden_dir_test("codegen-fast-math", "", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-fast-math")
+{
+	sabre::Unit_Options options{};
+	options.fast_math = true;
+	golden_dir_test("codegen-fast-math", "", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-dce")
+{
+	sabre::Unit_Options options{};
+	options.eliminate_dead_code = true;
+	golden_dir_test("codegen-dce", "", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-dce")
+{
+	sabre::Unit_Options options{};
+	options.eliminate_dead_code = true;
+	golden_dir_test("codegen-dce", "", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-licm")
+{
+	sabre::Unit_Options options{};
+	options.hoist_loop_invariants = true;
+	golden_dir_test("codegen-licm", "", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-licm")
+{
+	sabre::Unit_Options options{};
+	options.hoist_loop_invariants = true;
+	golden_dir_test("codegen-licm", "", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-cse")
+{
+	sabre::Unit_Options options{};
+	options.eliminate_common_subexpressions = true;
+	golden_dir_test("codegen-cse", "", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-cse")
+{
+	sabre::Unit_Options options{};
+	options.eliminate_common_subexpressions = true;
+	golden_dir_test("codegen-cse", "", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-select")
+{
+	sabre::Unit_Options options{};
+	options.convert_branches_to_selects = true;
+	golden_dir_test("codegen-select", "", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-select")
+{
+	sabre::Unit_Options options{};
+	options.convert_branches_to_selects = true;
+	golden_dir_test("codegen-select", "", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-pack-varyings")
+{
+	sabre::Unit_Options options{};
+	options.pack_varyings = true;
+	golden_dir_test("codegen-pack-varyings", "main", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-pack-varyings")
+{
+	sabre::Unit_Options options{};
+	options.pack_varyings = true;
+	golden_dir_test("codegen-pack-varyings", "main", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-subgroup")
+{
+	sabre::Unit_Options options{};
+	options.enable_subgroups = true;
+	golden_dir_test("codegen-subgroup", "", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-subgroup")
+{
+	sabre::Unit_Options options{};
+	options.enable_subgroups = true;
+	golden_dir_test("codegen-subgroup", "", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-subgroup-shader")
+{
+	sabre::Unit_Options options{};
+	options.enable_subgroups = true;
+	golden_dir_test("codegen-subgroup-shader", "main", options, GOLDEN_BACKEND_GLSL);
+}
+
+TEST_CASE("[sabre]: hlsl-subgroup-shader")
+{
+	sabre::Unit_Options options{};
+	options.enable_subgroups = true;
+	golden_dir_test("codegen-subgroup-shader", "main", options, GOLDEN_BACKEND_HLSL);
+}
+
+TEST_CASE("[sabre]: glsl-pipeline")
+{
+	golden_dir_test("codegen-pipeline", "vs_main", {}, GOLDEN_BACKEND_GLSL, "ps_main");
+}
+
+TEST_CASE("[sabre]: hlsl-pipeline")
+{
+	golden_dir_test("codegen-pipeline", "vs_main", {}, GOLDEN_BACKEND_HLSL, "ps_main");
+}
+
 TEST_CASE("[sabre]: reflect")
 {
 	mn_defer{mn::memory::tmp()->clear_all();};